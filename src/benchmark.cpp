@@ -0,0 +1,790 @@
+/* FCE Ultra - NES/Famicom Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/// \file
+/// \brief Headless speed and regression runs over a corpus of ROMs
+
+#include "types.h"
+#include "fceu.h"
+#include "driver.h"
+#include "cart.h"
+#include "x6502.h"
+#include "ines.h"
+#include "debug.h"
+#include "cheat.h"
+#include "movie.h"
+#include "state.h"
+#include "video.h"
+#include "emufile.h"
+#include "utils/crc32.h"
+#include "boards/emu2413.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <algorithm>
+
+extern BMAPPINGLocal bmap[];
+
+//The synthetic test program.  Every 2KB of PRG holds a copy of it, so it
+//keeps running at $F900 whatever the mapper switches in.  It pokes random
+//values at random addresses from $5000 up forever, mostly mapper registers,
+//with rendering on so CHR and mirroring changes show up in the frame.  NMI
+//scrolls randomly, IRQ does two more pokes.
+#define PROG_ORG      0xF900
+#define PROG_SEEDLO   0x30
+#define PROG_SEEDHI   0x34
+#define PROG_NMI      0xF974
+#define PROG_IRQ      0xF98E
+
+static const uint8 benchProgram[] = {
+	0x78,                   // sei
+	0xD8,                   // cld
+	0xA2, 0xFF,             // ldx #$FF
+	0x9A,                   // txs
+	0xA9, 0x00,             // lda #$00
+	0x8D, 0x00, 0x20,       // sta $2000
+	0x8D, 0x01, 0x20,       // sta $2001
+	// w1:
+	0x2C, 0x02, 0x20,       // bit $2002
+	0x10, 0xFB,             // bpl w1
+	// w2:
+	0x2C, 0x02, 0x20,       // bit $2002
+	0x10, 0xFB,             // bpl w2
+	0xA9, 0x3F,             // lda #$3F
+	0x8D, 0x06, 0x20,       // sta $2006
+	0xA9, 0x00,             // lda #$00
+	0x8D, 0x06, 0x20,       // sta $2006
+	0xA2, 0x00,             // ldx #$00
+	// pal:
+	0x8A,                   // txa
+	0x0A,                   // asl a
+	0x29, 0x3F,             // and #$3F
+	0x8D, 0x07, 0x20,       // sta $2007
+	0xE8,                   // inx
+	0xE0, 0x20,             // cpx #$20
+	0xD0, 0xF4,             // bne pal
+	// seed:
+	0xA9, 0x01,             // lda #seedlo
+	0x85, 0x00,             // sta $00
+	0xA9, 0x00,             // lda #seedhi
+	0x85, 0x01,             // sta $01
+	0xA9, 0x80,             // lda #$80
+	0x8D, 0x00, 0x20,       // sta $2000
+	0xA9, 0x1E,             // lda #$1E
+	0x8D, 0x01, 0x20,       // sta $2001
+	0x58,                   // cli
+	// main:
+	0x20, 0x48, 0xF9,       // jsr poke
+	0x4C, 0x42, 0xF9,       // jmp main
+	// poke:
+	0x20, 0x60, 0xF9,       // jsr rand
+	0xC9, 0x50,             // cmp #$50
+	0xB0, 0x02,             // bcs hi
+	0x09, 0x80,             // ora #$80
+	// hi:
+	0x85, 0x03,             // sta $03
+	0x20, 0x60, 0xF9,       // jsr rand
+	0x85, 0x02,             // sta $02
+	0x20, 0x60, 0xF9,       // jsr rand
+	0xA0, 0x00,             // ldy #$00
+	0x91, 0x02,             // sta ($02),y
+	0x60,                   // rts
+	// rand:
+	0xA2, 0x08,             // ldx #$08
+	// rloop:
+	0x46, 0x01,             // lsr $01
+	0x66, 0x00,             // ror $00
+	0x90, 0x06,             // bcc rskip
+	0xA5, 0x01,             // lda $01
+	0x49, 0xB4,             // eor #$B4
+	0x85, 0x01,             // sta $01
+	// rskip:
+	0xCA,                   // dex
+	0xD0, 0xF1,             // bne rloop
+	0xA5, 0x00,             // lda $00
+	0x60,                   // rts
+	// nmi:
+	0x48,                   // pha
+	0x8A,                   // txa
+	0x48,                   // pha
+	0x98,                   // tya
+	0x48,                   // pha
+	0xAD, 0x02, 0x20,       // lda $2002
+	0x20, 0x60, 0xF9,       // jsr rand
+	0x8D, 0x05, 0x20,       // sta $2005
+	0x20, 0x60, 0xF9,       // jsr rand
+	0x8D, 0x05, 0x20,       // sta $2005
+	// restore:
+	0x68,                   // pla
+	0xA8,                   // tay
+	0x68,                   // pla
+	0xAA,                   // tax
+	0x68,                   // pla
+	0x40,                   // rti
+	// irq:
+	0x48,                   // pha
+	0x8A,                   // txa
+	0x48,                   // pha
+	0x98,                   // tya
+	0x48,                   // pha
+	0x20, 0x48, 0xF9,       // jsr poke
+	0x20, 0x48, 0xF9,       // jsr poke
+	0x4C, 0x88, 0xF9,       // jmp restore
+};
+
+static uint8 benchJoy[4];
+
+//Same button sequence for every game: a new random set every 16 frames,
+//with Start and Select only pressed now and then.
+static uint8 BenchInput(uint32 *seed, int frame)
+{
+	static uint8 buttons;
+
+	if(!(frame & 15)) {
+		*seed = *seed * 1103515245 + 12345;
+		buttons = (*seed >> 16) & 0xFF;
+		if((*seed >> 24) & 3)
+			buttons &= ~0x0C;
+	}
+	return buttons;
+}
+
+static int CountCheat(char *name, uint32 a, uint8 v, int compare, int s, int type, void *data)
+{
+	(*(int *)data)++;
+	return 1;
+}
+
+//Spreads count compare codes over PRG.  Each one compares against and
+//substitutes the same value, so it never changes what is read and the
+//hashes stay comparable with a run without them.  Returns how many were added.
+static int AddBenchmarkCheats(int count)
+{
+	int added = 0;
+
+	for(int i = 0; i < count; i++) {
+		uint32 addr = 0x8000 + (uint32)(((uint64)i * 0x8000) / count);
+
+		if(FCEUI_AddCheat("benchmark", addr, i & 0xFF, i & 0xFF, 1))
+			added++;
+	}
+	return added;
+}
+
+static bool BenchmarkOne(const std::string &path, int frames, int interval, int cheats, BENCHMARKRESULT &r)
+{
+	std::chrono::steady_clock::time_point start;
+	uint8 *gfx;
+	int32 *sound;
+	int32 ssize;
+	uint64 cycles, instructions;
+	uint32 seed = 1;
+	int firstcheat = 0, added = 0, keepcheats = savecheats;
+
+	r.path = path;
+	r.loaded = false;
+	r.frames = 0;
+	r.seconds = 0;
+	r.cycles = r.instructions = 0;
+	r.hashes.clear();
+
+	if(!FCEUI_LoadGame(path.c_str(), 1, true))
+		return false;
+	r.loaded = true;
+
+	memset(benchJoy, 0, sizeof(benchJoy));
+	FCEUI_SetInput(0, SI_GAMEPAD, benchJoy, 0);
+	FCEUI_SetInput(1, SI_GAMEPAD, benchJoy, 0);
+
+	if(cheats > 0) {
+		FCEUI_ListCheats(CountCheat, &firstcheat);
+		added = AddBenchmarkCheats(cheats);
+	}
+
+	cycles = timestampbase;
+	instructions = total_instructions;
+	start = std::chrono::steady_clock::now();
+
+	while(r.frames < frames) {
+		benchJoy[0] = BenchInput(&seed, r.frames);
+		FCEUI_Emulate(&gfx, &sound, &ssize, 0);
+		r.frames++;
+
+		if(interval > 0 && !(r.frames % interval)) {
+			uint32 crc = CalcCRC32(0, RAM, 0x800);
+			if(gfx)
+				crc = CalcCRC32(crc, gfx, 256 * 240);
+			r.hashes.push_back(crc);
+		}
+	}
+
+	r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	r.cycles = timestampbase - cycles;
+	r.instructions = total_instructions - instructions;
+
+	//Take the codes out again so they don't get saved with the game's own.
+	if(cheats > 0) {
+		while(added--)
+			FCEUI_DelCheat(firstcheat);
+		savecheats = keepcheats;
+	}
+
+	FCEUI_CloseGame();
+	return true;
+}
+
+//path itself, or every game the ROM library finds under it if it is a
+//directory.  False if path does not exist.
+static bool ListBenchmarkROMs(const char *path, std::vector<std::string> &roms)
+{
+	std::string root = path;
+	struct stat st;
+
+	if(stat(path, &st))
+		return false;
+
+	if(st.st_mode & S_IFDIR) {
+		//The ROM library scanner finds everything, archive members included.
+		while(root.size() > 1 && (root[root.size() - 1] == '/' || root[root.size() - 1] == '\\'))
+			root.erase(root.size() - 1);
+		if(FCEUI_ScanRomLibrary(root.c_str(), 0, NULL) < 0)
+			return false;
+
+		const std::vector<ROMLIBENTRY> &lib = FCEUI_GetRomLibrary();
+		for(size_t i = 0; i < lib.size(); i++) {
+			const std::string &p = lib[i].path;
+			if(p.size() > root.size() && !p.compare(0, root.size(), root) && (p[root.size()] == '/' || p[root.size()] == '\\'))
+				roms.push_back(p);
+		}
+	} else {
+		roms.push_back(root);
+	}
+	return true;
+}
+
+int FCEUI_Benchmark(const char *path, int frames, int interval, int cheats, std::vector<BENCHMARKRESULT> &results, void (*progress)(const BENCHMARKRESULT &r))
+{
+	std::vector<std::string> roms;
+
+	if(!ListBenchmarkROMs(path, roms))
+		return -1;
+
+	for(size_t i = 0; i < roms.size(); i++) {
+		BENCHMARKRESULT r;
+
+		BenchmarkOne(roms[i], frames, interval, cheats, r);
+		results.push_back(r);
+		if(progress)
+			progress(r);
+	}
+	return (int)roms.size();
+}
+
+#ifdef FCEU_THREADED_CPU
+//The CPU before one instruction.
+struct CORESTEP
+{
+	uint64 cycles;
+	uint64 ram;
+	uint16 pc;
+	uint8 a, x, y, s, p;
+};
+
+static std::vector<CORESTEP> *coreSteps;
+static uint64 coreDigest;
+
+//Taken before every instruction, so it has to be cheap.  A change to any one
+//word always changes it.
+static uint64 HashRAM(void)
+{
+	uint64 h = 0, w;
+
+	for(int i = 0; i < 0x800; i += 8) {
+		memcpy(&w, RAM + i, 8);
+		h = (h ^ w) * 1099511628211ULL;
+	}
+	return h;
+}
+
+static void RecordCoreStep(void)
+{
+	CORESTEP s;
+
+	s.cycles = timestampbase + timestamp;
+	s.ram = HashRAM();
+	s.pc = X.PC;
+	s.a = X.A;
+	s.x = X.X;
+	s.y = X.Y;
+	s.s = X.S;
+	s.p = X.P;
+
+	coreDigest = (coreDigest ^ s.cycles) * 1099511628211ULL;
+	coreDigest = (coreDigest ^ s.ram) * 1099511628211ULL;
+	coreDigest = (coreDigest ^ (s.pc | s.a << 16 | s.x << 24 | (uint64)s.y << 32 | (uint64)s.s << 40 | (uint64)s.p << 48)) * 1099511628211ULL;
+	if(coreSteps)
+		coreSteps->push_back(s);
+}
+
+static bool SameCoreStep(const CORESTEP &a, const CORESTEP &b)
+{
+	return a.cycles == b.cycles && a.ram == b.ram && a.pc == b.pc &&
+		a.a == b.a && a.x == b.x && a.y == b.y && a.s == b.s && a.p == b.p;
+}
+
+static std::string DescribeCoreStep(const std::vector<CORESTEP> &steps, size_t i)
+{
+	char buf[128];
+
+	if(i >= steps.size())
+		return "(frame already over)";
+	const CORESTEP &s = steps[i];
+	snprintf(buf, sizeof(buf), "PC:%04X A:%02X X:%02X Y:%02X S:%02X P:%02X  RAM:%016llX  CYC:%llu",
+		s.pc, s.a, s.x, s.y, s.s, s.p, (unsigned long long)s.ram, (unsigned long long)s.cycles);
+	return buf;
+}
+
+//Plays path from power on for frames frames on one core, with the same input
+//as FCEUI_Benchmark.  For each frame, adds a hash of the CPU before every
+//instruction and at the end, then a CRC of the whole savestate, to digests.
+//The CPU before every instruction of the last frame also goes in lastSteps.
+//
+//Loading a game doesn't reset everything the savestate holds, the new PPU's
+//registers among them, so every run starts by loading start, which the first
+//one saves.  Nor the picture buffers, which aren't all in it.
+static bool RunCore(const std::string &path, bool threaded, int frames, std::vector<uint8> &start, std::vector<uint64> &digests, std::vector<CORESTEP> *lastSteps)
+{
+	std::vector<uint8> state;
+	bool keep = X6502_threaded;
+	uint8 *gfx;
+	int32 *sound;
+	int32 ssize;
+	uint32 seed = 1;
+
+	digests.clear();
+	if(!FCEUI_LoadGame(path.c_str(), 1, true))
+		return false;
+
+	memset(XBuf, 128, 256 * 256);
+	memset(XBackBuf, 128, 256 * 256);
+	if(start.empty()) {
+		EMUFILE_MEMORY ms(&start);
+		FCEUSS_SaveMS(&ms, 0, false);
+	}
+	{
+		EMUFILE_MEMORY ms(&start);
+		FCEUSS_LoadFP(&ms, SSLOADPARAM_NOBACKUP);
+	}
+
+	memset(benchJoy, 0, sizeof(benchJoy));
+	FCEUI_SetInput(0, SI_GAMEPAD, benchJoy, 0);
+	FCEUI_SetInput(1, SI_GAMEPAD, benchJoy, 0);
+	X6502_threaded = threaded;
+
+	for(int frame = 0; frame < frames; frame++) {
+		benchJoy[0] = BenchInput(&seed, frame);
+
+		coreDigest = 0;
+		coreSteps = (frame == frames - 1) ? lastSteps : NULL;
+		X6502_stepHook = RecordCoreStep;
+		FCEUI_Emulate(&gfx, &sound, &ssize, 0);
+		X6502_stepHook = NULL;
+		RecordCoreStep();
+		coreSteps = NULL;
+		digests.push_back(coreDigest);
+
+		state.clear();
+		EMUFILE_MEMORY ms(&state);
+		FCEUSS_SaveMS(&ms, 0, false);
+		digests.push_back(CalcCRC32(0, state.data(), state.size()));
+	}
+
+	X6502_threaded = keep;
+	FCEUI_CloseGame();
+	return true;
+}
+
+//Plays the game on each core in turn and finds the first frame where they
+//part ways.  If the CPU did, plays up to that frame again on both, keeping
+//every instruction of it, to say which one.
+static bool CompareCoresOne(const std::string &path, int frames, std::string &report)
+{
+	std::vector<uint8> start;
+	std::vector<uint64> digests[2];
+	std::vector<CORESTEP> steps[2];
+	char msg[256];
+	size_t d, i, n;
+
+	if(!RunCore(path, false, frames, start, digests[0], NULL) || !RunCore(path, true, frames, start, digests[1], NULL)) {
+		report += path + ": could not be loaded\n";
+		return false;
+	}
+
+	for(d = 0; d < digests[0].size(); d++)
+		if(digests[0][d] != digests[1][d])
+			break;
+	if(d == digests[0].size())
+		return true;
+
+	int frame = (int)(d / 2);
+
+	if(d & 1) {
+		snprintf(msg, sizeof(msg), "%s: frame %d, the CPU agrees but the savestate after the frame differs\n", path.c_str(), frame);
+		report += msg;
+		return false;
+	}
+
+	RunCore(path, false, frame + 1, start, digests[0], &steps[0]);
+	RunCore(path, true, frame + 1, start, digests[1], &steps[1]);
+
+	n = std::min(steps[0].size(), steps[1].size());
+	for(i = 0; i < n; i++)
+		if(!SameCoreStep(steps[0][i], steps[1][i]))
+			break;
+
+	snprintf(msg, sizeof(msg), "%s: frame %d, before instruction %d:\n", path.c_str(), frame, (int)i);
+	report += msg;
+	report += "  switch:   " + DescribeCoreStep(steps[0], i) + "\n";
+	report += "  threaded: " + DescribeCoreStep(steps[1], i) + "\n";
+	return false;
+}
+
+int FCEUI_BenchmarkCompareCores(const char *path, int frames, std::string &report)
+{
+	std::vector<std::string> roms;
+	int differ = 0, rate = FSettings.SndRate;
+
+	if(!ListBenchmarkROMs(path, roms))
+		return -1;
+
+	//Expansion sound keeps its place in the output buffer in the savestate,
+	//and that buffer carries over from one run to the next.
+	FCEUI_Sound(0);
+	for(size_t i = 0; i < roms.size(); i++)
+		if(!CompareCoresOne(roms[i], frames, report))
+			differ++;
+	FCEUI_Sound(rate);
+	return differ;
+}
+#endif
+
+bool FCEUI_BenchmarkMovie(const char *path, const char *fn, int frames, int repeats, double &loadSeconds, double &stateSeconds)
+{
+	extern bool LoadFM2(MovieData& movieData, EMUFILE* fp, int size, bool stopAfterHeader);
+	std::chrono::steady_clock::time_point start;
+	std::vector<uint8> file;
+	uint8 *gfx;
+	int32 *sound;
+	int32 ssize;
+
+	loadSeconds = stateSeconds = 0;
+
+	{
+		EMUFILE_FILE f(fn, "rb");
+		if(!f.is_open())
+			return false;
+		file.resize(f.size());
+		if(file.size())
+			f.fread(&file[0], file.size());
+	}
+
+	//Parsing alone, from memory so the disk isn't timed.
+	start = std::chrono::steady_clock::now();
+	for(int i = 0; i < repeats; i++) {
+		EMUFILE_MEMORY ms(&file);
+		MovieData md;
+		LoadFM2(md, &ms, ms.size(), false);
+	}
+	loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	//Loading a state read-only checks the movie it carries against the one
+	//playing, which is what happens on every loadstate while watching a movie.
+	if(!FCEUI_LoadGame(path, 1, true))
+		return false;
+	if(!FCEUI_LoadMovie(fn, true, 0) || !FCEUMOV_IsPlaying()) {
+		FCEUI_CloseGame();
+		return false;
+	}
+	for(int i = 0; i < frames; i++)
+		FCEUI_Emulate(&gfx, &sound, &ssize, 0);
+
+	EMUFILE_MEMORY state;
+	FCEUSS_SaveMS(&state, 0);
+	start = std::chrono::steady_clock::now();
+	for(int i = 0; i < repeats; i++) {
+		state.fseek(0, SEEK_SET);
+		FCEUSS_LoadFP(&state, SSLOADPARAM_NOBACKUP);
+	}
+	stateSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	FCEUI_StopMovie();
+	FCEUI_CloseGame();
+	return true;
+}
+
+//  FCEUX benchmark 1
+//  frames cycles instructions seconds hash,hash,... path
+bool FCEUI_SaveBenchmarkBaseline(const char *fn, const std::vector<BENCHMARKRESULT> &results)
+{
+	FILE *f = FCEUD_UTF8fopen(fn, "wb");
+
+	if(!f)
+		return false;
+
+	fprintf(f, "FCEUX benchmark 1\n");
+	for(size_t i = 0; i < results.size(); i++) {
+		const BENCHMARKRESULT &r = results[i];
+
+		if(!r.loaded)
+			continue;
+		fprintf(f, "%d\t%llu\t%llu\t%.6f\t", r.frames, (unsigned long long)r.cycles, (unsigned long long)r.instructions, r.seconds);
+		for(size_t j = 0; j < r.hashes.size(); j++)
+			fprintf(f, "%s%08X", j ? "," : "", r.hashes[j]);
+		fprintf(f, "\t%s\n", r.path.c_str());
+	}
+	return fclose(f) == 0;
+}
+
+static bool LoadBaseline(const char *fn, std::map<std::string, BENCHMARKRESULT> &baseline)
+{
+	char line[4096];
+	FILE *f = FCEUD_UTF8fopen(fn, "rb");
+
+	if(!f)
+		return false;
+	if(!fgets(line, sizeof(line), f) || strncmp(line, "FCEUX benchmark 1", 17)) {
+		fclose(f);
+		return false;
+	}
+
+	while(fgets(line, sizeof(line), f)) {
+		BENCHMARKRESULT r;
+		unsigned long long cycles, instructions;
+		char *hashes, *path, *p;
+		int n = 0;
+
+		line[strcspn(line, "\r\n")] = 0;
+		if(sscanf(line, "%d\t%llu\t%llu\t%lf\t%n", &r.frames, &cycles, &instructions, &r.seconds, &n) < 4 || !n)
+			continue;
+		hashes = line + n;
+		if(!(path = strchr(hashes, '\t')))
+			continue;
+		*path++ = 0;
+
+		for(p = strtok(hashes, ","); p; p = strtok(NULL, ","))
+			r.hashes.push_back(strtoul(p, NULL, 16));
+		r.loaded = true;
+		r.cycles = cycles;
+		r.instructions = instructions;
+		r.path = path;
+		baseline[r.path] = r;
+	}
+	fclose(f);
+	return true;
+}
+
+int FCEUI_CompareBenchmarkBaseline(const char *fn, const std::vector<BENCHMARKRESULT> &results, double tolerance, std::string &report)
+{
+	std::map<std::string, BENCHMARKRESULT> baseline;
+	std::map<std::string, BENCHMARKRESULT>::const_iterator it;
+	char msg[256];
+	int failures = 0;
+
+	if(!LoadBaseline(fn, baseline))
+		return -1;
+
+	for(size_t i = 0; i < results.size(); i++) {
+		const BENCHMARKRESULT &r = results[i];
+		bool failed = false;
+
+		if(!r.loaded)
+			continue;
+		if((it = baseline.find(r.path)) == baseline.end()) {
+			report += r.path + ": not in the baseline\n";
+			continue;
+		}
+
+		const BENCHMARKRESULT &b = it->second;
+
+		if(b.frames != r.frames || b.hashes.size() != r.hashes.size()) {
+			snprintf(msg, sizeof(msg), ": ran %d frames, the baseline has %d\n", r.frames, b.frames);
+			report += r.path + msg;
+			continue;
+		}
+
+		for(size_t j = 0; j < r.hashes.size(); j++) {
+			if(r.hashes[j] != b.hashes[j]) {
+				snprintf(msg, sizeof(msg), ": state differs by frame %d\n", (int)((j + 1) * r.frames / r.hashes.size()));
+				report += r.path + msg;
+				failed = true;
+				break;
+			}
+		}
+
+		if(r.seconds > 0 && b.seconds > 0 && r.seconds > b.seconds * (1 + tolerance)) {
+			snprintf(msg, sizeof(msg), ": %.0f fps, %.0f%% slower than the baseline\n", r.frames / r.seconds, (r.seconds / b.seconds - 1) * 100);
+			report += r.path + msg;
+			failed = true;
+		}
+
+		if(failed)
+			failures++;
+	}
+	return failures;
+}
+
+int FCEUI_GenerateBenchmarkROMs(const char *dir)
+{
+	const int prgSize = 256 * 1024, chrSize = 128 * 1024;
+	std::vector<int> mappers;
+	std::vector<uint8> image(16 + prgSize + chrSize);
+	int count = 0;
+
+	for(BMAPPINGLocal *tmp = bmap; tmp->init; tmp++)
+		mappers.push_back(tmp->number);
+	std::sort(mappers.begin(), mappers.end());
+	mappers.erase(std::unique(mappers.begin(), mappers.end()), mappers.end());
+
+	for(size_t i = 0; i < mappers.size(); i++) {
+		int mapper = mappers[i];
+		uint8 *head = &image[0], *prg = head + 16, *chr = prg + prgSize;
+		uint32 seed = 0x9E3779B9 * (mapper + 1);
+		char fn[2048];
+		FILE *f;
+		int x;
+
+		memset(head, 0, 16);
+		memcpy(head, "NES\x1a", 4);
+		head[4] = prgSize >> 14;
+		head[5] = chrSize >> 13;
+		head[6] = ((mapper & 0x0F) << 4) | 1;
+		head[7] = mapper & 0xF0;
+		if(mapper > 255) {
+			head[7] |= 0x08;
+			head[8] = (mapper >> 8) & 0x0F;
+			head[10] = 0x07;
+		}
+
+		memset(prg, 0xFF, 2048);
+		memcpy(prg + (PROG_ORG & 0x7FF), benchProgram, sizeof(benchProgram));
+		prg[(PROG_ORG & 0x7FF) + PROG_SEEDLO] = (mapper & 0xFF) | 1;
+		prg[(PROG_ORG & 0x7FF) + PROG_SEEDHI] = mapper >> 8;
+		prg[0x7FA] = PROG_NMI & 0xFF;
+		prg[0x7FB] = PROG_NMI >> 8;
+		prg[0x7FC] = PROG_ORG & 0xFF;
+		prg[0x7FD] = PROG_ORG >> 8;
+		prg[0x7FE] = PROG_IRQ & 0xFF;
+		prg[0x7FF] = PROG_IRQ >> 8;
+		for(x = 2048; x < prgSize; x += 2048)
+			memcpy(prg + x, prg, 2048);
+
+		for(x = 0; x < chrSize; x++) {
+			seed = seed * 1103515245 + 12345;
+			chr[x] = seed >> 16;
+		}
+
+		snprintf(fn, sizeof(fn), "%s" PSS "mapper%03d.nes", dir, mapper);
+		if(!(f = FCEUD_UTF8fopen(fn, "wb")))
+			return -1;
+		if(fwrite(&image[0], 1, image.size(), f) != image.size()) {
+			fclose(f);
+			return -1;
+		}
+		fclose(f);
+		count++;
+	}
+	return count;
+}
+
+//Each seed drives two VRC7 sound chips through the same random register
+//writes and channel masks, one filled a block at a time with OPLL_fillbuf
+//and the other a sample at a time with OPLL_calc, for the given number of
+//samples.  The outputs and the chip state must match after every block.
+int FCEUI_BenchmarkCheckOPLL(int seeds, int samples, std::string &report)
+{
+	static const uint8 regs[] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+		0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
+		0x20, 0x21, 0x22, 0x23, 0x24, 0x25,
+		0x30, 0x31, 0x32, 0x33, 0x34, 0x35
+	};
+	std::vector<int32> block, single;
+	int failed = 0;
+
+	for(int s = 0; s < seeds; s++) {
+		OPLL *fill = OPLL_new(3579545, 48000), *step = OPLL_new(3579545, 48000);
+		uint32 seed = 0x9E3779B9 * (s + 1);
+		int done = 0, blocks = 0;
+		char line[256];
+
+		OPLL_reset(fill);
+		OPLL_reset(step);
+		while(done < samples) {
+			seed = seed * 1103515245 + 12345;
+			int writes = (seed >> 16) & 3;
+			for(int w = 0; w <= writes; w++) {
+				seed = seed * 1103515245 + 12345;
+				uint8 reg = regs[(seed >> 16) % sizeof(regs)];
+				seed = seed * 1103515245 + 12345;
+				uint8 val = seed >> 16;
+				OPLL_writeReg(fill, reg, val);
+				OPLL_writeReg(step, reg, val);
+			}
+			seed = seed * 1103515245 + 12345;
+			if(!((seed >> 16) & 15)) {
+				OPLL_setMask(fill, (seed >> 20) & 0x3F);
+				OPLL_setMask(step, (seed >> 20) & 0x3F);
+			}
+
+			seed = seed * 1103515245 + 12345;
+			int len = 1 + (seed >> 16) % 1100;
+			if(len > samples - done)
+				len = samples - done;
+			block.assign(len, 0);
+			single.assign(len, 0);
+			OPLL_fillbuf(fill, &block[0], len, 0);
+			for(int x = 0; x < len; x++)
+				single[x] = OPLL_calc(step) + 32768;
+
+			int x = 0;
+			while(x < len && block[x] == single[x])
+				x++;
+			if(x < len) {
+				snprintf(line, sizeof(line), "seed %d: block %d, sample %d: %d, per-sample %d\n", s, blocks, done + x, block[x], single[x]);
+				break;
+			}
+			if(memcmp(fill, step, sizeof(OPLL))) {
+				snprintf(line, sizeof(line), "seed %d: block %d: chip state differs after sample %d\n", s, blocks, done + len);
+				break;
+			}
+			done += len;
+			blocks++;
+		}
+		if(done < samples) {
+			report += line;
+			failed++;
+		}
+		OPLL_delete(fill);
+		OPLL_delete(step);
+	}
+	return failed;
+}
@@ -74,6 +74,13 @@ static DECLFW(M69Write0) {
 	cmdreg = V & 0xF;
 }
 
+static void M69IRQSchedule(void) {
+	if (IRQa)
+		X6502_MapIRQSchedule(IRQCount);
+	else
+		X6502_MapIRQSchedule(X6502_MAPIRQ_MAXDELAY);
+}
+
 static DECLFW(M69Write1) {
 	switch (cmdreg) {
 	case 0x0: creg[0] = V; Sync(); break;
@@ -89,9 +96,9 @@ static DECLFW(M69Write1) {
 	case 0xA: preg[1] = V; Sync(); break;
 	case 0xB: preg[2] = V; Sync(); break;
 	case 0xC: mirr = V & 3; Sync();break;
-	case 0xD: IRQa = V; X6502_IRQEnd(FCEU_IQEXT); break;
-	case 0xE: IRQCount &= 0xFF00; IRQCount |= V; break;
-	case 0xF: IRQCount &= 0x00FF; IRQCount |= V << 8; break;
+	case 0xD: X6502_MapIRQSync(); IRQa = V; X6502_IRQEnd(FCEU_IQEXT); M69IRQSchedule(); break;
+	case 0xE: X6502_MapIRQSync(); IRQCount &= 0xFF00; IRQCount |= V; M69IRQSchedule(); break;
+	case 0xF: X6502_MapIRQSync(); IRQCount &= 0x00FF; IRQCount |= V << 8; M69IRQSchedule(); break;
 	}
 }
 
@@ -211,6 +218,7 @@ static void AYHiSync(int32 ts) {
 
 void Mapper69_ESI(void) {
 	GameExpSound.RChange = Mapper69_ESI;
+	GameExpSound.Name = "Sunsoft 5B";
 	GameExpSound.HiSync = AYHiSync;
 	memset(dcount, 0, sizeof(dcount));
 	memset(vcount, 0, sizeof(vcount));
@@ -248,6 +256,7 @@ static void M69IRQHook(int a) {
 			X6502_IRQBegin(FCEU_IQEXT); IRQa = 0; IRQCount = 0xFFFF;
 		}
 	}
+	M69IRQSchedule();
 }
 
 static void StateRestore(int version) {
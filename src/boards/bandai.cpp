@@ -262,6 +262,13 @@ static void Sync(void) {
 	SyncMirror();
 }
 
+static void BandaiIRQSchedule(void) {
+	if (IRQa)
+		X6502_MapIRQSchedule(IRQCount + 1);
+	else
+		X6502_MapIRQSchedule(X6502_MAPIRQ_MAXDELAY);
+}
+
 static DECLFW(BandaiWrite) {
 	A &= 0x0F;
 	if (A < 0x0A) {
@@ -269,7 +276,7 @@ static DECLFW(BandaiWrite) {
 		Sync();
 	} else
 		switch (A) {
-		case 0x0A: X6502_IRQEnd(FCEU_IQEXT); IRQa = V & 1; IRQCount = IRQLatch; break;
+		case 0x0A: X6502_MapIRQSync(); X6502_IRQEnd(FCEU_IQEXT); IRQa = V & 1; IRQCount = IRQLatch; BandaiIRQSchedule(); break;
 		case 0x0B: IRQLatch &= 0xFF00; IRQLatch |= V; break;
 		case 0x0C: IRQLatch &= 0xFF; IRQLatch |= V << 8; break;
 		case 0x0D: if(x24c02) x24c02_write(V); else x24c01_write(V); break;
@@ -292,6 +299,7 @@ static void BandaiIRQHook(int a) {
 			IRQCount = -1;
 		}
 	}
+	BandaiIRQSchedule();
 }
 
 static void BandaiPower(void) {
@@ -530,9 +538,11 @@ int FCEUI_DatachSet(uint8 *rcode) {
 
 	#undef BS
 
+	X6502_MapIRQSync();
 	BarcodeReadPos = 0;
 	BarcodeOut = 0x8;
 	BarcodeCycleCount = 0;
+	X6502_MapIRQSchedule(0);
 	return(1);
 }
 
@@ -543,13 +553,20 @@ static void BarcodeSync(void) {
 	SyncMirror();
 }
 
+static void BarcodeIRQSchedule(void) {
+	int32 cycles = 1000 - BarcodeCycleCount;
+	if (IRQa && IRQCount + 1 < cycles)
+		cycles = IRQCount + 1;
+	X6502_MapIRQSchedule(cycles);
+}
+
 static DECLFW(BarcodeWrite) {
 	A &= 0x0F;
 	switch (A) {
 	case 0x00: reg[0] = (V & 8) << 2; x24c01_write(reg[0xD] | reg[0]); break;		// extra EEPROM x24C01 used in Battle Rush mini-cart
 	case 0x08: 
 	case 0x09: reg[A] = V; BarcodeSync(); break;
-	case 0x0A: X6502_IRQEnd(FCEU_IQEXT); IRQa = V & 1; IRQCount = IRQLatch; break;
+	case 0x0A: X6502_MapIRQSync(); X6502_IRQEnd(FCEU_IQEXT); IRQa = V & 1; IRQCount = IRQLatch; BarcodeIRQSchedule(); break;
 	case 0x0B: IRQLatch &= 0xFF00; IRQLatch |= V; break;
 	case 0x0C: IRQLatch &= 0xFF; IRQLatch |= V << 8; break;
 	case 0x0D: reg[0xD] = V & (~0x20); x24c01_write(reg[0xD] | reg[0]);  x24c02_write(V); break;
@@ -570,6 +587,7 @@ static void BarcodeIRQHook(int a) {
 			BarcodeReadPos++;
 		}
 	}
+	BarcodeIRQSchedule();
 }
 
 static DECLFR(BarcodeRead) {
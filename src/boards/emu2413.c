@@ -692,7 +692,7 @@ INLINE static void calc_phase(OPLL_SLOT * slot, int32 lfo) {
 }
 
 /* EG */
-static void calc_envelope(OPLL_SLOT * slot, int32 lfo) {
+INLINE static void calc_envelope(OPLL_SLOT * slot, int32 lfo) {
 #define S2E(x) (SL2EG((int32)(x / SL_STEP)) << (EG_DP_BITS - EG_BITS))
 
 	static uint32 SL[16] = {
@@ -820,11 +820,96 @@ static INLINE int16 calc(OPLL * opll) {
 	return (int16)out;
 }
 
+/* Envelope states that can only be left through a register write. While a
+   slot is in one of these its egout depends on nothing but the total level
+   and, if AM is set, the amplitude LFO. */
+INLINE static int32 eg_is_static(OPLL_SLOT * slot) {
+	switch (slot->eg_mode) {
+	case ATTACK:
+	case DECAY:
+	case SUSTINE:
+	case RELEASE:
+		return 0;
+	case SUSHOLD:
+		return slot->patch.EG != 0;
+	default:
+		return 1;
+	}
+}
+
+/* Block synthesis.
+ *
+ * Registers can not change in the middle of a fill, so the phase and envelope
+ * increments computed at register write time are constant for the whole block.
+ * The phase generators of all 12 slots are kept in lane arrays for the block so
+ * that their per sample update is a straight line loop the compiler can
+ * vectorize, and envelopes that can not change state are evaluated once rather
+ * than per sample. The result is bit identical to calling calc() per sample.
+ */
 void OPLL_fillbuf(OPLL* opll, int32 *buf, int32 len, int shift) {
-	while (len > 0) {
-		*buf += (calc(opll) + 32768) << shift;
+	uint32 phase[12], dphase[12], pmmask[12];
+	OPLL_SLOT *egslot[12];
+	uint8 stepped[12];
+	int32 i, inst, numeg = 0;
+	uint32 lfo;
+
+	if (len <= 0)
+		return;
+
+	update_ampm(opll);
+
+	for (i = 0; i < 12; i++) {
+		OPLL_SLOT *slot = &opll->slot[i];
+
+		phase[i] = slot->phase;
+		dphase[i] = slot->dphase;
+		pmmask[i] = slot->patch.PM ? ~0u : 0;
+
+		stepped[i] = !eg_is_static(slot) || (slot->patch.AM && (opll->slot[i | 1].eg_mode != FINISH));
+		if (stepped[i])
+			egslot[numeg++] = slot;
+		else
+			calc_envelope(slot, opll->lfo_am);
+	}
+
+	for (;;) {
+		lfo = (uint32)opll->lfo_pm;
+
+		/* PG, all slots at once */
+		for (i = 0; i < 12; i++) {
+			uint32 inc = (((dphase[i] * lfo) >> PM_AMP_BITS) & pmmask[i]) | (dphase[i] & ~pmmask[i]);
+			phase[i] = (phase[i] + inc) & (DP_WIDTH - 1);
+		}
+		for (i = 0; i < 12; i++)
+			opll->slot[i].pgout = HIGHBITS(phase[i], DP_BASE_BITS);
+
+		/* EG */
+		for (i = 0; i < numeg; i++)
+			calc_envelope(egslot[i], opll->lfo_am);
+
+		inst = 0;
+		for (i = 0; i < 6; i++)
+			if (!(opll->mask & OPLL_MASK_CH(i)) && (CAR(opll, i)->eg_mode != FINISH))
+				inst += calc_slot_car(CAR(opll, i), calc_slot_mod(MOD(opll, i)));
+
+		*buf += ((int16)inst + 32768) << shift;
 		buf++;
-		len--;
+
+		if (--len <= 0)
+			break;
+
+		update_ampm(opll);
+	}
+
+	/* Bring the envelopes that were only evaluated once up to date with the
+	   final LFO value, so the saved state matches what per sample stepping
+	   would have produced. The stepped ones already are, and evaluating them
+	   again would be wrong for one that just went from DECAY to SUSHOLD. */
+	for (i = 0; i < 12; i++) {
+		opll->slot[i].phase = phase[i];
+
+		if (!stepped[i] && opll->slot[i].patch.AM)
+			calc_envelope(&opll->slot[i], opll->lfo_am);
 	}
 }
 
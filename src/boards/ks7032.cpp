@@ -41,16 +41,23 @@ static void Sync(void) {
 	setchr8(0);
 }
 
+static void UNLKS7032IRQSchedule(void) {
+	if (IRQa)
+		X6502_MapIRQSchedule(0xFFFF - IRQCount);
+	else
+		X6502_MapIRQSchedule(X6502_MAPIRQ_MAXDELAY);
+}
+
 static DECLFW(UNLKS7032Write) {
 //	FCEU_printf("bs %04x %02x\n",A,V);
 	switch (A & 0xF000) {
 //	case 0x8FFF: reg[4]=V; Sync(); break;
-	case 0x8000: X6502_IRQEnd(FCEU_IQEXT); IRQCount = (IRQCount & 0x000F) | (V & 0x0F); isirqused = 1; break;
-	case 0x9000: X6502_IRQEnd(FCEU_IQEXT); IRQCount = (IRQCount & 0x00F0) | ((V & 0x0F) << 4); isirqused = 1; break;
-	case 0xA000: X6502_IRQEnd(FCEU_IQEXT); IRQCount = (IRQCount & 0x0F00) | ((V & 0x0F) << 8); isirqused = 1; break;
-	case 0xB000: X6502_IRQEnd(FCEU_IQEXT); IRQCount = (IRQCount & 0xF000) | (V << 12); isirqused = 1; break;
+	case 0x8000: X6502_MapIRQSync(); X6502_IRQEnd(FCEU_IQEXT); IRQCount = (IRQCount & 0x000F) | (V & 0x0F); isirqused = 1; UNLKS7032IRQSchedule(); break;
+	case 0x9000: X6502_MapIRQSync(); X6502_IRQEnd(FCEU_IQEXT); IRQCount = (IRQCount & 0x00F0) | ((V & 0x0F) << 4); isirqused = 1; UNLKS7032IRQSchedule(); break;
+	case 0xA000: X6502_MapIRQSync(); X6502_IRQEnd(FCEU_IQEXT); IRQCount = (IRQCount & 0x0F00) | ((V & 0x0F) << 8); isirqused = 1; UNLKS7032IRQSchedule(); break;
+	case 0xB000: X6502_MapIRQSync(); X6502_IRQEnd(FCEU_IQEXT); IRQCount = (IRQCount & 0xF000) | (V << 12); isirqused = 1; UNLKS7032IRQSchedule(); break;
 	case 0xC000: if (isirqused) {
-			X6502_IRQEnd(FCEU_IQEXT); IRQa = 1;
+			X6502_MapIRQSync(); X6502_IRQEnd(FCEU_IQEXT); IRQa = 1; UNLKS7032IRQSchedule();
 	}
 		break;
 	case 0xE000: cmd = V & 7; break;
@@ -67,6 +74,7 @@ static void UNLSMB2JIRQHook(int a) {
 			X6502_IRQBegin(FCEU_IQEXT);
 		}
 	}
+	UNLKS7032IRQSchedule();
 }
 
 static void UNLKS7032Power(void) {
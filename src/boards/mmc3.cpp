@@ -59,6 +59,14 @@ static SFORMAT MMC3_StateRegs[] =
 
 static int isRevB = 1;
 
+/* A12 rises the PPU has reported but the CPU hasn't reached yet, in cycles
+   from the last run of MMC3_IRQHook.  Some carts need an extra clock on one
+   line, for reasons nobody has pinned down. */
+static int32 A12Rise[16];
+static uint8 A12Clocks[16];
+static int A12Rises;
+static int A12HackLine = -1;
+
 void (*pwrap)(uint32 A, uint8 V);
 void (*cwrap)(uint32 A, uint8 V);
 void (*mwrap)(uint8 V);
@@ -88,6 +96,7 @@ void FixMMC3PRG(int V) {
 void FixMMC3CHR(int V) {
 	int cbase = (V & 0x80) << 5;
 
+	BeginBankUpdate();
 	cwrap((cbase ^ 0x000), DRegBuf[0] & (~1));
 	cwrap((cbase ^ 0x400), DRegBuf[0] | 1);
 	cwrap((cbase ^ 0x800), DRegBuf[1] & (~1));
@@ -99,10 +108,12 @@ void FixMMC3CHR(int V) {
 	cwrap(cbase ^ 0x1c00, DRegBuf[5]);
 
 	if (mwrap) mwrap(A000B);
+	EndBankUpdate();
 }
 
 void MMC3RegReset(void) {
 	IRQCount = IRQLatch = IRQa = MMC3_cmd = 0;
+	A12Rises = 0;
 
 	DRegBuf[0] = 0;
 	DRegBuf[1] = 2;
@@ -136,12 +147,16 @@ DECLFW(MMC3_CMDWrite) {
 		DRegBuf[MMC3_cmd & 0x7] = V;
 		switch (MMC3_cmd & 0x07) {
 		case 0:
+			BeginBankUpdate();
 			cwrap((cbase ^ 0x000), V & (~1));
 			cwrap((cbase ^ 0x400), V | 1);
+			EndBankUpdate();
 			break;
 		case 1:
+			BeginBankUpdate();
 			cwrap((cbase ^ 0x800), V & (~1));
 			cwrap((cbase ^ 0xC00), V | 1);
+			EndBankUpdate();
 			break;
 		case 2:
 			cwrap(cbase ^ 0x1000, V);
@@ -178,6 +193,7 @@ DECLFW(MMC3_CMDWrite) {
 
 DECLFW(MMC3_IRQWrite) {
 //	FCEU_printf("%04x:%04x\n",A,V);
+	X6502_MapIRQSync();
 	switch (A & 0xE001) {
 	case 0xC000: IRQLatch = V; break;
 	case 0xC001: IRQReload = 1; break;
@@ -218,33 +234,54 @@ static void ClockMMC3Counter(void) {
 	}
 }
 
-static void MMC3_hb(void) {
-	ClockMMC3Counter();
-}
-
-static void MMC3_hb_KickMasterHack(void) {
-	if (scanline == 238) ClockMMC3Counter();
-	ClockMMC3Counter();
-}
+static void MMC3_IRQHook(int a) {
+	int n, left = 0;
+	int32 next = X6502_MAPIRQ_MAXDELAY;
 
-static void MMC3_hb_PALStarWarsHack(void) {
-	if (scanline == 240) ClockMMC3Counter();
-	ClockMMC3Counter();
+	for (n = 0; n < A12Rises; n++) {
+		A12Rise[n] -= a;
+		if (A12Rise[n] <= 0) {
+			while (A12Clocks[n]--)
+				ClockMMC3Counter();
+		} else {
+			if (A12Rise[n] < next)
+				next = A12Rise[n];
+			A12Rise[left] = A12Rise[n];
+			A12Clocks[left++] = A12Clocks[n];
+		}
+	}
+	A12Rises = left;
+	X6502_MapIRQSchedule(next);
+}
+
+static void MMC3_A12(int32 dots) {
+	X6502_MapIRQSync();
+	if (A12Rises == 16) {	/* the CPU is stuck, keep the oldest rises going */
+		while (A12Clocks[0]--)
+			ClockMMC3Counter();
+		memmove(A12Rise, A12Rise + 1, 15 * sizeof(A12Rise[0]));
+		memmove(A12Clocks, A12Clocks + 1, 15);
+		A12Rises--;
+	}
+	A12Rise[A12Rises] = X6502_DotCycles(dots);
+	A12Clocks[A12Rises++] = (scanline == A12HackLine) ? 2 : 1;
+	MMC3_IRQHook(0);
 }
 
 void GenMMC3Restore(int version) {
+	A12Rises = 0;
 	FixMMC3PRG(MMC3_cmd);
 	FixMMC3CHR(MMC3_cmd);
 }
 
 static void GENCWRAP(uint32 A, uint8 V) {
-	setchr1(A, V);			// Business Wars NEEDS THIS for 8K CHR-RAM
+	setchrbank<0x400>(0, A, V);			// Business Wars NEEDS THIS for 8K CHR-RAM
 }
 
 static void GENPWRAP(uint32 A, uint8 V) {
 // [NJ102] Mo Dao Jie (C) has 1024Mb MMC3 BOARD, maybe something other will be broken
 // also HengGe BBC-2x boards enables this mode as default board mode at boot up
-	setprg8(A, (V & 0x7F) | ((kt_extra & 4) << 4));
+	setprgbank<0x2000>(0, A, (V & 0x7F) | ((kt_extra & 4) << 4));
 // KT-008 boards hack 2-in-1, TODO assign to new ines mapper, most dump of KT-boards on the net are mapper 4, so need database or goodnes fix support
 }
 
@@ -310,6 +347,7 @@ void GenMMC3_Init(CartInfo *info, int prg, int chr, int wram, int battery) {
 	mwrap = GENMWRAP;
 
 	WRAMSIZE = wram << 10;
+	mmc3opts = 0;
 
 	PRGmask8[0] &= (prg >> 13) - 1;
 	CHRmask1[0] &= (chr >> 10) - 1;
@@ -337,13 +375,15 @@ void GenMMC3_Init(CartInfo *info, int prg, int chr, int wram, int battery) {
 	info->Close = GenMMC3Close;
 
 	if (info->CRC32 == 0x5104833e)		// Kick Master
-		GameHBIRQHook = MMC3_hb_KickMasterHack;
+		A12HackLine = 238;
 	else if (info->CRC32 == 0x5a6860f1 || info->CRC32 == 0xae280e20)// Shougi Meikan '92/'93
-		GameHBIRQHook = MMC3_hb_KickMasterHack;
+		A12HackLine = 238;
 	else if (info->CRC32 == 0xfcd772eb)	// PAL Star Wars, similar problem as Kick Master.
-		GameHBIRQHook = MMC3_hb_PALStarWarsHack;
+		A12HackLine = 240;
 	else
-		GameHBIRQHook = MMC3_hb;
+		A12HackLine = -1;
+	PPU_A12Hook = MMC3_A12;
+	MapIRQHook = MMC3_IRQHook;
 	GameStateRestore = GenMMC3Restore;
 }
 
@@ -524,7 +564,8 @@ static void M45PW(uint32 A, uint8 V) {
 
 static DECLFW(M45Write) {
 	if (EXPREGS[3] & 0x40) {
-		WRAM[A - 0x6000] = V;
+		if (A >= 0x6000)
+			WRAM[A - 0x6000] = V;
 		return;
 	}
 	EXPREGS[EXPREGS[4]] = V;
@@ -743,10 +784,10 @@ static DECLFW(M114Write) {
 	case 0x8001: MMC3_CMDWrite(0xA000, V); break;
 	case 0xA000: MMC3_CMDWrite(0x8000, (V & 0xC0) | (m114_perm[V & 7])); cmdin = 1; break;
 	case 0xC000: if (!cmdin) break; MMC3_CMDWrite(0x8001, V); cmdin = 0; break;
-	case 0xA001: IRQLatch = V; break;
-	case 0xC001: IRQReload = 1; break;
-	case 0xE000: X6502_IRQEnd(FCEU_IQEXT); IRQa = 0; break;
-	case 0xE001: IRQa = 1; break;
+	case 0xA001: X6502_MapIRQSync(); IRQLatch = V; break;
+	case 0xC001: X6502_MapIRQSync(); IRQReload = 1; break;
+	case 0xE000: X6502_MapIRQSync(); X6502_IRQEnd(FCEU_IQEXT); IRQa = 0; break;
+	case 0xE001: X6502_MapIRQSync(); IRQa = 1; break;
 	}
 }
 
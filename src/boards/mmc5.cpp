@@ -348,6 +348,7 @@ static void BuildWRAMSizeTable(void) {
 
 static void MMC5CHRA(void) {
 	int x;
+	BeginBankUpdate();
 	switch (mmc5vsize & 3) {
 	case 0:
 		setchr8(CHRBanksA[7]);
@@ -376,10 +377,12 @@ static void MMC5CHRA(void) {
 	}
 		break;
 	}
+	EndBankUpdate();
 }
 
 static void MMC5CHRB(void) {
 	int x;
+	BeginBankUpdate();
 	switch (mmc5vsize & 3) {
 	case 0:
 		setchr8(CHRBanksB[3]);
@@ -408,6 +411,7 @@ static void MMC5CHRB(void) {
 	}
 		break;
 	}
+	EndBankUpdate();
 }
 
 static void MMC5WRAM(uint32 A, uint32 V) {
@@ -861,6 +865,7 @@ void MMC5RunSound(int Count) {
 
 void Mapper5_ESI(void) {
 	GameExpSound.RChange = Mapper5_ESI;
+	GameExpSound.Name = "MMC5";
 	if (FSettings.SndRate) {
 		if (FSettings.soundq >= 1) {
 			sfun = Do5SQHQ;
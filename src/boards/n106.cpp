@@ -366,6 +366,7 @@ static void M19SC(void) {
 
 void Mapper19_ESI(void) {
 	GameExpSound.RChange = M19SC;
+	GameExpSound.Name = "N163";
 	memset(vcount, 0, sizeof(vcount));
 	memset(PlayIndex, 0, sizeof(PlayIndex));
 	CVBC = 0;
@@ -418,6 +419,7 @@ void Mapper19_Init(CartInfo *info) {
 	MapIRQHook = NamcoIRQHook;
 	GameStateRestore = Mapper19_StateRestore;
 	GameExpSound.RChange = M19SC;
+	GameExpSound.Name = "N163";
 
 	if (FSettings.SndRate)
 		Mapper19_ESI();
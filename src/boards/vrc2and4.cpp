@@ -73,6 +73,15 @@ static void Sync(void) {
 	}
 }
 
+#define LCYCS 341
+
+static void VRC24IRQSchedule(void) {
+	if (IRQa)
+		X6502_MapIRQSchedule(((0x100 - IRQCount) * LCYCS - acount + 2) / 3);
+	else
+		X6502_MapIRQSchedule(X6502_MAPIRQ_MAXDELAY);
+}
+
 static DECLFW(VRC24Write) {
 	A = A & 0xF000 | !!(A & reg2mask) << 1 | !!(A & reg1mask);
 	if ((A >= 0xB000) && (A <= 0xE003)) {
@@ -115,8 +124,16 @@ static DECLFW(VRC24Write) {
 		case 0x9003: regcmd = V; Sync(); break;
 		case 0xF000: X6502_IRQEnd(FCEU_IQEXT); IRQLatch &= 0xF0; IRQLatch |= V & 0xF; break;
 		case 0xF001: X6502_IRQEnd(FCEU_IQEXT); IRQLatch &= 0x0F; IRQLatch |= V << 4; break;
-		case 0xF002: X6502_IRQEnd(FCEU_IQEXT); acount = 0; IRQCount = IRQLatch; IRQa = V & 2; irqcmd = V & 1; break;
-		case 0xF003: X6502_IRQEnd(FCEU_IQEXT); IRQa = irqcmd; break;
+		case 0xF002:
+			X6502_MapIRQSync();
+			X6502_IRQEnd(FCEU_IQEXT); acount = 0; IRQCount = IRQLatch; IRQa = V & 2; irqcmd = V & 1;
+			VRC24IRQSchedule();
+			break;
+		case 0xF003:
+			X6502_MapIRQSync();
+			X6502_IRQEnd(FCEU_IQEXT); IRQa = irqcmd;
+			VRC24IRQSchedule();
+			break;
 		}
 }
 
@@ -134,7 +151,6 @@ static void VRC24Power(void) {
 }
 
 void VRC24IRQHook(int a) {
-	#define LCYCS 341
 	if (IRQa) {
 		acount += a * 3;
 		if (acount >= LCYCS) {
@@ -148,6 +164,7 @@ void VRC24IRQHook(int a) {
 			}
 		}
 	}
+	VRC24IRQSchedule();
 }
 
 static void StateRestore(int version) {
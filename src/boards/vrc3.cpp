@@ -49,6 +49,15 @@ static void Sync(void) {
 	setchr8(0);
 }
 
+static void M73IRQSchedule(void) {
+	if (!IRQa)
+		X6502_MapIRQSchedule(X6502_MAPIRQ_MAXDELAY);
+	else if (IRQm)
+		X6502_MapIRQSchedule(0x100 - (IRQCount & 0xFF));
+	else
+		X6502_MapIRQSchedule(0x10000 - IRQCount);
+}
+
 static DECLFW(M73Write) {
 	switch (A & 0xF000) {
 	case 0x8000: IRQReload &= 0xFFF0; IRQReload |= (V & 0xF) << 0;  break;
@@ -56,6 +65,7 @@ static DECLFW(M73Write) {
 	case 0xA000: IRQReload &= 0xF0FF; IRQReload |= (V & 0xF) << 8;  break;
 	case 0xB000: IRQReload &= 0x0FFF; IRQReload |= (V & 0xF) << 12; break;
 	case 0xC000:
+		X6502_MapIRQSync();
 		IRQm = V & 4;
 		IRQx = V & 1;
 		IRQa = V & 2;
@@ -67,37 +77,45 @@ static DECLFW(M73Write) {
 				IRQCount = IRQReload;
 		}
 		X6502_IRQEnd(FCEU_IQEXT);
+		M73IRQSchedule();
+		break;
+	case 0xD000:
+		X6502_MapIRQSync();
+		X6502_IRQEnd(FCEU_IQEXT);
+		IRQa = IRQx;
+		M73IRQSchedule();
 		break;
-	case 0xD000: X6502_IRQEnd(FCEU_IQEXT); IRQa = IRQx; break;
 	case 0xF000: preg = V; Sync(); break;
 	}
 }
 
 static void M73IRQHook(int a) {
 	int32 i;
-	if (!IRQa) return;
-	for (i = 0; i < a; i++) {
-		if (IRQm) {
-			uint16 temp = IRQCount;
-			temp &= 0xFF;
-			IRQCount &= 0xFF00;
-			if (temp == 0xFF) {
-				IRQCount = IRQReload;
-				IRQCount |= (uint16)(IRQReload & 0xFF);
-				X6502_IRQBegin(FCEU_IQEXT);
+	if (IRQa) {
+		for (i = 0; i < a; i++) {
+			if (IRQm) {
+				uint16 temp = IRQCount;
+				temp &= 0xFF;
+				IRQCount &= 0xFF00;
+				if (temp == 0xFF) {
+					IRQCount = IRQReload;
+					IRQCount |= (uint16)(IRQReload & 0xFF);
+					X6502_IRQBegin(FCEU_IQEXT);
+				} else {
+					temp++;
+					IRQCount |= temp;
+				}
 			} else {
-				temp++;
-				IRQCount |= temp;
+				//16 bit mode
+				if (IRQCount == 0xFFFF) {
+					IRQCount = IRQReload;
+					X6502_IRQBegin(FCEU_IQEXT);
+				} else
+					IRQCount++;
 			}
-		} else {
-			//16 bit mode
-			if (IRQCount == 0xFFFF) {
-				IRQCount = IRQReload;
-				X6502_IRQBegin(FCEU_IQEXT);
-			} else
-				IRQCount++;
 		}
 	}
+	M73IRQSchedule();
 }
 
 static void M73Power(void) {
@@ -88,6 +88,13 @@ static DECLFW(VRC6SW) {
 	}
 }
 
+static void VRC6IRQSchedule(void) {
+	if (IRQa)
+		X6502_MapIRQSchedule(((0x100 - IRQCount) * 341 - CycleCount + 2) / 3);
+	else
+		X6502_MapIRQSchedule(X6502_MAPIRQ_MAXDELAY);
+}
+
 static DECLFW(VRC6Write) {
 	if (is26)
 		A = (A & 0xFFFC) | ((A >> 1) & 1) | ((A << 1) & 2);
@@ -109,16 +116,20 @@ static DECLFW(VRC6Write) {
 	case 0xE003: chr[7] = V; Sync(); break;
 	case 0xF000: IRQLatch = V; X6502_IRQEnd(FCEU_IQEXT); break;
 	case 0xF001:
+		X6502_MapIRQSync();
 		IRQa = V & 2;
 		IRQd = V & 1;
 		if (V & 2)
 			IRQCount = IRQLatch;
 		CycleCount = 0;
 		X6502_IRQEnd(FCEU_IQEXT);
+		VRC6IRQSchedule();
 		break;
 	case 0xF002:
+		X6502_MapIRQSync();
 		IRQa = IRQd;
 		X6502_IRQEnd(FCEU_IQEXT);
+		VRC6IRQSchedule();
 	}
 }
 
@@ -142,6 +153,7 @@ static void VRC6IRQHook(int a) {
 			}
 		}
 	}
+	VRC6IRQSchedule();
 }
 
 static void VRC6Close(void)
@@ -319,6 +331,7 @@ void VRC6SyncHQ(int32 ts) {
 
 static void VRC6_ESI(void) {
 	GameExpSound.RChange = VRC6_ESI;
+	GameExpSound.Name = "VRC6";
 	GameExpSound.Fill = VRC6Sound;
 	GameExpSound.HiFill = VRC6SoundHQ;
 	GameExpSound.HiSync = VRC6SyncHQ;
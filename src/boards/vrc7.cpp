@@ -85,6 +85,7 @@ static void VRC7SKill(void) {
 
 static void VRC7_ESI(void) {
 	GameExpSound.RChange = VRC7SC;
+	GameExpSound.Name = "VRC7";
 	GameExpSound.Kill = VRC7SKill;
 	VRC7Sound = OPLL_new(3579545, FSettings.SndRate ? FSettings.SndRate : 48000);
 	OPLL_reset(VRC7Sound);
@@ -118,6 +119,13 @@ static DECLFW(VRC7SW) {
 	}
 }
 
+static void VRC7IRQSchedule(void) {
+	if (IRQa)
+		X6502_MapIRQSchedule(((0x100 - IRQCount) * 341 - CycleCount + 2) / 3);
+	else
+		X6502_MapIRQSchedule(X6502_MAPIRQ_MAXDELAY);
+}
+
 static DECLFW(VRC7Write) {
 	A |= (A & 8) << 1;  // another two-in-oooone
 	if (A >= 0xA000 && A <= 0xDFFF) {
@@ -134,16 +142,20 @@ static DECLFW(VRC7Write) {
 		case 0xE000: mirr = V & 3; Sync(); break;
 		case 0xE010: IRQLatch = V; X6502_IRQEnd(FCEU_IQEXT); break;
 		case 0xF000:
+			X6502_MapIRQSync();
 			IRQa = V & 2;
 			IRQd = V & 1;
 			if (V & 2)
 				IRQCount = IRQLatch;
 			CycleCount = 0;
 			X6502_IRQEnd(FCEU_IQEXT);
+			VRC7IRQSchedule();
 			break;
 		case 0xF010:
+			X6502_MapIRQSync();
 			IRQa = IRQd;
 			X6502_IRQEnd(FCEU_IQEXT);
+			VRC7IRQSchedule();
 			break;
 		}
 }
@@ -175,6 +187,7 @@ static void VRC7IRQHook(int a) {
 			}
 		}
 	}
+	VRC7IRQSchedule();
 }
 
 static void StateRestore(int version) {
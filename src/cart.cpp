@@ -28,6 +28,7 @@
 
 #include "cart.h"
 #include "x6502.h"
+#include "debug.h"
 
 #include "file.h"
 #include "utils/memory.h"
@@ -44,7 +45,7 @@ uint8 *VPageG[8];
 uint8 *MMC5SPRVPage[8];
 uint8 *MMC5BGVPage[8];
 
-static uint8 PRGIsRAM[32];  /* This page is/is not PRG RAM. */
+uint8 PRGIsRAM[32];  /* This page is/is not PRG RAM. */
 
 /* 16 are (sort of) reserved for UNIF/iNES and 16 to map other stuff. */
 uint8 CHRram[32];
@@ -69,6 +70,8 @@ uint32 CHRmask8[32];
 
 int geniestage = 0;
 
+int bankbatch = 0;
+
 int modcon;
 
 uint8 genieval[3];
@@ -78,22 +81,6 @@ uint32 genieaddr[3];
 
 CartInfo *currCartInfo;
 
-static INLINE void setpageptr(int s, uint32 A, uint8 *p, int ram) {
-	uint32 AB = A >> 11;
-	int x;
-
-	if (p)
-		for (x = (s >> 1) - 1; x >= 0; x--) {
-			PRGIsRAM[AB + x] = ram;
-			Page[AB + x] = p - A;
-		}
-	else
-		for (x = (s >> 1) - 1; x >= 0; x--) {
-			PRGIsRAM[AB + x] = 0;
-			Page[AB + x] = 0;
-		}
-}
-
 static uint8 nothing[8192];
 void ResetCartMapping(void) {
 	int x;
@@ -108,6 +95,7 @@ void ResetCartMapping(void) {
 	for (x = 0; x < 8; x++) {
 		MMC5SPRVPage[x] = MMC5BGVPage[x] = VPageR[x] = nothing - 0x400 * x;
 	}
+	CDLogMappingChanged();
 }
 
 void SetupCartPRGMapping(int chip, uint8 *p, uint32 size, int ram) {
@@ -121,6 +109,31 @@ void SetupCartPRGMapping(int chip, uint8 *p, uint32 size, int ram) {
 	PRGmask32[chip] = (size >> 15) - 1;
 
 	PRGram[chip] = ram ? 1 : 0;
+	CDLogMappingChanged();
+}
+
+//Page[] and the VPage arrays are biased by the address of their slot.
+static void MovePages(uint8 **pages, int count, uint32 slot, uint8 *from, uint32 size, uint8 *to) {
+	for (int x = 0; x < count; x++) {
+		if (!pages[x])
+			continue;
+		uint8 *p = pages[x] + x * slot;
+		if (p >= from && p < from + size)
+			pages[x] = to + (p - from) - x * slot;
+	}
+}
+
+void MoveCartMemory(uint8 *from, uint32 size, uint8 *to) {
+	MovePages(PRGptr, 32, 0, from, size, to);
+	MovePages(CHRptr, 32, 0, from, size, to);
+	MovePages(Page, 32, 2048, from, size, to);
+	MovePages(VPage, 8, 0x400, from, size, to);
+	MovePages(VPageG, 8, 0x400, from, size, to);
+	MovePages(MMC5SPRVPage, 8, 0x400, from, size, to);
+	MovePages(MMC5BGVPage, 8, 0x400, from, size, to);
+	MovePages(vnapage, 4, 0, from, size, to);
+	MovePages(&MMC5HackVROMPTR, 1, 0, from, size, to);
+	CDLogMappingChanged();
 }
 
 void SetupCartCHRMapping(int chip, uint8 *p, uint32 size, int ram) {
@@ -158,135 +171,85 @@ DECLFR(CartBROB) {
 }
 
 void setprg2r(int r, uint32 A, uint32 V) {
-	V &= PRGmask2[r];
-	setpageptr(2, A, PRGptr[r] ? (&PRGptr[r][V << 11]) : 0, PRGram[r]);
+	setprgbank<0x800>(r, A, V);
 }
 
 void setprg2(uint32 A, uint32 V) {
-	setprg2r(0, A, V);
+	setprgbank<0x800>(0, A, V);
 }
 
 void setprg4r(int r, uint32 A, uint32 V) {
-	V &= PRGmask4[r];
-	setpageptr(4, A, PRGptr[r] ? (&PRGptr[r][V << 12]) : 0, PRGram[r]);
+	setprgbank<0x1000>(r, A, V);
 }
 
 void setprg4(uint32 A, uint32 V) {
-	setprg4r(0, A, V);
+	setprgbank<0x1000>(0, A, V);
 }
 
 void setprg8r(int r, uint32 A, uint32 V) {
-	if (PRGsize[r] >= 8192) {
-		V &= PRGmask8[r];
-		setpageptr(8, A, PRGptr[r] ? (&PRGptr[r][V << 13]) : 0, PRGram[r]);
-	} else {
-		uint32 VA = V << 2;
-		int x;
-		for (x = 0; x < 4; x++)
-			setpageptr(2, A + (x << 11), PRGptr[r] ? (&PRGptr[r][((VA + x) & PRGmask2[r]) << 11]) : 0, PRGram[r]);
-	}
+	setprgbank<0x2000>(r, A, V);
 }
 
 void setprg8(uint32 A, uint32 V) {
-	setprg8r(0, A, V);
+	setprgbank<0x2000>(0, A, V);
 }
 
 void setprg16r(int r, uint32 A, uint32 V) {
-	if (PRGsize[r] >= 16384) {
-		V &= PRGmask16[r];
-		setpageptr(16, A, PRGptr[r] ? (&PRGptr[r][V << 14]) : 0, PRGram[r]);
-	} else {
-		uint32 VA = V << 3;
-		int x;
-
-		for (x = 0; x < 8; x++)
-			setpageptr(2, A + (x << 11), PRGptr[r] ? (&PRGptr[r][((VA + x) & PRGmask2[r]) << 11]) : 0, PRGram[r]);
-	}
+	setprgbank<0x4000>(r, A, V);
 }
 
 void setprg16(uint32 A, uint32 V) {
-	setprg16r(0, A, V);
+	setprgbank<0x4000>(0, A, V);
 }
 
 void setprg32r(int r, uint32 A, uint32 V) {
-	if (PRGsize[r] >= 32768) {
-		V &= PRGmask32[r];
-		setpageptr(32, A, PRGptr[r] ? (&PRGptr[r][V << 15]) : 0, PRGram[r]);
-	} else {
-		uint32 VA = V << 4;
-		int x;
-
-		for (x = 0; x < 16; x++)
-			setpageptr(2, A + (x << 11), PRGptr[r] ? (&PRGptr[r][((VA + x) & PRGmask2[r]) << 11]) : 0, PRGram[r]);
-	}
+	setprgbank<0x8000>(r, A, V);
 }
 
 void setprg32(uint32 A, uint32 V) {
-	setprg32r(0, A, V);
+	setprgbank<0x8000>(0, A, V);
 }
 
 void setchr1r(int r, uint32 A, uint32 V) {
-	if (!CHRptr[r]) return;
-	FCEUPPU_LineUpdate();
-	V &= CHRmask1[r];
-	if (CHRram[r])
-		PPUCHRRAM |= (1 << (A >> 10));
-	else
-		PPUCHRRAM &= ~(1 << (A >> 10));
-	VPageR[(A) >> 10] = &CHRptr[r][(V) << 10] - (A);
+	setchrbank<0x400>(r, A, V);
 }
 
 void setchr2r(int r, uint32 A, uint32 V) {
-	if (!CHRptr[r]) return;
-	FCEUPPU_LineUpdate();
-	V &= CHRmask2[r];
-	VPageR[(A) >> 10] = VPageR[((A) >> 10) + 1] = &CHRptr[r][(V) << 11] - (A);
-	if (CHRram[r])
-		PPUCHRRAM |= (3 << (A >> 10));
-	else
-		PPUCHRRAM &= ~(3 << (A >> 10));
+	setchrbank<0x800>(r, A, V);
 }
 
 void setchr4r(int r, unsigned int A, unsigned int V) {
-	if (!CHRptr[r]) return;
-	FCEUPPU_LineUpdate();
-	V &= CHRmask4[r];
-	VPageR[(A) >> 10] = VPageR[((A) >> 10) + 1] =
-							VPageR[((A) >> 10) + 2] = VPageR[((A) >> 10) + 3] = &CHRptr[r][(V) << 12] - (A);
-	if (CHRram[r])
-		PPUCHRRAM |= (15 << (A >> 10));
-	else
-		PPUCHRRAM &= ~(15 << (A >> 10));
+	setchrbank<0x1000>(r, A, V);
 }
 
 void setchr8r(int r, uint32 V) {
-	int x;
+	setchrbank<0x2000>(r, 0, V);
+}
 
-	if (!CHRptr[r]) return;
-	FCEUPPU_LineUpdate();
-	V &= CHRmask8[r];
-	for (x = 7; x >= 0; x--)
-		VPageR[x] = &CHRptr[r][V << 13];
-	if (CHRram[r])
-		PPUCHRRAM |= (255);
-	else
-		PPUCHRRAM = 0;
+void BeginBankUpdate(void) {
+	if (!bankbatch++)
+		FCEUPPU_LineUpdate();
+}
+
+void EndBankUpdate(void) {
+	if (bankbatch)
+		bankbatch--;
 }
 
 void setchr1(uint32 A, uint32 V) {
-	setchr1r(0, A, V);
+	setchrbank<0x400>(0, A, V);
 }
 
 void setchr2(uint32 A, uint32 V) {
-	setchr2r(0, A, V);
+	setchrbank<0x800>(0, A, V);
 }
 
 void setchr4(uint32 A, uint32 V) {
-	setchr4r(0, A, V);
+	setchrbank<0x1000>(0, A, V);
 }
 
 void setchr8(uint32 V) {
-	setchr8r(0, V);
+	setchrbank<0x2000>(0, 0, V);
 }
 
 /* This function can be called without calling SetupCartMirroring(). */
@@ -40,6 +40,10 @@ void ResetCartMapping(void);
 void SetupCartPRGMapping(int chip, uint8 *p, uint32 size, int ram);
 void SetupCartCHRMapping(int chip, uint8 *p, uint32 size, int ram);
 void SetupCartMirroring(int m, int hard, uint8 *extra);
+//Re-point every bank, nametable and chip pointer into the size bytes at
+//from to the same offset at to, for when their contents have been copied
+//there.
+void MoveCartMemory(uint8 *from, uint32 size, uint8 *to);
 
 DECLFR(CartBROB);
 DECLFR(CartBR);
@@ -87,6 +91,86 @@ void setchr2(unsigned int A, unsigned int V);
 void setchr4(unsigned int A, unsigned int V);
 void setchr8(unsigned int V);
 
+//Bank switching specialized at compile time on the bank size, which
+//unrolls the page table updates and picks the mask table statically.
+//They behave exactly like the setprgNr()/setchrNr() functions above, pass
+//the chip as a constant and it folds away too.
+
+extern uint8 PRGIsRAM[32];
+extern uint8 **VPageR;
+extern uint8 PPUCHRRAM;
+extern int bankbatch;
+void FCEUPPU_LineUpdate();
+
+template<uint32 SIZE>
+static INLINE uint32 prgbankmask(int r) {
+	switch (SIZE) {
+	case 0x800: return PRGmask2[r];
+	case 0x1000: return PRGmask4[r];
+	case 0x2000: return PRGmask8[r];
+	case 0x4000: return PRGmask16[r];
+	default: return PRGmask32[r];
+	}
+}
+
+template<uint32 SIZE>
+static INLINE uint32 chrbankmask(int r) {
+	switch (SIZE) {
+	case 0x400: return CHRmask1[r];
+	case 0x800: return CHRmask2[r];
+	case 0x1000: return CHRmask4[r];
+	default: return CHRmask8[r];
+	}
+}
+
+template<uint32 SIZE>
+static INLINE void setprgbank(int r, uint32 A, uint32 V) {
+	uint8 *p = PRGptr[r];
+	uint32 AB = A >> 11;
+	uint8 ram = p ? PRGram[r] : 0;
+	int x;
+
+	if (SIZE <= 0x1000 || PRGsize[r] >= SIZE) {
+		if (p)
+			p = &p[(V & prgbankmask<SIZE>(r)) * SIZE] - A;
+		for (x = 0; x < (int)(SIZE >> 11); x++) {
+			PRGIsRAM[AB + x] = ram;
+			Page[AB + x] = p;
+		}
+	} else {
+		//Chip smaller than the bank, fill it in 2KB at a time.
+		uint32 VA = V * (SIZE >> 11);
+		for (x = 0; x < (int)(SIZE >> 11); x++) {
+			PRGIsRAM[AB + x] = ram;
+			Page[AB + x] = p ? &p[((VA + x) & PRGmask2[r]) << 11] - (A + (x << 11)) : 0;
+		}
+	}
+}
+
+template<uint32 SIZE>
+static INLINE void setchrbank(int r, uint32 A, uint32 V) {
+	const uint32 bits = ((1 << (SIZE >> 10)) - 1) << (A >> 10);
+	uint8 *p;
+	int x;
+
+	if (!CHRptr[r]) return;
+	if (!bankbatch)
+		FCEUPPU_LineUpdate();
+	p = &CHRptr[r][(V & chrbankmask<SIZE>(r)) * SIZE] - A;
+	for (x = 0; x < (int)(SIZE >> 10); x++)
+		VPageR[(A >> 10) + x] = p;
+	if (CHRram[r])
+		PPUCHRRAM |= bits;
+	else
+		PPUCHRRAM &= ~bits;
+}
+
+//Bracket a group of bank switches done by one register write.  The PPU is
+//caught up once at the start instead of before every CHR switch, nothing
+//else changes.  May be nested.
+void BeginBankUpdate(void);
+void EndBankUpdate(void);
+
 void setmirror(int t);
 void setmirrorw(int a, int b, int c, int d);
 void setntamem(uint8 *p, int ram, uint32 b);
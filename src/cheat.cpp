@@ -26,6 +26,7 @@
 #include "file.h"
 #include "cart.h"
 #include "driver.h"
+#include "debug.h"
 #include "utils/memory.h"
 
 #include <string>
@@ -59,13 +60,32 @@ void FCEU_CheatAddRAM(int s, uint32 A, uint8 *p)
 }
 
 
-CHEATF_SUBFAST SubCheats[256] = { 0 };
+//Substitute cheats in force, at most one per address, and the slot of the
+//one for each hooked address so a read doesn't have to look for it.
+vector<CHEATF_SUBFAST> SubCheats;
 uint32 numsubcheats = 0;
+static uint16 SubCheatSlot[0x10000];
 int globalCheatDisabled = 0;
 int disableAutoLSCheats = 0;
 bool disableShowGG = 0;
 static _8BYTECHEATMAP* cheatMap = NULL;
-struct CHEATF *cheats = 0, *cheatsl = 0;
+
+//Every cheat, in the order they were added.
+vector<CHEATF> cheats;
+
+//RAM writes of the enabled replace cheats, compiled from the list by
+//RebuildSubCheats() and sorted by address so each frame looks up each 1KB
+//page once.  The sort is stable, so the last cheat on an address still wins.
+struct CHEATPATCH {
+	uint16 addr;
+	uint8 val;
+};
+static vector<CHEATPATCH> CheatPatches;
+
+static bool CheatPatchLess(const CHEATPATCH &a, const CHEATPATCH &b)
+{
+	return a.addr < b.addr;
+}
 
 
 #define CHEATC_NONE     0x8000
@@ -77,32 +97,22 @@ int savecheats = 0;
 
 static DECLFR(SubCheatsRead)
 {
-	CHEATF_SUBFAST *s = SubCheats;
-	int x=numsubcheats;
+	const CHEATF_SUBFAST *s = &SubCheats[SubCheatSlot[A]];
 
-	do
+	if(s->compare>=0)
 	{
-		if(s->addr==A)
-		{
-			if(s->compare>=0)
-			{
-				uint8 pv=s->PrevRead(A);
+		uint8 pv=s->PrevRead(A);
 
-				if(pv==s->compare)
-					return(s->val);
-				else return(pv);
-			}
-			else return(s->val);
-		}
-		s++;
-	} while(--x);
-	return(0);	/* We should never get here. */
+		if(pv==s->compare)
+			return(s->val);
+		else return(pv);
+	}
+	else return(s->val);
 }
 
 void RebuildSubCheats(void)
 {
 	uint32 x;
-	struct CHEATF *c = cheats;
 	for (x = 0; x < numsubcheats; x++)
 	{
 		SetReadHandler(SubCheats[x].addr, SubCheats[x].addr, SubCheats[x].PrevRead);
@@ -111,27 +121,50 @@ void RebuildSubCheats(void)
 	}
 
 	numsubcheats = 0;
+	SubCheats.clear();
 
 	if (!globalCheatDisabled)
 	{
-		while(c)
+		for (size_t i = 0; i < cheats.size(); i++)
 		{
+			const CHEATF *c = &cheats[i];
+
 			if(c->type == 1 && c->status && GetReadHandler(c->addr) != SubCheatsRead)
 			{
-				SubCheats[numsubcheats].PrevRead = GetReadHandler(c->addr);
-				SubCheats[numsubcheats].addr = c->addr;
-				SubCheats[numsubcheats].val = c->val;
-				SubCheats[numsubcheats].compare = c->compare;
+				CHEATF_SUBFAST s;
+
+				s.PrevRead = GetReadHandler(c->addr);
+				s.addr = c->addr;
+				s.val = c->val;
+				s.compare = c->compare;
+				SubCheats.push_back(s);
+				SubCheatSlot[c->addr] = numsubcheats;
 				SetReadHandler(c->addr, c->addr, SubCheatsRead);
 				if (cheatMap)
-					FCEUI_SetCheatMapByte(SubCheats[numsubcheats].addr, true);
+					FCEUI_SetCheatMapByte(c->addr, true);
 				numsubcheats++;
 			}
-			c = c->next;
 		}
 	}
 	FrozenAddressCount = numsubcheats;		//Update the frozen address list
 
+	CheatPatches.clear();
+	for (size_t i = 0; i < cheats.size(); i++)
+	{
+		if (cheats[i].status && !cheats[i].type)
+		{
+			CHEATPATCH patch;
+
+			patch.addr = cheats[i].addr;
+			patch.val = cheats[i].val;
+			CheatPatches.push_back(patch);
+		}
+	}
+	stable_sort(CheatPatches.begin(), CheatPatches.end(), CheatPatchLess);
+
+	//the substitutions change what reads see
+	DEBUG( DebugMarkAllDirty() )
+
 }
 
 void FCEU_PowerCheats()
@@ -160,32 +193,33 @@ static void CheatMemErr(void)
 
 static int AddCheatEntry(const char *name, uint32 addr, uint8 val, int compare, int status, int type)
 {
-	struct CHEATF *temp;
-	if(!(temp = (struct CHEATF *)FCEU_dmalloc(sizeof(struct CHEATF))))
+	CHEATF temp;
+	if(!(temp.name = (char *)FCEU_dmalloc(strlen(name) + 1)))
 	{
 		CheatMemErr();
 		return(0);
 	}
 
-	temp->name = strcpy((char*) FCEU_dmalloc(strlen(name) + 1), name);
-	temp->addr = addr;
-	temp->val = val;
-	temp->status = status;
-	temp->compare = compare;
-	temp->type = type;
-	temp->next = 0;
+	strcpy(temp.name, name);
+	temp.addr = addr;
+	temp.val = val;
+	temp.status = status;
+	temp.compare = compare;
+	temp.type = type;
 
-	if(cheats)
-	{
-		cheatsl->next = temp;
-		cheatsl = temp;
-	}
-	else
-		cheats = cheatsl = temp;
+	cheats.push_back(temp);
 
 	return (1);
 }
 
+//Frees the names and empties the list.
+static void FreeCheats(void)
+{
+	for(size_t x = 0; x < cheats.size(); x++)
+		free(cheats[x].name);
+	cheats.clear();
+}
+
 /* The "override_existing" parameter is used only in cheat dialog import.
    Since the default behaviour will reset numsubcheats to 0 everytime,
    In game loading, this is absolutely right, but when importing in cheat window,
@@ -294,9 +328,10 @@ void FCEU_LoadGameCheats(FILE *override, int override_existing)
 
 void FCEU_SaveGameCheats(FILE* fp, int release)
 {
-	struct CHEATF *next = cheats;
-	while (next)
+	for (size_t x = 0; x < cheats.size(); x++)
 	{
+		const CHEATF *next = &cheats[x];
+
 		if (next->type)
 			fputc('S', fp);
 		if (next->compare >= 0)
@@ -309,12 +344,9 @@ void FCEU_SaveGameCheats(FILE* fp, int release)
 			fprintf(fp, "%04x:%02x:%02x:%s\n", next->addr, next->val, next->compare, next->name);
 		else
 			fprintf(fp, "%04x:%02x:%s\n", next->addr, next->val, next->name);
-
-		if (release) free(next->name);
-		struct CHEATF *t = next;
-		next = next->next;
-		if (release) free(t);
 	}
+	if (release)
+		FreeCheats();
 }
 
 void FCEU_FlushGameCheats(FILE *override, int nosave)
@@ -326,19 +358,7 @@ void FCEU_FlushGameCheats(FILE *override, int nosave)
 	}
 	if((!savecheats || nosave) && !override)	/* Always save cheats if we're being overridden. */
 	{
-		if(cheats)
-		{
-			struct CHEATF *next=cheats;
-			for(;;)
-			{
-				struct CHEATF *last=next;
-				next=next->next;
-				free(last->name);
-				free(last);
-				if(!next) break;
-			}
-			cheats=cheatsl=0;
-		}
+		FreeCheats();
 	}
 	else
 	{
@@ -347,7 +367,7 @@ void FCEU_FlushGameCheats(FILE *override, int nosave)
 		if(!override)
 			fn = strdup(FCEU_MakeFName(FCEUMKF_CHEAT,0,0).c_str());
 
-		if(cheats)
+		if(cheats.size())
 		{
 			FILE *fp;
 
@@ -364,7 +384,7 @@ void FCEU_FlushGameCheats(FILE *override, int nosave)
 			}
 			else
 				FCEUD_PrintError("Error saving cheats.");
-			cheats=cheatsl=0;
+			FreeCheats();
 		}
 		else if(!override)
 			remove(fn);
@@ -390,43 +410,11 @@ int FCEUI_AddCheat(const char *name, uint32 addr, uint8 val, int compare, int ty
 
 int FCEUI_DelCheat(uint32 which)
 {
-	struct CHEATF *prev;
-	struct CHEATF *cur;
-	uint32 x=0;
-
-	for(prev=0,cur=cheats;;)
-	{
-		if(x==which)          // Remove this cheat.
-		{
-			if(prev)             // Update pointer to this cheat.
-			{
-				if(cur->next)       // More cheats.
-					prev->next=cur->next;
-				else                // No more.
-				{
-					prev->next=0;
-					cheatsl=prev;      // Set the previous cheat as the last cheat.
-				}
-			}
-			else                 // This is the first cheat.
-			{
-				if(cur->next)       // More cheats
-					cheats=cur->next;
-				else
-					cheats=cheatsl=0;  // No (more) cheats.
-			}
-			free(cur->name);     // Now that all references to this cheat are removed,
-			free(cur);           // free the memory.
-			break;
-		}                     // *END REMOVE THIS CHEAT*
-
+	if(which >= cheats.size())
+		return(0);
 
-		if(!cur->next)        // No more cheats to go through(this shouldn't ever happen...)
-			return(0);
-		prev=cur;
-		cur=prev->next;
-		x++;
-	}
+	free(cheats[which].name);
+	cheats.erase(cheats.begin() + which);
 
 	savecheats=1;
 	RebuildSubCheats();
@@ -435,60 +423,56 @@ int FCEUI_DelCheat(uint32 which)
 
 void FCEU_ApplyPeriodicCheats(void)
 {
-	struct CHEATF *cur=cheats;
-	if(!cur) return;
+	uint32 page = ~0U;
+	uint8 *p = 0;
 
-	for(;;)
+	for(size_t x = 0; x < CheatPatches.size(); x++)
 	{
-		if(cur->status && !(cur->type))
-			if(CheatRPtrs[cur->addr>>10])
-				CheatRPtrs[cur->addr>>10][cur->addr]=cur->val;
-		if(cur->next)
-			cur=cur->next;
-		else
-			break;
+		const CHEATPATCH &c = CheatPatches[x];
+
+		if((uint32)(c.addr >> 10) != page)
+		{
+			page = c.addr >> 10;
+			p = CheatRPtrs[page];
+		}
+		if(p && p[c.addr] != c.val) {
+			p[c.addr] = c.val;
+			DEBUG( debugDirtyCPU[c.addr >> 8] = 1 )
+		}
 	}
 }
 
 
 void FCEUI_ListCheats(int (*callb)(char *name, uint32 a, uint8 v, int compare, int s, int type, void *data), void *data)
 {
-	struct CHEATF *next=cheats;
-
-	while(next)
+	for(size_t x = 0; x < cheats.size(); x++)
 	{
+		CHEATF *next = &cheats[x];
+
 		if(!callb(next->name,next->addr,next->val,next->compare,next->status,next->type,data)) break;
-		next=next->next;
 	}
 }
 
 int FCEUI_GetCheat(uint32 which, char **name, uint32 *a, uint8 *v, int *compare, int *s, int *type)
 {
-	struct CHEATF *next=cheats;
-	uint32 x=0;
+	if(which >= cheats.size())
+		return(0);
 
-	while(next)
-	{
-		if(x==which)
-		{
-			if(name)
-				*name=next->name;
-			if(a)
-				*a=next->addr;
-			if(v)
-				*v=next->val;
-			if(s)
-				*s=next->status;
-			if(compare)
-				*compare=next->compare;
-			if(type)
-				*type=next->type;
-			return(1);
-		}
-		next=next->next;
-		x++;
-	}
-	return(0);
+	CHEATF *next = &cheats[which];
+
+	if(name)
+		*name=next->name;
+	if(a)
+		*a=next->addr;
+	if(v)
+		*v=next->val;
+	if(s)
+		*s=next->status;
+	if(compare)
+		*compare=next->compare;
+	if(type)
+		*type=next->type;
+	return(1);
 }
 
 static int GGtobin(char c)
@@ -602,62 +586,47 @@ int FCEUI_DecodePAR(const char *str, int *a, int *v, int *c, int *type)
 
 int FCEUI_SetCheat(uint32 which, const char *name, int32 a, int32 v, int c, int s, int type)
 {
-	struct CHEATF *next = cheats;
-	uint32 x = 0;
+	if(which >= cheats.size())
+		return 0;
+
+	CHEATF *next = &cheats[which];
 
-	while(next)
+	if(name)
 	{
-		if(x == which)
-		{
-			if(name)
-			{
-				char *t;
-				if((t = (char *)realloc(next->name, strlen(name) + 1)))
-					strcpy(next->name = t, name);
-				else
-					return 0;
-			}
-			if(a >= 0)
-				next->addr = a;
-			if(v >= 0)
-				next->val = v;
-			if(s >= 0)
-				next->status = s;
-			if(c >= -1)
-				next->compare = c;
-			next->type = type;
-
-			savecheats = 1;
-			RebuildSubCheats();
-
-			return 1;
-		}
-		next = next->next;
-		x++;
-	}
-	return 0;
+		char *t;
+		if((t = (char *)realloc(next->name, strlen(name) + 1)))
+			strcpy(next->name = t, name);
+		else
+			return 0;
+	}
+	if(a >= 0)
+		next->addr = a;
+	if(v >= 0)
+		next->val = v;
+	if(s >= 0)
+		next->status = s;
+	if(c >= -1)
+		next->compare = c;
+	next->type = type;
+
+	savecheats = 1;
+	RebuildSubCheats();
+
+	return 1;
 }
 
 /* Convenience function. */
 int FCEUI_ToggleCheat(uint32 which)
 {
-	struct CHEATF *next=cheats;
-	uint32 x=0;
+	if(which >= cheats.size())
+		return(-1);
 
-	while(next)
-	{
-		if(x==which)
-		{
-			next->status=!next->status;
-			savecheats=1;
-			RebuildSubCheats();
-			return(next->status);
-		}
-		next=next->next;
-		x++;
-	}
+	CHEATF *next = &cheats[which];
 
-	return(-1);
+	next->status=!next->status;
+	savecheats=1;
+	RebuildSubCheats();
+	return(next->status);
 }
 
 int FCEUI_GlobalToggleCheat(int global_enabled)
@@ -883,20 +852,19 @@ void FCEU_CheatSetByte(uint32 A, uint8 V)
     CheatRPtrs[A>>10][A]=V;
    else if(A < 0x10000)
     BWrite[A](A, V);
+   DEBUG( debugDirtyCPU[(A>>8)&0xFF]=1 )
 }
 
 // disable all cheats
 int FCEU_DisableAllCheats(void)
 {
 	int count = 0;
-	struct CHEATF *next = cheats;
-	while(next)
+	for(size_t x = 0; x < cheats.size(); x++)
 	{
-		if(next->status){
+		if(cheats[x].status){
 			count++;
 		}
-		next->status = 0;
-		next = next->next;
+		cheats[x].status = 0;
 	}
 	savecheats = 1;
 	RebuildSubCheats();
@@ -906,19 +874,7 @@ int FCEU_DisableAllCheats(void)
 // delete all cheats
 int FCEU_DeleteAllCheats(void)
 {
-	struct CHEATF *cur = cheats;
-	struct CHEATF *next = NULL;
-	while (cur)
-	{
-		next = cur->next;
-		if ( cur->name )
-		{
-			free(cur->name);
-		}
-		free(cur);
-		cur = next;
-	}
-	cheats = cheatsl = 0;
+	FreeCheats();
 	savecheats = 1;
 	RebuildSubCheats();
 
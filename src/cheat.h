@@ -41,7 +41,6 @@ typedef struct {
 } CHEATF_SUBFAST;
 
 struct CHEATF {
-	struct CHEATF *next;
 	char *name;
 	uint16 addr;
 	uint8 val;
@@ -13,6 +13,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <chrono>
 
 unsigned int debuggerPageSize = 14;
 int vblankScanLines = 0;	//Used to calculate scanlines 240-261 (vblank)
@@ -455,6 +456,93 @@ unsigned char *cdloggerdata = NULL;
 unsigned int cdloggerdataSize = 0;
 static int indirectnext = 0;
 
+std::atomic<uint64> cdlLoggingNs(0), cdlInstructions(0);
+static uint32 cdlSampleCount = 0;
+static int64 cdlClockNs = -1;
+#define CDL_SAMPLE 64		//one instruction in this many is timed, a power of 2
+
+//What reading the clock twice costs, which would otherwise swamp the little
+//being timed.
+static int64 CDLClockNs(void)
+{
+	std::chrono::steady_clock::duration total(0);
+
+	for(int i = 0; i < 64; i++) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		total += std::chrono::steady_clock::now() - start;
+	}
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(total).count() / 64;
+}
+
+//Adds one timed instruction to the estimate, less what reading the clock cost.
+static void CDLAddSample(std::chrono::steady_clock::duration spent, int reads)
+{
+	int64 ns = std::chrono::duration_cast<std::chrono::nanoseconds>(spent).count();
+
+	if(cdlClockNs < 0)
+		cdlClockNs = CDLClockNs();
+	ns -= cdlClockNs * reads / 2;
+	if(ns > 0)
+		cdlLoggingNs.fetch_add(CDL_SAMPLE * (uint64)ns, std::memory_order_relaxed);
+}
+
+//GetPRGAddress of the first byte of each 2K slot, for the Page[] it was
+//worked out with.  Bank switches change Page[], so they are noticed without
+//being told; only a change of the ROM itself has to be.
+#define CDL_SLOT_NONE  -1		//no byte of the slot is in the ROM
+#define CDL_SLOT_MIXED -2		//some are, GetPRGAddress decides each one
+static uint8 *cdlSlotPage[32];
+static int cdlSlotOffset[32];
+
+void CDLogMappingChanged(void)
+{
+	for(int x = 0; x < 32; x++) {
+		cdlSlotPage[x] = NULL;
+		cdlSlotOffset[x] = CDL_SLOT_MIXED;
+	}
+}
+
+//The same sums as GetPRGAddress, for the whole slot at once.
+static int CDLSlotOffset(int slot)
+{
+	int A = slot << 11;
+	uint8 *chip = PRGptr[0];
+	int64 size = PRGsize[0], add = 0;
+
+	if (GameInfo->type == GIT_FDS) {
+		if (A < 0xE000) {
+			chip = PRGptr[1];
+			size = PRGsize[1];
+		} else
+			add = PRGsize[1];
+	}
+
+	int result = &Page[slot][A] - chip;
+	int64 last = (int64)result + 0x7FF;
+
+	if (result >= 0 && last <= size)
+		return result + (int)add;
+	if (last < 0 || result > size)
+		return CDL_SLOT_NONE;
+	return CDL_SLOT_MIXED;
+}
+
+static INLINE int CDLGetPRGAddress(uint16 A)
+{
+	int slot = A >> 11;
+	int offset;
+
+	if (Page[slot] != cdlSlotPage[slot]) {
+		cdlSlotPage[slot] = Page[slot];
+		cdlSlotOffset[slot] = CDLSlotOffset(slot);
+	}
+	offset = cdlSlotOffset[slot];
+
+	if (offset >= 0)
+		return offset + (A & 0x7FF);
+	return (offset == CDL_SLOT_NONE) ? -1 : GetPRGAddress(A);
+}
+
 int debug_loggingCD = 0;
 
 //called by the cpu to perform logging if CDLogging is enabled
@@ -486,7 +574,7 @@ void LogCDData(uint8 *opcode, uint16 A, int size)
 	uint8 memop = 0;
 	bool newCodeHit = false, newDataHit = false;
 
-	if ((j = GetPRGAddress(_PC)) != -1)
+	if ((j = CDLGetPRGAddress(_PC)) != -1)
 	{
 		for (i = 0; i < size; i++)
 		{
@@ -512,7 +600,7 @@ void LogCDData(uint8 *opcode, uint16 A, int size)
 		case 4: memop = 0x20; break;
 	}
 
-	if ((j = GetPRGAddress(A)) != -1)
+	if ((j = CDLGetPRGAddress(A)) != -1)
 	{
 		if (opwrite[opcode[0]] == 0)
 		{
@@ -574,6 +662,17 @@ uint64 break_instructions_limit = 0;
 
 static DebuggerState dbgstate;
 
+uint8 debugDirtyCPU[0x100];
+uint8 debugDirtyPPU[0x40];
+uint8 debugDirtyOAM;
+
+void DebugMarkAllDirty()
+{
+	memset(debugDirtyCPU, 1, sizeof(debugDirtyCPU));
+	memset(debugDirtyPPU, 1, sizeof(debugDirtyPPU));
+	debugDirtyOAM = 1;
+}
+
 DebuggerState &FCEUI_Debugger() { return dbgstate; }
 
 void ResetDebugStatisticsCounters()
@@ -600,6 +699,13 @@ void IncrementInstructionsCounters()
 	delta_instructions++;
 }
 
+// whether something has to see every instruction go by (breakpoints, stepping,
+// code/data logging), so the CPU core mustn't skip any
+bool DebugWatchingCPU()
+{
+	return numWPs || dbgstate.step || dbgstate.runline || dbgstate.stepout || watchpoint[64].flags || dbgstate.badopbreak || break_on_cycles || break_on_instructions || break_asap || debug_loggingCD || debug_tracingDesync || FCEUD_TraceLoggerRunning();
+}
+
 bool CondForbidTest(int bp_num) {
 	if (bp_num >= 0 && !condition(&watchpoint[bp_num]))
 	{
@@ -893,6 +999,17 @@ STOPCHECKING:
 }
 //bbit edited: this is the end of the inserted code
 
+//GetMem without the call for RAM and ROM, which is most of what DebugCycle
+//reads.  Everything else still goes through GetMem, registers especially.
+static INLINE uint8 DebugPeek(uint16 A)
+{
+	if (A < 0x800 && ARead[A] == ARAML)
+		return RAM[A];
+	if (A >= 0x5000 && ARead[A] == CartBR)
+		return Page[A >> 11][A];
+	return GetMem(A);
+}
+
 void DebugCycle()
 {
 	uint8 opcode[3] = {0};
@@ -914,19 +1031,35 @@ void DebugCycle()
 		if ((_PC >= 0x3801) && (_PC <= 0x3824)) return;
 	}
 
-	opcode[0] = GetMem(_PC);
+	//A sample of the instructions logged is timed, from here to the end of
+	//LogCDData, leaving out the breakpoints.
+	std::chrono::steady_clock::time_point cdlStart;
+	std::chrono::steady_clock::duration cdlSpent(0);
+	int cdlReads = 2;
+	bool cdlTimed = false;
+
+	if (debug_loggingCD)
+	{
+		//No other thread writes it, so this needn't be a locked add.
+		cdlInstructions.store(cdlInstructions.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		cdlTimed = !(++cdlSampleCount & (CDL_SAMPLE - 1));
+		if (cdlTimed)
+			cdlStart = std::chrono::steady_clock::now();
+	}
+
+	opcode[0] = DebugPeek(_PC);
 	size = opsize[opcode[0]];
 	switch (size)
 	{
 		default:
 		case 1: break;
 		case 2:
-			opcode[1] = GetMem(_PC + 1);
+			opcode[1] = DebugPeek(_PC + 1);
 			break;
 		case 0: // illegal instructions may have operands
 		case 3:
-			opcode[1] = GetMem(_PC + 1);
-			opcode[2] = GetMem(_PC + 2);
+			opcode[1] = DebugPeek(_PC + 1);
+			opcode[2] = DebugPeek(_PC + 2);
 			break;
 	}
 
@@ -935,13 +1068,13 @@ void DebugCycle()
 		case 0: break;
 		case 1:
 			tmp = (opcode[1] + _X) & 0xFF;
-			A = GetMem(tmp);
+			A = DebugPeek(tmp);
 			tmp = (opcode[1] + _X + 1) & 0xFF;
-			A |= (GetMem(tmp) << 8);
+			A |= (DebugPeek(tmp) << 8);
 			break;
 		case 2: A = opcode[1]; break;
 		case 3: A = opcode[1] | (opcode[2] << 8); break;
-		case 4: A = (GetMem(opcode[1]) | (GetMem((opcode[1] + 1) & 0xFF) << 8)) + _Y; break;
+		case 4: A = (DebugPeek(opcode[1]) | (DebugPeek((opcode[1] + 1) & 0xFF) << 8)) + _Y; break;
 		case 5: A = opcode[1] + _X; break;
 		case 6: A = (opcode[1] | (opcode[2] << 8)) + _Y; break;
 		case 7: A = (opcode[1] | (opcode[2] << 8)) + _X; break;
@@ -949,10 +1082,29 @@ void DebugCycle()
 	}
 
 	if (numWPs || dbgstate.step || dbgstate.runline || dbgstate.stepout || watchpoint[64].flags || dbgstate.badopbreak || break_on_cycles || break_on_instructions || break_asap)
+	{
+		if (cdlTimed)
+			cdlSpent = std::chrono::steady_clock::now() - cdlStart;
 		breakpoint(opcode, A, size);
+		if (cdlTimed)
+		{
+			cdlStart = std::chrono::steady_clock::now();
+			cdlReads = 4;
+		}
+	}
 
 	if(debug_loggingCD)
+	{
 		LogCDData(opcode, A, size);
+		if (cdlTimed)
+		{
+			cdlSpent += std::chrono::steady_clock::now() - cdlStart;
+			CDLAddSample(cdlSpent, cdlReads);
+		}
+	}
+
+	if(debug_tracingDesync)
+		DesyncTraceInstruction(opcode, size);
 
 	FCEUD_TraceInstruction(opcode, size);
 }
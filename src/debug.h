@@ -5,6 +5,8 @@
 #include "git.h"
 #include "nsf.h"
 
+#include <atomic>
+
 //watchpoint stuffs
 #define WP_E       0x01  //watchpoint, enable
 #define WP_W       0x02  //watchpoint, write
@@ -77,7 +79,12 @@ uint8 GetPPUMem(uint8 A);
 //---------CDLogger
 void LogCDVectors(int which);
 void LogCDData(uint8 *opcode, uint16 A, int size);
+void CDLogMappingChanged(void);
 extern volatile int codecount, datacount, undefinedcount;
+//Time spent logging in nanoseconds, estimated by timing a sample of the
+//instructions, and the number of instructions logged.  Compare two readings.
+//Only the emulation thread writes them, but the GUI reads them from its own.
+extern std::atomic<uint64> cdlLoggingNs, cdlInstructions;
 extern unsigned char *cdloggerdata;
 extern unsigned int cdloggerdataSize;
 
@@ -116,6 +123,20 @@ extern void ResetCyclesCounter();
 extern void ResetInstructionsCounter();
 extern void ResetDebugStatisticsDeltaCounters();
 extern void IncrementInstructionsCounters();
+extern bool DebugWatchingCPU();
+
+//256-byte pages of CPU and PPU address space, and OAM, written to since the
+//memory viewers last took them, so they only copy what changed.  Only writes
+//are seen: bank switches and registers that change by themselves are left
+//to the viewer.
+extern uint8 debugDirtyCPU[0x100];
+extern uint8 debugDirtyPPU[0x40];
+extern uint8 debugDirtyOAM;
+void DebugMarkAllDirty();
+
+//set while FCEUI_DesyncTrace wants to see every instruction
+extern bool debug_tracingDesync;
+void DesyncTraceInstruction(uint8 *opcode, int size);
 //-------------
 
 //internal variables that debuggers will want access to
@@ -0,0 +1,327 @@
+/* FCE Ultra - NES/Famicom Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/// \file
+/// \brief Finding the instruction where two configurations playing the same movie part ways
+
+#include "types.h"
+#include "fceu.h"
+#include "driver.h"
+#include "x6502.h"
+#include "debug.h"
+#include "movie.h"
+#include "state.h"
+#include "emufile.h"
+#include "utils/crc32.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+extern SFORMAT SFCPU[], SFCPUC[];
+
+bool debug_tracingDesync = false;
+static FILE *traceFile;
+
+#define DESYNC_CONTEXT 12		//instructions shown before the first that differs
+
+//FNV-1a over every field of a state chunk, RAM included.
+static uint64 HashChunk(uint64 h, SFORMAT *sf)
+{
+	for(; sf->v; sf++) {
+		if(sf->s == ~0u) {
+			h = HashChunk(h, (SFORMAT *)sf->v);
+			continue;
+		}
+
+		uint32 size = sf->s & ~(FCEUSTATE_RLSB | FCEUSTATE_INDIRECT);
+		uint8 *p = (sf->s & FCEUSTATE_INDIRECT) ? *(uint8 **)sf->v : (uint8 *)sf->v;
+
+		for(uint32 i = 0; i < size; i++)
+			h = (h ^ p[i]) * 1099511628211ULL;
+	}
+	return h;
+}
+
+//Registers first, the cycle count last, so that lines can be compared
+//without it.
+static void TraceLine(FILE *f, const char *what)
+{
+	fprintf(f, "%-14s  A:%02X X:%02X Y:%02X S:%02X P:%02X  RAM:%08X  CYC:%llu\n", what,
+		X.A, X.X, X.Y, X.S, X.P, CalcCRC32(0, RAM, 0x800), (unsigned long long)(timestampbase + timestamp));
+}
+
+//Called by DebugCycle before each instruction runs.
+void DesyncTraceInstruction(uint8 *opcode, int size)
+{
+	char what[16];
+
+	//illegal instructions have a size of 0 but may have operands
+	switch(size) {
+		case 1: snprintf(what, sizeof(what), "%04X  %02X", X.PC, opcode[0]); break;
+		case 2: snprintf(what, sizeof(what), "%04X  %02X %02X", X.PC, opcode[0], opcode[1]); break;
+		default: snprintf(what, sizeof(what), "%04X  %02X %02X %02X", X.PC, opcode[0], opcode[1], opcode[2]); break;
+	}
+	TraceLine(traceFile, what);
+}
+
+//Loads the game and the movie, read-only, from power-on.
+static bool StartMovie(const char *path, const char *fn, int ramInit)
+{
+	if(!FCEUI_LoadGame(path, 1, true))
+		return false;
+	if(!FCEUI_LoadMovie(fn, true, 0) || !FCEUMOV_IsPlaying()) {
+		FCEUI_CloseGame();
+		return false;
+	}
+	//The movie has its own setting, which has to be overridden to compare them.
+	if(ramInit >= 0 && currMovieData.savestate.empty()) {
+		RAMInitOption = ramInit;
+		poweron(true);
+		currFrameCounter = 0;
+	}
+	return true;
+}
+
+static void StopMovie()
+{
+	FCEUI_StopMovie();
+	FCEUI_CloseGame();
+}
+
+//  FCEUX desync 1
+//  frame cpu-hash cycle-hash
+bool FCEUI_DesyncRun(const char *path, const char *fn, int ramInit, int interval, const char *out)
+{
+	std::string statesName = std::string(out) + ".states";
+	uint8 *gfx;
+	int32 *sound;
+	int32 ssize;
+	bool ok = true;
+
+	if(!StartMovie(path, fn, ramInit))
+		return false;
+
+	FILE *f = FCEUD_UTF8fopen(out, "wb");
+	EMUFILE_FILE states(statesName, "wb");
+
+	if(!f || !states.is_open()) {
+		if(f)
+			fclose(f);
+		StopMovie();
+		return false;
+	}
+
+	fprintf(f, "FCEUX desync 1\n");
+	while(currFrameCounter < (int)currMovieData.records.size()) {
+		int frame = currFrameCounter;
+
+		//  frame size state
+		if(interval > 0 && !(frame % interval)) {
+			std::vector<uint8> state;
+
+			if(FCEUMOV_SaveStateInMovie(state)) {
+				states.write32le((uint32)frame);
+				states.write32le((uint32)state.size());
+				states.fwrite(&state[0], state.size());
+			}
+		}
+
+		FCEUI_Emulate(&gfx, &sound, &ssize, 0);
+		fprintf(f, "%d\t%016llX\t%016llX\n", frame,
+			(unsigned long long)HashChunk(1469598103934665603ULL, SFCPU),
+			(unsigned long long)HashChunk(1469598103934665603ULL, SFCPUC));
+	}
+
+	ok = !states.fail();
+	if(fclose(f))
+		ok = false;
+	StopMovie();
+	return ok;
+}
+
+static bool LoadHashes(const char *fn, std::vector<uint64> &cpu, std::vector<uint64> &cycles)
+{
+	char line[256];
+	FILE *f = FCEUD_UTF8fopen(fn, "rb");
+
+	if(!f)
+		return false;
+	if(!fgets(line, sizeof(line), f) || strncmp(line, "FCEUX desync 1", 14)) {
+		fclose(f);
+		return false;
+	}
+
+	while(fgets(line, sizeof(line), f)) {
+		unsigned long long a, b;
+		int frame;
+
+		if(sscanf(line, "%d\t%llx\t%llx", &frame, &a, &b) != 3 || frame != (int)cpu.size())
+			break;
+		cpu.push_back(a);
+		cycles.push_back(b);
+	}
+	fclose(f);
+	return true;
+}
+
+bool FCEUI_DesyncCompare(const char *a, const char *b, int &frame, int &cycleFrame)
+{
+	std::vector<uint64> cpuA, cyclesA, cpuB, cyclesB;
+
+	frame = cycleFrame = -1;
+	if(!LoadHashes(a, cpuA, cyclesA) || !LoadHashes(b, cpuB, cyclesB))
+		return false;
+
+	size_t n = std::min(cpuA.size(), cpuB.size());
+
+	for(size_t i = 0; i < n && frame < 0; i++) {
+		if(cycleFrame < 0 && cyclesA[i] != cyclesB[i])
+			cycleFrame = (int)i;
+		if(cpuA[i] != cpuB[i])
+			frame = (int)i;
+	}
+	//one of them stopped early, which is a difference too
+	if(frame < 0 && cpuA.size() != cpuB.size())
+		frame = (int)n;
+	return true;
+}
+
+bool FCEUI_DesyncTrace(const char *path, const char *fn, int ramInit, const char *out, int frame)
+{
+	std::string statesName = std::string(out) + ".states";
+	std::string traceName = std::string(out) + ".trace";
+	std::vector<uint8> state, best;
+	uint8 *gfx;
+	int32 *sound;
+	int32 ssize;
+	bool ok;
+
+	if(!StartMovie(path, fn, ramInit))
+		return false;
+	if(frame < 0 || frame >= (int)currMovieData.records.size()) {
+		StopMovie();
+		return false;
+	}
+
+	//the last state FCEUI_DesyncRun saved at or before frame
+	{
+		EMUFILE_FILE states(statesName, "rb");
+		uint32 at, size;
+
+		while(states.is_open() && states.read32le(&at) && states.read32le(&size) && (int)at <= frame) {
+			state.resize(size);
+			if(size && states.fread(&state[0], size) != size)
+				break;
+			best.swap(state);
+		}
+	}
+	if(best.size() && !FCEUMOV_LoadStateInMovie(best)) {
+		StopMovie();
+		return false;
+	}
+
+	while(currFrameCounter < frame)
+		FCEUI_Emulate(&gfx, &sound, &ssize, 0);
+
+	if(!(traceFile = FCEUD_UTF8fopen(traceName.c_str(), "wb"))) {
+		StopMovie();
+		return false;
+	}
+	TraceLine(traceFile, "start");
+	debug_tracingDesync = true;
+	FCEUI_Emulate(&gfx, &sound, &ssize, 0);
+	debug_tracingDesync = false;
+	TraceLine(traceFile, "end");
+
+	ok = fclose(traceFile) == 0;
+	traceFile = NULL;
+	StopMovie();
+	return ok;
+}
+
+static bool LoadTrace(const char *fn, std::vector<std::string> &lines)
+{
+	char line[256];
+	FILE *f = FCEUD_UTF8fopen(fn, "rb");
+
+	if(!f)
+		return false;
+	while(fgets(line, sizeof(line), f)) {
+		line[strcspn(line, "\r\n")] = 0;
+		lines.push_back(line);
+	}
+	fclose(f);
+	return true;
+}
+
+//A trace line up to the cycle count.
+static std::string WithoutCycles(const std::string &line)
+{
+	size_t at = line.rfind("  CYC:");
+	return (at == std::string::npos) ? line : line.substr(0, at);
+}
+
+bool FCEUI_DesyncReport(const char *a, const char *b, int frame, int cycleFrame, std::string &report)
+{
+	std::vector<std::string> traceA, traceB;
+	char msg[256];
+	size_t i, n;
+
+	if(!LoadTrace((std::string(a) + ".trace").c_str(), traceA) || !LoadTrace((std::string(b) + ".trace").c_str(), traceB))
+		return false;
+
+	snprintf(msg, sizeof(msg), "The CPU state first differs after frame %d.\n", frame);
+	report = msg;
+	if(cycleFrame >= 0 && cycleFrame < frame) {
+		snprintf(msg, sizeof(msg), "The cycle counts already differ after frame %d.\n", cycleFrame);
+		report += msg;
+	}
+
+	n = std::min(traceA.size(), traceB.size());
+	for(i = 0; i < n; i++)
+		if(WithoutCycles(traceA[i]) != WithoutCycles(traceB[i]))
+			break;
+
+	if(i == n && traceA.size() == traceB.size()) {
+		report += "Every instruction of the frame agrees, so the difference is in state\nthe trace doesn't show.\n";
+		return true;
+	}
+	if(i == 0)
+		snprintf(msg, sizeof(msg), "The runs already differ at the start of frame %d.\n", frame);
+	else if(i == n)
+		snprintf(msg, sizeof(msg), "Frame %d runs %d instructions in %s and %d in %s.\n", frame, (int)traceA.size() - 2, a, (int)traceB.size() - 2, b);
+	else
+		snprintf(msg, sizeof(msg), "Instruction %d of frame %d is the first to differ.\n", (int)i, frame);
+	report += msg;
+
+	size_t from = (i > DESYNC_CONTEXT) ? i - DESYNC_CONTEXT : 0;
+	const std::vector<std::string> *traces[2] = { &traceA, &traceB };
+	const char *names[2] = { a, b };
+
+	for(int t = 0; t < 2; t++) {
+		const std::vector<std::string> &trace = *traces[t];
+
+		report += std::string("\n") + names[t] + ":\n";
+		for(size_t j = from; j <= i && j < trace.size(); j++)
+			report += std::string(j == i ? "> " : "  ") + trace[j] + "\n";
+	}
+	return true;
+}
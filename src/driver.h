@@ -62,6 +62,45 @@ void FCEUD_NetworkClose(void);
 bool FCEUI_BeginWaveRecord(const char *fn);
 int FCEUI_EndWaveRecord(void);
 
+//Expansion sound chip (VRC6, VRC7, N163, MMC5, Sunsoft 5B, FDS) profiling.
+//Times cover the GameExpSound callbacks only.  Levels are the chip's share
+//of the final output, in 16 bit sample units.
+struct EXPSOUNDSTATS
+{
+	const char *name;       //NULL when the game has no expansion sound
+	uint32 frames;          //frames profiled since the last reset
+	double frameTime;       //microseconds spent in the chip, last frame
+	double totalTime;
+	double maxTime;
+	int32 frameSamples;     //samples rendered by the chip, last frame
+	uint64 totalSamples;
+	int32 framePeak;        //peak absolute level, last frame
+	int32 maxPeak;
+};
+
+//Returns the name of the game's expansion sound chip, or NULL if it has none.
+const char *FCEUI_GetExpSoundName(void);
+
+void FCEUI_SetExpSoundProfiling(bool enable);
+bool FCEUI_ExpSoundProfilingEnabled(void);
+//Returns false if there is no expansion chip to report on.
+bool FCEUI_GetExpSoundStats(EXPSOUNDSTATS *stats);
+void FCEUI_ResetExpSoundStats(void);
+
+//Records the expansion chip's contribution alone, at the sound rate.
+bool FCEUI_BeginExpSoundWaveRecord(const char *fn);
+bool FCEUI_ExpSoundWaveRecordRunning(void);
+int FCEUI_EndExpSoundWaveRecord(void);
+
+//Records each channel (square 1, square 2, triangle, noise, DMC and expansion
+//audio) on its own, as it would sound with the others muted.  Needs high
+//quality sound.  With split set, fn is used as the base name of one mono file
+//per channel (name-sq1.wav, ...), otherwise it is written as one six channel
+//WAV file, in that channel order.
+bool FCEUI_BeginStemRecord(const char *fn, bool split);
+bool FCEUI_StemRecordRunning(void);
+int FCEUI_EndStemRecord(void);
+
 void FCEUI_ResetNES(void);
 void FCEUI_PowerNES(void);
 
@@ -104,6 +143,116 @@ FCEUGI *FCEUI_LoadGame(const char *name, int OverwriteVidMode, bool silent = fal
 //name is the logical path to open; archiveFilename is the archive which contains name
 FCEUGI *FCEUI_LoadGameVirtual(const char *name, int OverwriteVidMode, bool silent = false);
 
+//One game in the ROM library index.  Hashes are the ones the loader uses
+//for its own database lookups.
+struct ROMLIBENTRY
+{
+	std::string path;       //file, or archive|member, as FCEUI_LoadGame takes it
+	uint64 fileSize;        //size and modification time of the file on disk,
+	int64 fileTime;         //the archive for archive members
+	std::string format;     //"iNES", "NES 2.0", "UNIF", "FDS" or "NSF"
+	int mapper;             //iNES mapper number, -1 for other formats
+	int submapper;
+	std::string board;      //mapper or UNIF board name
+	int region;             //0 NTSC, 1 PAL, 2 both, 3 Dendy
+	uint32 prgSize;         //bytes
+	uint32 chrSize;
+	bool battery;
+	uint32 crc32;
+	uint8 md5[16];
+};
+
+//Scans dir and everything below it for games, including inside zip files,
+//using the given number of threads (0 for one per CPU).  The results replace
+//the library index in the base directory.  Files that haven't changed since
+//the last scan are not read again.  progress, if given, is called now and
+//then from the calling thread.  Returns the number of games found, or -1
+//if the index could not be written.
+int FCEUI_ScanRomLibrary(const char *dir, int threads, void (*progress)(int done, int total));
+
+//The library index as last scanned, loaded on first use.
+const std::vector<ROMLIBENTRY> &FCEUI_GetRomLibrary(void);
+
+//Games whose path contains text (ignoring case), or whose CRC32 or MD5 is
+//text in hex.  Returns the number of matches.
+int FCEUI_FindInRomLibrary(const char *text, std::vector<const ROMLIBENTRY *> &matches);
+
+//One game's run from FCEUI_Benchmark.
+struct BENCHMARKRESULT
+{
+	std::string path;
+	bool loaded;                 //false if the game could not be loaded
+	int frames;
+	double seconds;              //wall time spent emulating
+	uint64 cycles;               //CPU cycles emulated
+	uint64 instructions;         //CPU instructions executed
+	std::vector<uint32> hashes;  //CRC32 of RAM and the frame, every interval frames
+};
+
+//Runs the game at path, or every game the ROM library finds under path if
+//it is a directory, for the given number of frames with a fixed input
+//sequence and no throttling.  cheats adds that many do-nothing compare codes
+//over PRG, to time the cheat read path.  progress, if given, is called after
+//each game.  Returns the number of games run, or -1 if path does not exist.
+int FCEUI_Benchmark(const char *path, int frames, int interval, int cheats, std::vector<BENCHMARKRESULT> &results, void (*progress)(const BENCHMARKRESULT &r));
+
+#ifdef FCEU_THREADED_CPU
+//Plays the same games and input as FCEUI_Benchmark on both CPU cores,
+//comparing the registers, RAM and cycle count before every instruction and
+//the whole state after every frame.  Appends the instruction or frame where
+//each game's cores first differ, or that it couldn't be loaded, to report.
+//Returns the number of such games, or -1 if path does not exist.
+int FCEUI_BenchmarkCompareCores(const char *path, int frames, std::string &report);
+#endif
+
+//Times loading the movie fn repeats times, then plays it on the game at path
+//for the given number of frames and times loading a savestate taken there,
+//read-only, repeats times.  Returns false if the game or movie can't be loaded.
+bool FCEUI_BenchmarkMovie(const char *path, const char *fn, int frames, int repeats, double &loadSeconds, double &stateSeconds);
+
+//Writes results as a baseline for later runs to compare against.
+bool FCEUI_SaveBenchmarkBaseline(const char *fn, const std::vector<BENCHMARKRESULT> &results);
+
+//Compares results with the baseline in fn, appending a line to report for
+//every game whose hashes differ or which ran more than tolerance (0.1 for
+//10%) slower.  Returns the number of such games, or -1 if fn can't be read.
+int FCEUI_CompareBenchmarkBaseline(const char *fn, const std::vector<BENCHMARKRESULT> &results, double tolerance, std::string &report);
+
+//Writes a synthetic test ROM for every iNES mapper to dir.  Each one pokes
+//random values at the mapper registers with rendering on.  Returns the number
+//of ROMs written, or -1 on error.
+int FCEUI_GenerateBenchmarkROMs(const char *dir);
+
+//Checks the VRC7 sound chip's block synthesis against its per-sample output
+//over seeds random register write sequences of samples samples each.
+//Appends the first difference of each failing sequence to report and returns
+//the number of such sequences.
+int FCEUI_BenchmarkCheckOPLL(int seeds, int samples, std::string &report);
+
+//Plays movie fn read-only on the game at path, from power-on to its end,
+//writing hashes of the CPU state and of its cycle counts after every frame
+//to out and a savestate to out.states every interval frames.  ramInit, if
+//not -1, replaces the movie's RAM initialization.  Run once for each of two
+//configurations, then FCEUI_DesyncCompare finds the frame where they part,
+//FCEUI_DesyncTrace traces it in each and FCEUI_DesyncReport finds the first
+//instruction that differs.  Returns false if something can't be loaded or written.
+bool FCEUI_DesyncRun(const char *path, const char *fn, int ramInit, int interval, const char *out);
+
+//The first frame after which the CPU state in two FCEUI_DesyncRun outputs
+//differs, and the first after which the cycle counts do, each -1 if they
+//never do.  Returns false if either output can't be read.
+bool FCEUI_DesyncCompare(const char *a, const char *b, int &frame, int &cycleFrame);
+
+//Plays the movie as FCEUI_DesyncRun did from its nearest savestate up to
+//frame, then writes the registers and a RAM hash before every instruction of
+//the frame to out.trace.
+bool FCEUI_DesyncTrace(const char *path, const char *fn, int ramInit, const char *out, int frame);
+
+//Compares the traces of frame from the runs written to a and b and reports
+//the first instruction that differs, ignoring cycle counts, with the ones
+//before it.  Returns false if either trace can't be read.
+bool FCEUI_DesyncReport(const char *a, const char *b, int frame, int cycleFrame, std::string &report);
+
 //general purpose emulator initialization. returns true if successful
 bool FCEUI_Initialize();
 
@@ -119,6 +268,18 @@ void FCEUI_Kill(void);
 //Enable/Disable game genie. a=true->enabled
 void FCEUI_SetGameGenie(bool a);
 
+//Run uncompressed, unpatched iNES images from a copy-on-write mapping of
+//the ROM file instead of a private copy, so processes running the same ROM
+//share its memory.  Takes effect on the next game load.  The file must not
+//be rewritten by other programs while it is loaded.
+void FCEUI_SetShareROMs(bool a);
+
+//Skip ahead through loops that wait on RAM or $2002 without changing
+//anything, such as BIT $2002 / BPL.  The results are the same as running
+//them.  Anything that watches every instruction turns it off: breakpoints,
+//code/data logging, the trace logger and Lua exec hooks.
+void FCEUI_SetIdleSkip(bool a);
+
 //Set video system a=0 NTSC, a=1 PAL
 void FCEUI_SetVidSystem(int a);
 
@@ -241,6 +402,8 @@ void FCEUI_SetLowPass(int q);
 
 void FCEUI_NSFSetVis(int mode);
 int FCEUI_NSFChange(int amount);
+int FCEUI_NSFSetSong(int song);
+bool FCEUI_NSFRender(int song, double seconds);
 int FCEUI_NSFGetInfo(uint8 *name, uint8 *artist, uint8 *copyright, int maxlen);
 
 void FCEUI_VSUniToggleDIPView(void);
@@ -324,6 +487,9 @@ void FCEUD_DebugBreakpoint(int bp_num);
 ///the driver should log the current instruction, if it wants (we should move the code in the win driver that does this to the shared area)
 void FCEUD_TraceInstruction(uint8 *opcode, int size);
 
+///whether the driver's trace logger is logging, so the core doesn't skip instructions it would see
+int FCEUD_TraceLoggerRunning(void);
+
 ///the driver might should update its NTView (only used if debugging support is compiled in)
 void FCEUD_UpdateNTView(int scanline, bool drawall);
 
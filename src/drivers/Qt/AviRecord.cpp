@@ -64,6 +64,7 @@ extern "C"
 #include "Qt/AviRecord.h"
 #include "Qt/avi/gwavi.h"
 #include "Qt/nes_shm.h"
+#include "Qt/dface.h"
 #include "Qt/throttle.h"
 #include "Qt/ConsoleWindow.h"
 #include "Qt/ConsoleUtilities.h"
@@ -1955,6 +1956,8 @@ int aviRecordInit(void)
 	g_config->getOption("SDL.AviRecordAudio", &recordAudio);
 	g_config->getOption("SDL.Sound.Rate", &audioSampleRate);
 
+	audioSampleRate = GetNativeSoundRate( audioSampleRate );
+
 #ifdef _USE_LIBAV
 	// LIBAV has its own internal video format configs,
 	// it does not use this videoFormat symbol.
@@ -2099,7 +2102,8 @@ int aviRecordOpenFile( const char *filepath )
 	}
 	fps = getBaseFrameRate();
 
-	g_config->getOption("SDL.Sound.Rate", &audioSampleRate);
+	// Audio frames are captured before resampling to the device rate.
+	audioSampleRate = GetEmuSoundRate();
 
 	audioConfig.channels = 1;
 	audioConfig.bits     = 16;
@@ -151,12 +151,14 @@ CodeDataLoggerDialog_t::CodeDataLoggerDialog_t(QWidget *parent)
 	grid = new QGridLayout();
 	statLabel = new QLabel(tr(" Logger is Paused: Press Start to Run "));
 	cdlFileLabel = new QLabel(tr("CDL File:"));
+	overheadLabel = new QLabel(tr("Logging Overhead: ------"));
 
 	mainLayout->setMenuBar( menuBar );
 
 	vbox1->addLayout(grid);
 	vbox1->addLayout(hbox);
 	vbox1->addWidget(cdlFileLabel);
+	vbox1->addWidget(overheadLabel);
 
 	hbox->addWidget(statLabel, 0, Qt::AlignHCenter);
 
@@ -276,6 +278,10 @@ CodeDataLoggerDialog_t::CodeDataLoggerDialog_t(QWidget *parent)
 
 	setLayout(mainLayout);
 
+	overheadLastNs = cdlLoggingNs.load();
+	overheadLastInstructions = cdlInstructions.load();
+	overheadTimer.start();
+
 	updateTimer->start(200); // 5hz
 
 	if (autoLoadCDL)
@@ -393,6 +399,25 @@ void CodeDataLoggerDialog_t::updatePeriodic(void)
 	sprintf(str, "CDL File: %s", loadedcdfile);
 
 	cdlFileLabel->setText(tr(str));
+
+	// The logger's share of the time since the last update
+	uint64_t loggingNs = cdlLoggingNs.load();
+	uint64_t instructions = cdlInstructions.load();
+	qint64 elapsedNs = overheadTimer.restart() * 1000000;
+
+	if ( FCEUI_GetLoggingCD() && (instructions > overheadLastInstructions) && (elapsedNs > 0) )
+	{
+		sprintf(str, "Logging Overhead: %.1f%% of the time, %.0f ns per instruction",
+				(100.0 * (loggingNs - overheadLastNs)) / elapsedNs,
+				(double)(loggingNs - overheadLastNs) / (instructions - overheadLastInstructions) );
+		overheadLabel->setText(tr(str));
+	}
+	else
+	{
+		overheadLabel->setText(tr("Logging Overhead: ------"));
+	}
+	overheadLastNs = loggingNs;
+	overheadLastInstructions = instructions;
 }
 //----------------------------------------------------
 void CodeDataLoggerDialog_t::ResetCDLogClicked(void)
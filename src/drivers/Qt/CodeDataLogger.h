@@ -13,6 +13,7 @@
 #include <QLabel>
 #include <QFrame>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QGroupBox>
 #include <QCloseEvent>
 
@@ -34,6 +35,10 @@ protected:
 	QLabel *chrUnloggedLabel;
 	QLabel *cdlFileLabel;
 	QLabel *statLabel;
+	QLabel *overheadLabel;
+	QElapsedTimer overheadTimer;
+	uint64_t overheadLastNs;
+	uint64_t overheadLastInstructions;
 	QCheckBox *autoSaveCdlCbox;
 	QCheckBox *autoLoadCdlCbox;
 	QCheckBox *autoResumeLogCbox;
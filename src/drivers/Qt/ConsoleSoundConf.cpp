@@ -158,6 +158,29 @@ ConsoleSndConfDialog_t::ConsoleSndConfDialog_t(QWidget *parent)
 
 	connect(swapDutyChkbox, SIGNAL(stateChanged(int)), this, SLOT(swapDutyCallback(int)));
 
+	// Expansion Sound Chip Profiling
+	frame = new QGroupBox(tr("Expansion Chip:"));
+	vbox2 = new QVBoxLayout();
+
+	expProfChkbox = new QCheckBox(tr("Profile"));
+	expProfChkbox->setToolTip( tr("Measure time spent and output level of the expansion sound chip, per frame.") );
+	expProfChkbox->setChecked( FCEUI_ExpSoundProfilingEnabled() );
+	vbox2->addWidget(expProfChkbox);
+
+	expRecChkbox = new QCheckBox(tr("Record to Separate WAV"));
+	expRecChkbox->setToolTip( tr("When recording a WAV file, also record the expansion sound chip alone to <name>-<chip>.wav") );
+	setCheckBoxFromProperty(expRecChkbox, "SDL.Sound.RecordExpSound");
+	vbox2->addWidget(expRecChkbox);
+
+	expStatsLbl = new QLabel();
+	vbox2->addWidget(expStatsLbl);
+
+	frame->setLayout(vbox2);
+	vbox1->addWidget(frame);
+
+	connect(expProfChkbox, SIGNAL(stateChanged(int)), this, SLOT(expSoundProfChanged(int)));
+	connect(expRecChkbox , SIGNAL(stateChanged(int)), this, SLOT(expSoundRecChanged(int)));
+
 	hbox1->addLayout(vbox1);
 
 	frame = new QGroupBox(tr("Mixer:"));
@@ -309,7 +332,11 @@ void ConsoleSndConfDialog_t::closeWindow(void)
 //----------------------------------------------------
 void ConsoleSndConfDialog_t::resetCounters(void)
 {
-	nes_shm->sndBuf.starveCounter = 0;
+	ResetSoundBufferCounters();
+
+	fceuWrapperLock();
+	FCEUI_ResetExpSoundStats();
+	fceuWrapperUnLock();
 
 	periodicUpdate();
 }
@@ -318,7 +345,8 @@ void ConsoleSndConfDialog_t::periodicUpdate(void)
 {
 	uint32_t c, m;
 	double percBufUse;
-	char stmp[64];
+	char stmp[256];
+	EXPSOUNDSTATS expStats;
 
 	c = GetWriteSound();
 	m = GetMaxSound();
@@ -330,6 +358,25 @@ void ConsoleSndConfDialog_t::periodicUpdate(void)
 	sprintf( stmp, "Sink Starve Count: %u", nes_shm->sndBuf.starveCounter );
 
 	starveLbl->setText( tr(stmp) );
+
+	if ( !FCEUI_ExpSoundProfilingEnabled() )
+	{
+		expStatsLbl->setText( tr("") );
+	}
+	else if ( !FCEUI_GetExpSoundStats( &expStats ) )
+	{
+		expStatsLbl->setText( tr("No Expansion Chip") );
+	}
+	else
+	{
+		sprintf( stmp, "%s\nTime: %.1f us/frame (max %.1f)\nSamples: %i/frame\nPeak: %i (max %i)",
+				expStats.name,
+				expStats.frames ? expStats.totalTime / expStats.frames : 0.0,
+				expStats.maxTime, expStats.frameSamples,
+				expStats.framePeak, expStats.maxPeak );
+
+		expStatsLbl->setText( tr(stmp) );
+	}
 }
 //----------------------------------------------------
 void ConsoleSndConfDialog_t::setSliderEnables(void)
@@ -571,6 +618,21 @@ void ConsoleSndConfDialog_t::useGlobalFocusChanged(int value)
 	}
 }
 //----------------------------------------------------
+void ConsoleSndConfDialog_t::expSoundProfChanged(int value)
+{
+	fceuWrapperLock();
+	FCEUI_SetExpSoundProfiling( value != Qt::Unchecked );
+	fceuWrapperUnLock();
+
+	periodicUpdate();
+}
+//----------------------------------------------------
+void ConsoleSndConfDialog_t::expSoundRecChanged(int value)
+{
+	g_config->setOption("SDL.Sound.RecordExpSound", value != Qt::Unchecked);
+	g_config->save();
+}
+//----------------------------------------------------
 void ConsoleSndConfDialog_t::swapDutyCallback(int value)
 {
 	if (value)
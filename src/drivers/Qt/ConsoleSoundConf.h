@@ -34,6 +34,8 @@ protected:
 	QCheckBox *enaLowPass;
 	QCheckBox *swapDutyChkbox;
 	QCheckBox *useGlobalFocus;
+	QCheckBox *expProfChkbox;
+	QCheckBox *expRecChkbox;
 	QComboBox *qualitySelect;
 	QComboBox *rateSelect;
 	QSlider *bufSizeSlider;
@@ -45,6 +47,7 @@ protected:
 	QLabel *nseLbl;
 	QLabel *pcmLbl;
 	QLabel *starveLbl;
+	QLabel *expStatsLbl;
 	QSlider *sqr2Slider;
 	QSlider *nseSlider;
 	QSlider *pcmSlider;
@@ -71,6 +74,8 @@ private slots:
 	void enaSoundLowPassChange(int value);
 	void swapDutyCallback(int value);
 	void useGlobalFocusChanged(int value);
+	void expSoundProfChanged(int value);
+	void expSoundRecChanged(int value);
 	void soundQualityChanged(int index);
 	void soundRateChanged(int index);
 };
@@ -1705,6 +1705,13 @@ void consoleWin_t::createMainMenu(void)
 
 	movieMenu->addAction(playMovBeginAct);
 
+	// Movie -> Seek to Frame
+	seekMovAct = new QAction(tr("Seek to &Frame..."), this);
+	seekMovAct->setStatusTip(tr("Play Movie up to a Frame"));
+	connect(seekMovAct, SIGNAL(triggered()), this, SLOT(seekMovie(void)) );
+
+	movieMenu->addAction(seekMovAct);
+
 	// Movie -> Stop
 	stopMovAct = new QAction(tr("&Stop"), this);
 	//stopMovAct->setShortcut( QKeySequence(tr("Shift+F7")));
@@ -3586,6 +3593,33 @@ void consoleWin_t::playMovieFromBeginning(void)
 	fceuWrapperUnLock();
 }
 
+void consoleWin_t::seekMovie(void)
+{
+	int ret;
+	QInputDialog dialog(this);
+
+	fceuWrapperLock();
+	int length = FCEUI_GetMovieLength();
+	int frame  = FCEUMOV_GetFrame();
+	fceuWrapperUnLock();
+
+	dialog.setWindowTitle( tr("Seek to Frame") );
+	dialog.setLabelText( tr("Play the movie read-only up to frame:") );
+	dialog.setOkButtonText( tr("Seek") );
+	dialog.setInputMode( QInputDialog::IntInput );
+	dialog.setIntRange( 0, length );
+	dialog.setIntValue( frame );
+
+	ret = dialog.exec();
+
+	if ( QDialog::Accepted == ret )
+	{
+		fceuWrapperLock();
+		FCEUI_MovieSeek( dialog.intValue() );
+		fceuWrapperUnLock();
+	}
+}
+
 void consoleWin_t::stopMovie(void)
 {
 	fceuWrapperLock();
@@ -3820,6 +3854,38 @@ void consoleWin_t::aviVideoFormatChanged(int idx)
 	aviSetSelVideoFormat(idx);
 }
 
+// Optionally record the expansion sound chip alone next to the main WAV
+// file, as <name>-<chip>.wav.
+static void expSoundRecordStart( const char *wavPath )
+{
+	int recExpSound = 0;
+	const char *chip;
+	std::string fileName;
+	size_t dot;
+
+	g_config->getOption("SDL.Sound.RecordExpSound", &recExpSound);
+
+	chip = FCEUI_GetExpSoundName();
+
+	if ( !recExpSound || (chip == NULL) )
+	{
+		return;
+	}
+	fileName = wavPath;
+
+	dot = fileName.find_last_of('.');
+
+	if ( (dot != std::string::npos) && (fileName.find_first_of("/\\", dot) == std::string::npos) )
+	{
+		fileName.erase( dot );
+	}
+	fileName += "-";
+	fileName += chip;
+	fileName += ".wav";
+
+	FCEUI_BeginExpSoundWaveRecord( fileName.c_str() );
+}
+
 void consoleWin_t::wavRecordStart(void)
 {
 	if ( !FCEUI_WaveRecordRunning() )
@@ -3862,7 +3928,10 @@ void consoleWin_t::wavRecordStart(void)
 			return;
 		}
 		fceuWrapperLock();
-		FCEUI_BeginWaveRecord( fileName );
+		if ( FCEUI_BeginWaveRecord( fileName ) )
+		{
+			expSoundRecordStart( fileName );
+		}
 		fceuWrapperUnLock();
 	}
 }
@@ -3952,7 +4021,10 @@ void consoleWin_t::wavRecordAsStart(void)
 	}
 
 	fceuWrapperLock();
-	FCEUI_BeginWaveRecord( filename.toStdString().c_str() );
+	if ( FCEUI_BeginWaveRecord( filename.toStdString().c_str() ) )
+	{
+		expSoundRecordStart( filename.toStdString().c_str() );
+	}
 	fceuWrapperUnLock();
 }
 
@@ -3962,6 +4034,7 @@ void consoleWin_t::wavRecordStop(void)
 	{
 		fceuWrapperLock();
 		FCEUI_EndWaveRecord();
+		FCEUI_EndExpSoundWaveRecord();
 		fceuWrapperUnLock();
 	}
 }
@@ -4245,6 +4318,7 @@ void consoleWin_t::updatePeriodic(void)
 		resetAct->setEnabled( FCEU_IsValidUI( FCEUI_RESET ) );
 		sresetAct->setEnabled( FCEU_IsValidUI( FCEUI_RESET ) );
 		playMovBeginAct->setEnabled( FCEU_IsValidUI( FCEUI_PLAYFROMBEGINNING ) );
+		seekMovAct->setEnabled( FCEU_IsValidUI( FCEUI_STOPMOVIE ) );
 		insCoinAct->setEnabled( FCEU_IsValidUI( FCEUI_INSERT_COIN ) );
 		fdsSwitchAct->setEnabled( FCEU_IsValidUI( FCEUI_SWITCH_DISK ) );
 		fdsEjectAct->setEnabled( FCEU_IsValidUI( FCEUI_EJECT_DISK ) );
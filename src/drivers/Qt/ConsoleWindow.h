@@ -237,6 +237,7 @@ class  consoleWin_t : public QMainWindow
 		QAction *iNesEditAct;
 		QAction *openMovAct;
 		QAction *playMovBeginAct;
+		QAction *seekMovAct;
 		QAction *stopMovAct;
 		QAction *recMovAct;
 		QAction *region[3];
@@ -391,6 +392,7 @@ class  consoleWin_t : public QMainWindow
 		void openMovie(void);
 		void stopMovie(void);
 		void playMovieFromBeginning(void);
+		void seekMovie(void);
 		void setCustomAutoFire(void);
 		void incrSoundVolume(void);
 		void decrSoundVolume(void);
@@ -89,6 +89,9 @@ FrameTimingDialog_t::FrameTimingDialog_t(QWidget *parent)
 	frameTimeIdlePct = new QTreeWidgetItem();
 	frameLateCount = new QTreeWidgetItem();
 	videoTimeAbs = new QTreeWidgetItem();
+	audioBufFill = new QTreeWidgetItem();
+	audioStarveCount = new QTreeWidgetItem();
+	audioOverrunCount = new QTreeWidgetItem();
 
 	tree->addTopLevelItem(frameTimeAbs);
 	tree->addTopLevelItem(frameTimeDel);
@@ -98,6 +101,9 @@ FrameTimingDialog_t::FrameTimingDialog_t(QWidget *parent)
 	tree->addTopLevelItem(frameTimeIdlePct);
 	tree->addTopLevelItem(videoTimeAbs);
 	tree->addTopLevelItem(frameLateCount);
+	tree->addTopLevelItem(audioBufFill);
+	tree->addTopLevelItem(audioStarveCount);
+	tree->addTopLevelItem(audioOverrunCount);
 
 	frameTimeAbs->setFlags(Qt::ItemIsEnabled | Qt::ItemNeverHasChildren);
 	frameTimeDel->setFlags(Qt::ItemIsEnabled | Qt::ItemNeverHasChildren);
@@ -110,6 +116,9 @@ FrameTimingDialog_t::FrameTimingDialog_t(QWidget *parent)
 	frameTimeIdlePct->setText(0, tr("Frame Idle %"));
 	frameLateCount->setText(0, tr("Frame Late Count"));
 	videoTimeAbs->setText(0, tr("Video Period ms"));
+	audioBufFill->setText(0, tr("Audio Buffer Fill %"));
+	audioStarveCount->setText(0, tr("Audio Starve Count"));
+	audioOverrunCount->setText(0, tr("Audio Overrun Count"));
 
 	frameTimeAbs->setTextAlignment(0, Qt::AlignLeft);
 	frameTimeDel->setTextAlignment(0, Qt::AlignLeft);
@@ -119,6 +128,9 @@ FrameTimingDialog_t::FrameTimingDialog_t(QWidget *parent)
 	frameTimeIdlePct->setTextAlignment(0, Qt::AlignLeft);
 	frameLateCount->setTextAlignment(0, Qt::AlignLeft);
 	videoTimeAbs->setTextAlignment(0, Qt::AlignLeft);
+	audioBufFill->setTextAlignment(0, Qt::AlignLeft);
+	audioStarveCount->setTextAlignment(0, Qt::AlignLeft);
+	audioOverrunCount->setTextAlignment(0, Qt::AlignLeft);
 
 	for (int i = 0; i < 4; i++)
 	{
@@ -130,6 +142,9 @@ FrameTimingDialog_t::FrameTimingDialog_t(QWidget *parent)
 		frameTimeIdlePct->setTextAlignment(i + 1, Qt::AlignCenter);
 		frameLateCount->setTextAlignment(i + 1, Qt::AlignCenter);
 		videoTimeAbs->setTextAlignment(i + 1, Qt::AlignCenter);
+		audioBufFill->setTextAlignment(i + 1, Qt::AlignCenter);
+		audioStarveCount->setTextAlignment(i + 1, Qt::AlignCenter);
+		audioOverrunCount->setTextAlignment(i + 1, Qt::AlignCenter);
 	}
 
 	hbox = new QHBoxLayout();
@@ -299,6 +314,19 @@ void FrameTimingDialog_t::updateTimingStats(void)
 	frameLateCount->setText(1, tr("0"));
 	frameLateCount->setText(2, tr(stmp));
 
+	// Audio Buffer
+	sprintf(stmp, "%.1f", 100.0 * stats.audio.bufFill);
+	audioBufFill->setText(1, tr("50.0"));
+	audioBufFill->setText(2, tr(stmp));
+
+	sprintf(stmp, "%u", stats.audio.starveCount);
+	audioStarveCount->setText(1, tr("0"));
+	audioStarveCount->setText(2, tr(stmp));
+
+	sprintf(stmp, "%u", stats.audio.overrunCount);
+	audioOverrunCount->setText(1, tr("0"));
+	audioOverrunCount->setText(2, tr(stmp));
+
 	statFrame->setEnabled(stats.enabled);
 
 	tree->viewport()->update();
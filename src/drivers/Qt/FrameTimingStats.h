@@ -40,6 +40,9 @@ protected:
 	QTreeWidgetItem *frameTimeIdlePct;
 	QTreeWidgetItem *frameLateCount;
 	QTreeWidgetItem *videoTimeAbs;
+	QTreeWidgetItem *audioBufFill;
+	QTreeWidgetItem *audioStarveCount;
+	QTreeWidgetItem *audioOverrunCount;
 	QGroupBox *statFrame;
 
 	QTreeWidget *tree;
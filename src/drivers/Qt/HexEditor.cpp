@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <string>
+#include <algorithm>
 
 #include <SDL.h>
 #include <QHeaderView>
@@ -329,6 +330,7 @@ static int writeMem( int mode, unsigned int addr, int value )
 					wfunc ((uint32) addr,
 					       (uint8) (value & 0x000000ff));
 				}
+				debugDirtyCPU[addr >> 8] = 1;
 			}
 			else
 			{
@@ -351,12 +353,14 @@ static int writeMem( int mode, unsigned int addr, int value )
 			{
 				PalettePoke(addr, value);
 			}
+			debugDirtyPPU[addr >> 8] = 1;
 		}
 		break;
       case QHexEdit::MODE_NES_OAM:
 		{
 			addr &= 0xFF;
 			SPRAM[addr] = value;
+			debugDirtyOAM = 1;
 		}
 		break;
       case QHexEdit::MODE_NES_ROM:
@@ -373,6 +377,8 @@ static int writeMem( int mode, unsigned int addr, int value )
 			{
 				*(uint8 *)(GetNesCHRPointer(addr-16-PRGsize[0])) = value;
 			}
+			// wherever it is mapped
+			DebugMarkAllDirty();
 		}
 		break;
 	}
@@ -1810,11 +1816,11 @@ void HexEditorDialog_t::updatePeriodic(void)
 	
 	undoEditAct->setEnabled( romEditList.undoQueueSize() > 0 );
 
+	editor->memModeUpdate();
+
 	if ( fceuWrapperTryLock(0) )
 	{
-		memNeedsCheck = false;
-
-		editor->checkMemActivity();
+		hexEditorUpdateMemoryValues(true);
 
 		fceuWrapperUnLock();
 	}
@@ -1823,7 +1829,7 @@ void HexEditorDialog_t::updatePeriodic(void)
 		memNeedsCheck = true;
 	}
 
-	editor->memModeUpdate();
+	editor->takeMemActivity();
 
 	editor->update();
 
@@ -1957,6 +1963,11 @@ QHexEdit::QHexEdit(QWidget *parent)
 	total_instructions_lp = 0;
 	pxLineXScroll = 0;
 
+	stageMode  = -1;
+	stageAccessFunc = NULL;
+	stageFull  = true;
+	stageRan   = false;
+
 	frzRamAddr = -1;
 	frzRamVal = 0;
 	frzRamMode = 0;
@@ -3448,49 +3459,205 @@ void QHexEdit::requestUpdate(void)
 	updateRequested = true;
 }
 //----------------------------------------------------------------------------
+// Where a 256 byte page of the current view is read from, so that aliases
+// and bank switches can be told apart.  NULL for registers and anything read
+// through a handler, which can change without being written.
+const uint8_t *QHexEdit::pageSource( int page )
+{
+	unsigned int addr = page << 8;
+
+	switch ( stageMode )
+	{
+		case MODE_NES_RAM:
+			if ( addr < 0x2000 )
+			{
+				return RAM + (addr & 0x7FF);
+			}
+			if ( (addr >= 0x6000) && (GetReadHandler(addr) == CartBR) )
+			{
+				return Page[addr >> 11] + addr;
+			}
+			return NULL;
+		case MODE_NES_PPU:
+			if ( addr < 0x2000 )
+			{
+				return VPage[addr >> 10] + addr;
+			}
+			if ( addr < 0x3F00 )
+			{
+				return vnapage[(addr >> 10) & 0x3] + (addr & 0x300);
+			}
+			return PALRAM;
+		case MODE_NES_OAM:
+			return SPRAM;
+	}
+	return NULL;
+}
+//----------------------------------------------------------------------------
 // Calling of checkMemActivity must always be synchronized with the emulation
 // thread as calling GetMem while the emulation is executing can mess up certain
 // registers (especially controller registers $4016 and $4017)
-int QHexEdit::checkMemActivity(void)
+//
+// Only the pages written to, switched or aliased by a written page are copied,
+// plus pages of registers whenever the emulation has run.  The copy itself
+// stays under the emulator lock, which updatePeriodic takes with
+// fceuWrapperTryLock, because of those side effects.  Comparing and fading is
+// left to takeMemActivity, outside the lock, so the emulation is held up as
+// little as possible.
+int QHexEdit::checkMemActivity( const uint8_t *dirtyCPU, const uint8_t *dirtyPPU, bool dirtyOAM )
 {
-	int c;
+	std::vector <const uint8_t*> written;
+	const uint8_t *dirty;
+	bool ran;
+	int numPages;
 
-	// Don't perform memory activity checks when:
-	// 1. In ROM View Mode
-	// 2. The simulation is not cycling (paused)
+	ran = updateRequested || (total_instructions_lp != total_instructions);
 
-	if ( !updateRequested )
+	stageMutex.lock();
+
+	if ( (stageMode == MODE_NES_ROM) || (stageAccessFunc == NULL) )
+	{
+		stageMutex.unlock();
+		return -1;
+	}
+	numPages = (stage.size() + 255) / 256;
+
+	switch ( stageMode )
+	{
+		default:
+		case MODE_NES_RAM: dirty = dirtyCPU; break;
+		case MODE_NES_PPU: dirty = dirtyPPU; break;
+		case MODE_NES_OAM: dirty = NULL;     break;
+	}
+
+	// A write shows up wherever the same memory is mapped.
+	for (int p=0; p<numPages; p++)
 	{
-		if ( ( viewMode == MODE_NES_ROM ) ||
-		      ( total_instructions_lp == total_instructions ) )
+		const uint8_t *src = pageSource(p);
+
+		if ( src && (dirty ? dirty[p] : dirtyOAM) )
 		{
-			return -1;
+			written.push_back( src );
 		}
 	}
+	std::sort( written.begin(), written.end() );
 
-	for (int i=0; i<mb.size(); i++)
+	for (int p=0; p<numPages; p++)
 	{
-		c = memAccessFunc(i);
+		const uint8_t *src = pageSource(p);
+		bool copy = stageFull || (src != stageSrc[p]);
 
-		if ( c != mb.buf[i].data )
+		if ( src == NULL )
 		{
-			mb.buf[i].actv  = 15;
-			mb.buf[i].data  = c;
-			//mb.buf[i].draw  = 1;
+			copy = copy || ran;
 		}
-		else
+		else if ( !copy )
 		{
-			if ( mb.buf[i].actv > 0 )
+			copy = std::binary_search( written.begin(), written.end(), src );
+		}
+
+		if ( copy )
+		{
+			int end = (p+1)*256;
+
+			if ( end > (int)stage.size() )
+			{
+				end = stage.size();
+			}
+			for (int i=p*256; i<end; i++)
 			{
-				//mb.buf[i].draw = 1;
-				mb.buf[i].actv--;
+				stage[i] = stageAccessFunc(i);
 			}
+			stageDirty[p] = stageFull ? 2 : 1;
 		}
+		stageSrc[p] = src;
 	}
+	stageFull = false;
+	stageRan  = stageRan || ran;
+
+	stageMutex.unlock();
+
 	total_instructions_lp = total_instructions;
 	updateRequested = false;
 
-   return 0;
+	return 0;
+}
+//----------------------------------------------------------------------------
+// Merges the pages checkMemActivity copied into the view, highlighting the
+// bytes that changed and fading the ones that changed earlier.
+void QHexEdit::takeMemActivity(void)
+{
+	int numPages = pageActv.size();
+
+	stageMutex.lock();
+
+	if ( (stageMode != viewMode) || ((int)stage.size() != mb.size()) )
+	{
+		stageMutex.unlock();
+		return;
+	}
+
+	if ( stageRan )
+	{
+		for (int p=0; p<numPages; p++)
+		{
+			int end = (p+1)*256;
+
+			if ( !pageActv[p] )
+			{
+				continue;
+			}
+			if ( end > mb.size() )
+			{
+				end = mb.size();
+			}
+			pageActv[p] = 0;
+
+			for (int i=p*256; i<end; i++)
+			{
+				if ( mb.buf[i].actv > 0 )
+				{
+					//mb.buf[i].draw = 1;
+					if ( --mb.buf[i].actv > 0 )
+					{
+						pageActv[p] = 1;
+					}
+				}
+			}
+		}
+		stageRan = false;
+	}
+
+	for (int p=0; p<numPages; p++)
+	{
+		int end = (p+1)*256;
+
+		if ( !stageDirty[p] )
+		{
+			continue;
+		}
+		if ( end > mb.size() )
+		{
+			end = mb.size();
+		}
+		for (int i=p*256; i<end; i++)
+		{
+			if ( stage[i] != mb.buf[i].data )
+			{
+				mb.buf[i].data  = stage[i];
+
+				// a whole new view isn't activity
+				if ( stageDirty[p] == 1 )
+				{
+					mb.buf[i].actv = 15;
+					pageActv[p] = 1;
+				}
+				//mb.buf[i].draw  = 1;
+			}
+		}
+		stageDirty[p] = 0;
+	}
+	stageMutex.unlock();
 }
 //----------------------------------------------------------------------------
 int QHexEdit::getRomAddrColor( int addr, QColor &fg, QColor &bg )
@@ -3656,6 +3823,22 @@ void QHexEdit::memModeUpdate(void)
 		break;
 	}
 
+	stageMutex.lock();
+
+	if ( (stageMode != viewMode) || ((int)stage.size() != memSize) )
+	{
+		int numPages = (memSize + 255) / 256;
+
+		stageMode = viewMode;
+		stageAccessFunc = memAccessFunc;
+		stage.assign( memSize, 0 );
+		stageDirty.assign( numPages, 0 );
+		stageSrc.assign( numPages, NULL );
+		pageActv.assign( numPages, 0 );
+		stageFull = true;
+	}
+	stageMutex.unlock();
+
 	if ( memSize != mb.size() )
 	{
 		mb.setAccessFunc( memAccessFunc );
@@ -4110,15 +4293,25 @@ int hexEditorOpenFromDebugger( int mode, int addr )
 void hexEditorUpdateMemoryValues( bool force )
 {
 	std::list <HexEditorDialog_t*>::iterator it;
+	uint8_t dirtyCPU[0x100], dirtyPPU[0x40];
+	bool dirtyOAM;
 
 	if ( !memNeedsCheck && !force )
 	{
 		return;
 	}
 
+	// Every window sees the same writes, so take them once for all.
+	memcpy( dirtyCPU, debugDirtyCPU, sizeof(dirtyCPU) );
+	memcpy( dirtyPPU, debugDirtyPPU, sizeof(dirtyPPU) );
+	dirtyOAM = debugDirtyOAM ? true : false;
+	memset( debugDirtyCPU, 0, sizeof(debugDirtyCPU) );
+	memset( debugDirtyPPU, 0, sizeof(debugDirtyPPU) );
+	debugDirtyOAM = 0;
+
 	for (it = winList.begin(); it != winList.end(); it++)
 	{
-		(*it)->editor->checkMemActivity();
+		(*it)->editor->checkMemActivity( dirtyCPU, dirtyPPU, dirtyOAM );
 	}
 	memNeedsCheck = false;
 }
@@ -10,6 +10,7 @@
 #include <QDialog>
 #include <QColorDialog>
 #include <QTimer>
+#include <QMutex>
 #include <QAction>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -133,7 +134,8 @@ class QHexEdit : public QWidget
 		void setBackGroundColor( QColor bg );
 		void memModeUpdate(void);
 		void openGotoAddrDialog(void);
-		int  checkMemActivity(void);
+		int  checkMemActivity( const uint8_t *dirtyCPU, const uint8_t *dirtyPPU, bool dirtyOAM );
+		void takeMemActivity(void);
 		int  getAddr(void){ return cursorAddr; };
 		int  FreezeRam( const char *name, uint32_t a, uint8_t v, int c, int s, int type );
 		void loadHighlightToClipboard(void);
@@ -185,6 +187,19 @@ class QHexEdit : public QWidget
 		memBlock_t  mb;
 		int (*memAccessFunc)( unsigned int offset);
 
+		// Pages of memory copied by checkMemActivity in the emulation thread,
+		// for takeMemActivity to merge into mb in the GUI thread.
+		const uint8_t *pageSource( int page );
+		QMutex       stageMutex;
+		int          stageMode;
+		int (*stageAccessFunc)( unsigned int offset);
+		std::vector <uint8_t> stage;
+		std::vector <uint8_t> stageDirty;
+		std::vector <const uint8_t*> stageSrc;
+		bool         stageFull;
+		bool         stageRan;
+		std::vector <uint8_t> pageActv;
+
 		QScrollBar *vbar;
 		QScrollBar *hbar;
 		QColor      highLightColor[ HIGHLIGHT_ACTIVITY_NUM_COLORS ];
@@ -83,6 +83,17 @@ MovieOptionsDialog_t::MovieOptionsDialog_t(QWidget *parent)
 	vbox1->addWidget(putSubTitlesAvi);
 	vbox1->addWidget(autoBackUp);
 	vbox1->addWidget(loadFullStates);
+
+	hbox = new QHBoxLayout();
+	seekCacheSize = new QSpinBox();
+	seekCacheSize->setRange(0, 4096);
+	seekCacheSize->setSuffix(tr(" MB"));
+	seekCacheSize->setToolTip(tr("Memory for the savestates that make seeking within a movie fast. 0 disables it."));
+	lbl = new QLabel(tr("Movie Seek Cache:"));
+	hbox->addWidget(lbl);
+	hbox->addWidget(seekCacheSize);
+	hbox->addStretch(5);
+	vbox1->addLayout(hbox);
 	vbox1->addWidget(aviEnableHUD);
 	vbox1->addWidget(aviEnableMsg);
 	vbox1->addWidget(aviEnableAudio);
@@ -96,6 +107,7 @@ MovieOptionsDialog_t::MovieOptionsDialog_t(QWidget *parent)
 	putSubTitlesAvi->setChecked(subtitlesOnAVI);
 	autoBackUp->setChecked(autoMovieBackup);
 	loadFullStates->setChecked(fullSaveStateLoads);
+	seekCacheSize->setValue(movieSeekCacheMB);
 	aviEnableHUD->setChecked(FCEUI_AviEnableHUDrecording());
 	aviEnableMsg->setChecked(!FCEUI_AviDisableMovieMessages());
 	aviEnableAudio->setChecked(aviGetAudioEnable());
@@ -162,6 +174,7 @@ MovieOptionsDialog_t::MovieOptionsDialog_t(QWidget *parent)
 	connect(putSubTitlesAvi, SIGNAL(stateChanged(int)), this, SLOT(putSubTitlesAviChanged(int)));
 	connect(autoBackUp, SIGNAL(stateChanged(int)), this, SLOT(autoBackUpChanged(int)));
 	connect(loadFullStates, SIGNAL(stateChanged(int)), this, SLOT(loadFullStatesChanged(int)));
+	connect(seekCacheSize , SIGNAL(valueChanged(int)), this, SLOT(seekCacheSizeChanged(int)));
 	connect(aviEnableHUD  , SIGNAL(stateChanged(int)), this, SLOT(setAviHudEnable(int)));
 	connect(aviEnableMsg  , SIGNAL(stateChanged(int)), this, SLOT(setAviMsgEnable(int)));
 	connect(aviEnableAudio, SIGNAL(stateChanged(int)), this, SLOT(setAviAudioEnable(int)));
@@ -271,6 +284,15 @@ void MovieOptionsDialog_t::loadFullStatesChanged(int state)
 	g_config->setOption("SDL.MovieFullSaveStateLoads", fullSaveStateLoads);
 }
 //----------------------------------------------------------------------------
+void MovieOptionsDialog_t::seekCacheSizeChanged(int value)
+{
+	fceuWrapperLock();
+	movieSeekCacheMB = value;
+	fceuWrapperUnLock();
+
+	g_config->setOption("SDL.MovieSeekCacheMB", movieSeekCacheMB);
+}
+//----------------------------------------------------------------------------
 void MovieOptionsDialog_t::aviBackendChanged(int idx)
 {
 	aviPageStack->setCurrentIndex(idx);
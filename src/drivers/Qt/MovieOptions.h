@@ -9,6 +9,7 @@
 #include <QHBoxLayout>
 #include <QComboBox>
 #include <QCheckBox>
+#include <QSpinBox>
 #include <QPushButton>
 #include <QLabel>
 #include <QFrame>
@@ -38,6 +39,7 @@ protected:
 	QCheckBox *putSubTitlesAvi;
 	QCheckBox *autoBackUp;
 	QCheckBox *loadFullStates;
+	QSpinBox  *seekCacheSize;
 	QCheckBox *aviEnableHUD;
 	QCheckBox *aviEnableMsg;
 	QCheckBox *aviEnableAudio;
@@ -59,5 +61,6 @@ private slots:
 	void setAviAudioEnable(int state);
 	void autoBackUpChanged(int state);
 	void loadFullStatesChanged(int state);
+	void seekCacheSizeChanged(int value);
 	void aviBackendChanged(int idx);
 };
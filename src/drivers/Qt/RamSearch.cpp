@@ -27,6 +27,11 @@
 #include <ctype.h>
 #include <string>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define RAM_SEARCH_SSE2
+#endif
+
 #include <SDL.h>
 #include <QMenu>
 #include <QMenuBar>
@@ -64,55 +69,446 @@
 static bool ShowROM = false;
 static RamSearchDialog_t *ramSearchWin = NULL;
 
-struct memoryState_t
+static int cmpOp = '=';
+static int dpySize = 'b';
+static int dpyType = 's';
+static bool chkMisAligned = false;
+
+// The search engine works a column at a time rather than one location at a
+// time.  Memory is kept as byte snapshots, the remaining candidates are a
+// bitset over the address space, and every search turns a block of 64
+// addresses into a word of survivors.  Word and dword values are put
+// together from the snapshots while a block is compared.
+#define SRCH_BLOCK  64
+#define SRCH_WORDS  (0x10000 / SRCH_BLOCK)
+
+// Snapshots are padded so a dword can be read at the last address.
+static uint8_t lclMemBuf[0x10000 + 4];  // this frame
+static uint8_t lastMemBuf[0x10000 + 4]; // last frame, to count changes
+static uint8_t prevMemBuf[0x10000 + 4]; // as of the last search ("Previous")
+static uint32_t chgCount[0x10000];
+
+static uint64_t candBits[SRCH_WORDS];
+static int candCount = 0;
+
+// What a search took away, so that undo can put it back: the candidate bits
+// it eliminated and the "Previous" bytes it overwrote.
+struct searchUndo_t
+{
+	std::vector<uint16_t> word;
+	std::vector<uint64_t> bits;
+	std::vector<uint16_t> prevAddr;
+	std::vector<uint8_t>  prevByte;
+};
+static std::vector<searchUndo_t> undoStack;
+
+enum
+{
+	SRCH_RELATIVE = 0,
+	SRCH_VALUE,
+	SRCH_ADDRESS,
+	SRCH_CHANGES
+};
+
+static int bitCount(uint64_t v)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(v);
+#else
+	int n = 0;
+
+	while (v)
+	{
+		v &= v - 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+static int lowBit(uint64_t v)
 {
-	union
+#if defined(__GNUC__)
+	return __builtin_ctzll(v);
+#else
+	int n = 0;
+
+	while ((v & 1) == 0)
 	{
-		int8_t i;
-		uint8_t u;
-	} v8;
-	union
+		v >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+static int dataBytes(void)
+{
+	if (dpySize == 'd')
 	{
-		int16_t i;
-		uint16_t u;
-	} v16;
-	union
+		return 4;
+	}
+	else if (dpySize == 'w')
 	{
-		int32_t i;
-		uint32_t u;
-	} v32;
-};
+		return 2;
+	}
+	return 1;
+}
 
-struct memoryLocation_t
+// Only dword values can leave the range of a signed 32 bit lane.
+static bool unsignedLanes(void)
 {
-	int addr;
+	return (dpySize == 'd') && (dpyType != 's');
+}
 
-	memoryState_t val;
+// Values of the current size at the 64 addresses from addr. Multi-byte
+// values are read most significant byte first, as they always have been.
+static void loadValues(const uint8_t *mem, int addr, int32_t *out)
+{
+	const uint8_t *p = &mem[addr];
+	int i;
 
-	std::vector<memoryState_t> hist;
+	if (dpySize == 'd')
+	{
+		for (i = 0; i < SRCH_BLOCK; i++)
+		{
+			out[i] = (int32_t)(((uint32_t)p[i] << 24) | (p[i + 1] << 16) | (p[i + 2] << 8) | p[i + 3]);
+		}
+	}
+	else if (dpySize == 'w')
+	{
+		if (dpyType == 's')
+		{
+			for (i = 0; i < SRCH_BLOCK; i++)
+			{
+				out[i] = (int16_t)((p[i] << 8) | p[i + 1]);
+			}
+		}
+		else
+		{
+			for (i = 0; i < SRCH_BLOCK; i++)
+			{
+				out[i] = (p[i] << 8) | p[i + 1];
+			}
+		}
+	}
+	else
+	{
+		if (dpyType == 's')
+		{
+			for (i = 0; i < SRCH_BLOCK; i++)
+			{
+				out[i] = (int8_t)p[i];
+			}
+		}
+		else
+		{
+			for (i = 0; i < SRCH_BLOCK; i++)
+			{
+				out[i] = p[i];
+			}
+		}
+	}
+}
 
-	uint32_t chgCount;
-	uint64_t elimMask;
+// One value of the current size and type, as the search compares it.
+static int64_t valueAt(const uint8_t *mem, int addr)
+{
+	const uint8_t *p = &mem[addr];
+	uint32_t v;
 
-	memoryLocation_t(void)
+	if (dpySize == 'd')
 	{
-		addr = 0;
-		val.v32.u = 0;
-		chgCount = 0;
-		elimMask = 0;
+		v = ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+
+		return (dpyType == 's') ? (int64_t)(int32_t)v : (int64_t)v;
 	}
-};
-static struct memoryLocation_t memLoc[0x10000];
-static uint8_t lclMemBuf[0x10000];
+	else if (dpySize == 'w')
+	{
+		v = (p[0] << 8) | p[1];
 
-static std::list<struct memoryLocation_t *> actvSrchList;
-static std::list<struct memoryLocation_t *> deactvSrchList;
-static std::vector<int> deactvFrameStack;
+		return (dpyType == 's') ? (int64_t)(int16_t)v : (int64_t)v;
+	}
+	return (dpyType == 's') ? (int64_t)(int8_t)p[0] : (int64_t)p[0];
+}
 
-static int cmpOp = '=';
-static int dpySize = 'b';
-static int dpyType = 's';
-static bool chkMisAligned = false;
+// basic comparison functions:
+static bool LessCmp(int64_t x, int64_t y, int64_t i) { return x < y; }
+static bool MoreCmp(int64_t x, int64_t y, int64_t i) { return x > y; }
+static bool LessEqualCmp(int64_t x, int64_t y, int64_t i) { return x <= y; }
+static bool MoreEqualCmp(int64_t x, int64_t y, int64_t i) { return x >= y; }
+static bool EqualCmp(int64_t x, int64_t y, int64_t i) { return x == y; }
+static bool UnequalCmp(int64_t x, int64_t y, int64_t i) { return x != y; }
+static bool DiffByCmp(int64_t x, int64_t y, int64_t p) { return x - y == p || y - x == p; }
+static bool ModIsCmp(int64_t x, int64_t y, int64_t p) { return p && x % p == y; }
+
+static bool (*cmpFunction(int op))(int64_t x, int64_t y, int64_t p)
+{
+	switch (op)
+	{
+	case '<':
+		return LessCmp;
+	case '>':
+		return MoreCmp;
+	case '=':
+		return EqualCmp;
+	case '!':
+		return UnequalCmp;
+	case 'l':
+		return LessEqualCmp;
+	case 'm':
+		return MoreEqualCmp;
+	case 'd':
+		return DiffByCmp;
+	case '%':
+		return ModIsCmp;
+	default:
+		break;
+	}
+	return NULL;
+}
+
+#ifdef RAM_SEARCH_SSE2
+// Four lanes at a time; the unsigned flavor flips the sign bits so the
+// signed compares order it correctly.
+template <int op>
+static uint64_t compareBlockSSE2(const int32_t *x, const int32_t *y, int32_t yc, bool isUnsigned)
+{
+	const __m128i flip = _mm_set1_epi32(isUnsigned ? (int)0x80000000 : 0);
+	const __m128i ones = _mm_set1_epi32(-1);
+	__m128i a, b, r;
+	uint64_t m = 0;
+
+	b = _mm_xor_si128(_mm_set1_epi32(yc), flip);
+
+	for (int i = 0; i < SRCH_BLOCK; i += 4)
+	{
+		a = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&x[i]), flip);
+
+		if (y != NULL)
+		{
+			b = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&y[i]), flip);
+		}
+		switch (op)
+		{
+		case '<':
+			r = _mm_cmplt_epi32(a, b);
+			break;
+		case '>':
+			r = _mm_cmpgt_epi32(a, b);
+			break;
+		case 'l':
+			r = _mm_xor_si128(_mm_cmpgt_epi32(a, b), ones);
+			break;
+		case 'm':
+			r = _mm_xor_si128(_mm_cmplt_epi32(a, b), ones);
+			break;
+		case '=':
+			r = _mm_cmpeq_epi32(a, b);
+			break;
+		default:
+			r = _mm_xor_si128(_mm_cmpeq_epi32(a, b), ones);
+			break;
+		}
+		m |= (uint64_t)_mm_movemask_ps(_mm_castsi128_ps(r)) << i;
+	}
+	return m;
+}
+#endif
+
+// Compares a block of values against another block (y) or against the
+// constant yc, one result bit per address.
+static uint64_t compareBlock(int op, const int32_t *x, const int32_t *y, int64_t yc, int64_t p, bool isUnsigned)
+{
+	bool (*cmpFun)(int64_t x, int64_t y, int64_t p) = cmpFunction(op);
+	uint64_t m = 0;
+	int64_t a, b;
+
+#ifdef RAM_SEARCH_SSE2
+	bool inLane = isUnsigned ? (yc >= 0 && yc <= 0xFFFFFFFFLL) : (yc >= INT32_MIN && yc <= INT32_MAX);
+
+	if ((y != NULL) || inLane)
+	{
+		switch (op)
+		{
+		case '<':
+			return compareBlockSSE2<'<'>(x, y, (int32_t)yc, isUnsigned);
+		case '>':
+			return compareBlockSSE2<'>'>(x, y, (int32_t)yc, isUnsigned);
+		case 'l':
+			return compareBlockSSE2<'l'>(x, y, (int32_t)yc, isUnsigned);
+		case 'm':
+			return compareBlockSSE2<'m'>(x, y, (int32_t)yc, isUnsigned);
+		case '=':
+			return compareBlockSSE2<'='>(x, y, (int32_t)yc, isUnsigned);
+		case '!':
+			return compareBlockSSE2<'!'>(x, y, (int32_t)yc, isUnsigned);
+		default:
+			break;
+		}
+	}
+#endif
+	if (cmpFun == NULL)
+	{
+		return 0;
+	}
+	for (int i = 0; i < SRCH_BLOCK; i++)
+	{
+		a = isUnsigned ? (int64_t)(uint32_t)x[i] : (int64_t)x[i];
+
+		if (y != NULL)
+		{
+			b = isUnsigned ? (int64_t)(uint32_t)y[i] : (int64_t)y[i];
+		}
+		else
+		{
+			b = yc;
+		}
+		if (cmpFun(a, b, p))
+		{
+			m |= (1ULL << i);
+		}
+	}
+	return m;
+}
+
+// Survivors of one search among the 64 addresses of block w.
+static uint64_t searchBlock(int kind, int op, int w, int64_t y, int64_t p)
+{
+	int32_t x[SRCH_BLOCK], prev[SRCH_BLOCK];
+	int addr = w * SRCH_BLOCK;
+
+	switch (kind)
+	{
+	case SRCH_RELATIVE:
+		loadValues(lclMemBuf, addr, x);
+		loadValues(prevMemBuf, addr, prev);
+		return compareBlock(op, x, prev, 0, p, unsignedLanes());
+	case SRCH_VALUE:
+		loadValues(lclMemBuf, addr, x);
+		return compareBlock(op, x, NULL, y, p, unsignedLanes());
+	case SRCH_ADDRESS:
+		for (int i = 0; i < SRCH_BLOCK; i++)
+		{
+			x[i] = addr + i;
+		}
+		return compareBlock(op, x, NULL, y, p, false);
+	default:
+		for (int i = 0; i < SRCH_BLOCK; i++)
+		{
+			x[i] = chgCount[addr + i];
+		}
+		return compareBlock(op, x, NULL, y, p, true);
+	}
+}
+
+// Drops the candidates that fail a search. Unless it is an auto-search the
+// step is recorded for undo, and the survivors' "Previous" values move up to
+// the current ones.
+static void filterCandidates(int kind, int op, int64_t y, int64_t p, bool storeHistory)
+{
+	searchUndo_t *undo = NULL;
+	uint64_t cand, keep;
+
+	if (cmpFunction(op) == NULL)
+	{
+		return;
+	}
+	if (storeHistory)
+	{
+		undoStack.push_back(searchUndo_t());
+		undo = &undoStack.back();
+	}
+
+	for (int w = 0; w < SRCH_WORDS; w++)
+	{
+		cand = candBits[w];
+
+		if (cand == 0)
+		{
+			continue;
+		}
+		keep = cand & searchBlock(kind, op, w, y, p);
+
+		if (keep != cand)
+		{
+			if (undo != NULL)
+			{
+				undo->word.push_back(w);
+				undo->bits.push_back(cand & ~keep);
+			}
+			candCount -= bitCount(cand & ~keep);
+			candBits[w] = keep;
+		}
+	}
+
+	if (undo != NULL)
+	{
+		for (int addr = 0; addr < 0x10000; addr++)
+		{
+			if (prevMemBuf[addr] != lclMemBuf[addr])
+			{
+				undo->prevAddr.push_back(addr);
+				undo->prevByte.push_back(prevMemBuf[addr]);
+				prevMemBuf[addr] = lclMemBuf[addr];
+			}
+		}
+	}
+}
+
+// Address of the n'th remaining candidate, or -1.
+static int candidateAt(int n)
+{
+	uint64_t bits;
+	int c;
+
+	if (n < 0)
+	{
+		return -1;
+	}
+	for (int w = 0; w < SRCH_WORDS; w++)
+	{
+		bits = candBits[w];
+		c = bitCount(bits);
+
+		if (n < c)
+		{
+			while (n-- > 0)
+			{
+				bits &= bits - 1;
+			}
+			return (w * SRCH_BLOCK) + lowBit(bits);
+		}
+		n -= c;
+	}
+	return -1;
+}
+
+// First candidate after addr, or -1.
+static int nextCandidate(int addr)
+{
+	uint64_t bits;
+	int w;
+
+	addr++;
+
+	if (addr >= 0x10000)
+	{
+		return -1;
+	}
+	w = addr / SRCH_BLOCK;
+	bits = candBits[w] & (~0ULL << (addr % SRCH_BLOCK));
+
+	while (bits == 0)
+	{
+		if (++w >= SRCH_WORDS)
+		{
+			return -1;
+		}
+		bits = candBits[w];
+	}
+	return (w * SRCH_BLOCK) + lowBit(bits);
+}
 
 class ramSearchInputValidator : public QValidator
 {
@@ -497,14 +893,8 @@ RamSearchDialog_t::~RamSearchDialog_t(void)
 	//printf("Destroy RAM Search Window\n");
 	ramSearchWin = NULL;
 
-	actvSrchList.clear();
-	deactvSrchList.clear();
-	deactvFrameStack.clear();
+	undoStack.clear();
 
-	for (unsigned int addr = 0; addr < 0x08000; addr++)
-	{
-		memLoc[addr].hist.clear();
-	}
 	settings.setValue("ramSearchWindow/geometry", saveGeometry());
 }
 //----------------------------------------------------------------------------
@@ -528,555 +918,170 @@ void RamSearchDialog_t::periodicUpdate(void)
 	int selAddr = -1;
 
 	if (currFrameCounter != frameCounterLastPass)
-	{
-		fceuWrapperLock();
-		copyRamToLocalBuffer();
-		fceuWrapperUnLock();
-
-		//if ( currFrameCounter != (frameCounterLastPass+1) )
-		//{
-		//   printf("Warning: Ram Search Missed Frame: %i \n", currFrameCounter );
-		//}
-		updateRamValues();
-
-		if (autoSearchCbox->isChecked())
-		{
-			runSearch();
-		}
-		frameCounterLastPass = currFrameCounter;
-	}
-
-	if ((cycleCounter % 10) == 0)
-	{
-		undoButton->setEnabled(deactvFrameStack.size() > 0);
-
-		selAddr = ramView->getSelAddr();
-
-		if (selAddr >= 0)
-		{
-			elimButton->setEnabled(true);
-			watchButton->setEnabled(true);
-			addCheatButton->setEnabled(true);
-			hexEditButton->setEnabled(true);
-		}
-		else
-		{
-			elimButton->setEnabled(false);
-			watchButton->setEnabled(false);
-			addCheatButton->setEnabled(false);
-			hexEditButton->setEnabled(false);
-		}
-
-		ramView->update();
-	}
-	cycleCounter++;
-}
-//----------------------------------------------------
-void RamSearchDialog_t::hbarChanged(int val)
-{
-	ramView->update();
-}
-//----------------------------------------------------
-void RamSearchDialog_t::vbarChanged(int val)
-{
-	ramView->update();
-}
-//----------------------------------------------------
-void RamSearchDialog_t::searchROMChanged(int state)
-{
-	ShowROM = (state != Qt::Unchecked);
-}
-//----------------------------------------------------
-void RamSearchDialog_t::misalignedChanged(int state)
-{
-	chkMisAligned = (state != Qt::Unchecked);
-
-	calcRamList();
-}
-//----------------------------------------------------------------------------
-static bool memoryAddrCompare(memoryLocation_t *loc1, memoryLocation_t *loc2)
-{
-	return loc1->addr < loc2->addr;
-}
-static void sortActvMemList(void)
-{
-	actvSrchList.sort(memoryAddrCompare);
-}
-
-// basic comparison functions:
-static bool LessCmp(int64_t x, int64_t y, int64_t i) { return x < y; }
-static bool MoreCmp(int64_t x, int64_t y, int64_t i) { return x > y; }
-static bool LessEqualCmp(int64_t x, int64_t y, int64_t i) { return x <= y; }
-static bool MoreEqualCmp(int64_t x, int64_t y, int64_t i) { return x >= y; }
-static bool EqualCmp(int64_t x, int64_t y, int64_t i) { return x == y; }
-static bool UnequalCmp(int64_t x, int64_t y, int64_t i) { return x != y; }
-static bool DiffByCmp(int64_t x, int64_t y, int64_t p) { return x - y == p || y - x == p; }
-static bool ModIsCmp(int64_t x, int64_t y, int64_t p) { return p && x % p == y; }
-
-static int64_t getLineEditValue(QLineEdit *edit, bool forceHex = false)
-{
-	int64_t val = 0;
-	std::string s;
-
-	s = edit->text().toStdString();
-
-	if (s.size() > 0)
-	{
-		val = strtoll(s.c_str(), NULL, forceHex ? 16 : 0);
-	}
-	return val;
-}
-
-//----------------------------------------------------------------------------
-void RamSearchDialog_t::SearchRelative(void)
-{
-	int elimCount = 0;
-	std::list<struct memoryLocation_t *>::iterator it;
-	memoryLocation_t *loc = NULL;
-	int64_t x = 0, y = 0, p = 0;
-	bool (*cmpFun)(int64_t x, int64_t y, int64_t p) = NULL;
-	bool storeHistory = !autoSearchCbox->isChecked();
-
-	switch (cmpOp)
-	{
-	case '<':
-		cmpFun = LessCmp;
-		break;
-	case '>':
-		cmpFun = MoreCmp;
-		break;
-	case '=':
-		cmpFun = EqualCmp;
-		break;
-	case '!':
-		cmpFun = UnequalCmp;
-		break;
-	case 'l':
-		cmpFun = LessEqualCmp;
-		break;
-	case 'm':
-		cmpFun = MoreEqualCmp;
-		break;
-	case 'd':
-		cmpFun = DiffByCmp;
-		p = getLineEditValue(diffByEdit);
-		break;
-	case '%':
-		cmpFun = ModIsCmp;
-		p = getLineEditValue(moduloEdit);
-		break;
-	default:
-		cmpFun = NULL;
-		break;
-	}
-
-	if (cmpFun == NULL)
-	{
-		return;
-	}
-	//printf("Performing Relative Search Operation %zi: '%c'  '%lli'  '0x%llx' \n", deactvFrameStack.size()+1, cmpOp, (long long int)p, (unsigned long long int)p );
-
-	it = actvSrchList.begin();
-
-	while (it != actvSrchList.end())
-	{
-		loc = *it;
-
-		switch (dpySize)
-		{
-		default:
-		case 'b':
-		{
-			if (dpyType == 's')
-			{
-				x = loc->val.v8.i;
-				y = loc->hist.back().v8.i;
-			}
-			else
-			{
-				x = loc->val.v8.u;
-				y = loc->hist.back().v8.u;
-			}
-		}
-		break;
-		case 'w':
-		{
-			if (dpyType == 's')
-			{
-				x = loc->val.v16.i;
-				y = loc->hist.back().v16.i;
-			}
-			else
-			{
-				x = loc->val.v16.u;
-				y = loc->hist.back().v16.u;
-			}
-		}
-		break;
-		case 'd':
-		{
-			if (dpyType == 's')
-			{
-				x = loc->val.v32.i;
-				y = loc->hist.back().v32.i;
-			}
-			else
-			{
-				x = loc->val.v32.u;
-				y = loc->hist.back().v32.u;
-			}
-		}
-		break;
-		}
-
-		if (cmpFun(x, y, p) == false)
-		{
-			//printf("Eliminated Address: $%04X\n", loc->addr );
-			it = actvSrchList.erase(it);
-
-			if (storeHistory)
-			{
-				deactvSrchList.push_back(loc);
-				elimCount++;
-			}
-		}
-		else
-		{
-			if (storeHistory)
-			{
-				loc->hist.push_back(loc->val);
-			}
-			it++;
-		}
-	}
-
-	if (storeHistory)
-	{
-		deactvFrameStack.push_back(elimCount);
-	}
-
-	vbar->setMaximum(actvSrchList.size());
-}
-//----------------------------------------------------------------------------
-void RamSearchDialog_t::SearchSpecificValue(void)
-{
-	int elimCount = 0;
-	std::list<struct memoryLocation_t *>::iterator it;
-	memoryLocation_t *loc = NULL;
-	int64_t x = 0, y = 0, p = 0;
-	bool (*cmpFun)(int64_t x, int64_t y, int64_t p) = NULL;
-	bool storeHistory = !autoSearchCbox->isChecked();
-
-	switch (cmpOp)
-	{
-	case '<':
-		cmpFun = LessCmp;
-		break;
-	case '>':
-		cmpFun = MoreCmp;
-		break;
-	case '=':
-		cmpFun = EqualCmp;
-		break;
-	case '!':
-		cmpFun = UnequalCmp;
-		break;
-	case 'l':
-		cmpFun = LessEqualCmp;
-		break;
-	case 'm':
-		cmpFun = MoreEqualCmp;
-		break;
-	case 'd':
-		cmpFun = DiffByCmp;
-		p = getLineEditValue(diffByEdit);
-		break;
-	case '%':
-		cmpFun = ModIsCmp;
-		p = getLineEditValue(moduloEdit);
-		break;
-	default:
-		cmpFun = NULL;
-		break;
-	}
-
-	if (cmpFun == NULL)
-	{
-		return;
-	}
-	y = getLineEditValue(specValEdit);
-
-	//printf("Performing Specific Value Search Operation %zi: 'x %c %lli' '%lli'  '0x%llx' \n", deactvFrameStack.size()+1, cmpOp,
-	//     (long long int)y, (long long int)p, (unsigned long long int)p );
-
-	it = actvSrchList.begin();
-
-	while (it != actvSrchList.end())
-	{
-		loc = *it;
-
-		switch (dpySize)
-		{
-		default:
-		case 'b':
-		{
-			if (dpyType == 's')
-			{
-				x = loc->val.v8.i;
-			}
-			else
-			{
-				x = loc->val.v8.u;
-			}
-		}
-		break;
-		case 'w':
-		{
-			if (dpyType == 's')
-			{
-				x = loc->val.v16.i;
-			}
-			else
-			{
-				x = loc->val.v16.u;
-			}
-		}
-		break;
-		case 'd':
-		{
-			if (dpyType == 's')
-			{
-				x = loc->val.v32.i;
-			}
-			else
-			{
-				x = loc->val.v32.u;
-			}
-		}
-		break;
-		}
-
-		if (cmpFun(x, y, p) == false)
-		{
-			//printf("Eliminated Address: $%04X\n", loc->addr );
-			it = actvSrchList.erase(it);
-
-			if (storeHistory)
-			{
-				deactvSrchList.push_back(loc);
-				elimCount++;
-			}
-		}
-		else
-		{
-			if (storeHistory)
-			{
-				loc->hist.push_back(loc->val);
-			}
-			it++;
-		}
-	}
-
-	if (storeHistory)
-	{
-		deactvFrameStack.push_back(elimCount);
-	}
-
-	vbar->setMaximum(actvSrchList.size());
-}
-//----------------------------------------------------------------------------
-void RamSearchDialog_t::SearchSpecificAddress(void)
-{
-	int elimCount = 0;
-	std::list<struct memoryLocation_t *>::iterator it;
-	memoryLocation_t *loc = NULL;
-	int64_t x = 0, y = 0, p = 0;
-	bool (*cmpFun)(int64_t x, int64_t y, int64_t p) = NULL;
-	bool storeHistory = !autoSearchCbox->isChecked();
-
-	switch (cmpOp)
-	{
-	case '<':
-		cmpFun = LessCmp;
-		break;
-	case '>':
-		cmpFun = MoreCmp;
-		break;
-	case '=':
-		cmpFun = EqualCmp;
-		break;
-	case '!':
-		cmpFun = UnequalCmp;
-		break;
-	case 'l':
-		cmpFun = LessEqualCmp;
-		break;
-	case 'm':
-		cmpFun = MoreEqualCmp;
-		break;
-	case 'd':
-		cmpFun = DiffByCmp;
-		p = getLineEditValue(diffByEdit);
-		break;
-	case '%':
-		cmpFun = ModIsCmp;
-		p = getLineEditValue(moduloEdit);
-		break;
-	default:
-		cmpFun = NULL;
-		break;
-	}
-
-	if (cmpFun == NULL)
-	{
-		return;
-	}
-	y = getLineEditValue(specAddrEdit);
+	{
+		fceuWrapperLock();
+		copyRamToLocalBuffer();
+		fceuWrapperUnLock();
 
-	//printf("Performing Specific Address Search Operation %zi: 'x %c 0x%llx' '%lli'  '0x%llx' \n", deactvFrameStack.size()+1, cmpOp,
-	//     (unsigned long long int)y, (long long int)p, (unsigned long long int)p );
+		//if ( currFrameCounter != (frameCounterLastPass+1) )
+		//{
+		//   printf("Warning: Ram Search Missed Frame: %i \n", currFrameCounter );
+		//}
+		updateRamValues();
 
-	it = actvSrchList.begin();
+		if (autoSearchCbox->isChecked())
+		{
+			runSearch();
+		}
+		frameCounterLastPass = currFrameCounter;
+	}
 
-	while (it != actvSrchList.end())
+	if ((cycleCounter % 10) == 0)
 	{
-		loc = *it;
+		undoButton->setEnabled(undoStack.size() > 0);
 
-		x = loc->addr;
+		selAddr = ramView->getSelAddr();
 
-		if (cmpFun(x, y, p) == false)
+		if (selAddr >= 0)
 		{
-			//printf("Eliminated Address: $%04X\n", loc->addr );
-			it = actvSrchList.erase(it);
-
-			if (storeHistory)
-			{
-				deactvSrchList.push_back(loc);
-				elimCount++;
-			}
+			elimButton->setEnabled(true);
+			watchButton->setEnabled(true);
+			addCheatButton->setEnabled(true);
+			hexEditButton->setEnabled(true);
 		}
 		else
 		{
-			if (storeHistory)
-			{
-				loc->hist.push_back(loc->val);
-			}
-			it++;
+			elimButton->setEnabled(false);
+			watchButton->setEnabled(false);
+			addCheatButton->setEnabled(false);
+			hexEditButton->setEnabled(false);
 		}
+
+		ramView->update();
 	}
+	cycleCounter++;
+}
+//----------------------------------------------------
+void RamSearchDialog_t::hbarChanged(int val)
+{
+	ramView->update();
+}
+//----------------------------------------------------
+void RamSearchDialog_t::vbarChanged(int val)
+{
+	ramView->update();
+}
+//----------------------------------------------------
+void RamSearchDialog_t::searchROMChanged(int state)
+{
+	ShowROM = (state != Qt::Unchecked);
+}
+//----------------------------------------------------
+void RamSearchDialog_t::misalignedChanged(int state)
+{
+	chkMisAligned = (state != Qt::Unchecked);
 
-	if (storeHistory)
+	calcRamList();
+}
+//----------------------------------------------------------------------------
+static int64_t getLineEditValue(QLineEdit *edit, bool forceHex = false)
+{
+	int64_t val = 0;
+	std::string s;
+
+	s = edit->text().toStdString();
+
+	if (s.size() > 0)
 	{
-		deactvFrameStack.push_back(elimCount);
+		val = strtoll(s.c_str(), NULL, forceHex ? 16 : 0);
 	}
-
-	vbar->setMaximum(actvSrchList.size());
+	return val;
 }
+
 //----------------------------------------------------------------------------
-void RamSearchDialog_t::SearchNumberChanges(void)
+void RamSearchDialog_t::SearchRelative(void)
 {
-	int elimCount = 0;
-	std::list<struct memoryLocation_t *>::iterator it;
-	memoryLocation_t *loc = NULL;
-	int64_t x = 0, y = 0, p = 0;
-	bool (*cmpFun)(int64_t x, int64_t y, int64_t p) = NULL;
-	bool storeHistory = !autoSearchCbox->isChecked();
+	int64_t p = 0;
 
-	switch (cmpOp)
+	if (cmpOp == 'd')
 	{
-	case '<':
-		cmpFun = LessCmp;
-		break;
-	case '>':
-		cmpFun = MoreCmp;
-		break;
-	case '=':
-		cmpFun = EqualCmp;
-		break;
-	case '!':
-		cmpFun = UnequalCmp;
-		break;
-	case 'l':
-		cmpFun = LessEqualCmp;
-		break;
-	case 'm':
-		cmpFun = MoreEqualCmp;
-		break;
-	case 'd':
-		cmpFun = DiffByCmp;
 		p = getLineEditValue(diffByEdit);
-		break;
-	case '%':
-		cmpFun = ModIsCmp;
-		p = getLineEditValue(moduloEdit);
-		break;
-	default:
-		cmpFun = NULL;
-		break;
 	}
-
-	if (cmpFun == NULL)
+	else if (cmpOp == '%')
 	{
-		return;
+		p = getLineEditValue(moduloEdit);
 	}
-	y = getLineEditValue(numChangeEdit);
+	//printf("Performing Relative Search Operation %zi: '%c'  '%lli'  '0x%llx' \n", undoStack.size()+1, cmpOp, (long long int)p, (unsigned long long int)p );
 
-	//printf("Performing Number of Changes Search Operation %zi: 'x %c 0x%llx' '%lli'  '0x%llx' \n", deactvFrameStack.size()+1, cmpOp,
-	//     (unsigned long long int)y, (long long int)p, (unsigned long long int)p );
+	filterCandidates(SRCH_RELATIVE, cmpOp, 0, p, !autoSearchCbox->isChecked());
 
-	it = actvSrchList.begin();
+	vbar->setMaximum(candCount);
+}
+//----------------------------------------------------------------------------
+void RamSearchDialog_t::SearchSpecificValue(void)
+{
+	int64_t y = 0, p = 0;
 
-	while (it != actvSrchList.end())
+	if (cmpOp == 'd')
+	{
+		p = getLineEditValue(diffByEdit);
+	}
+	else if (cmpOp == '%')
 	{
-		loc = *it;
+		p = getLineEditValue(moduloEdit);
+	}
+	y = getLineEditValue(specValEdit);
 
-		x = loc->chgCount;
+	//printf("Performing Specific Value Search Operation %zi: 'x %c %lli' '%lli'  '0x%llx' \n", undoStack.size()+1, cmpOp,
+	//     (long long int)y, (long long int)p, (unsigned long long int)p );
 
-		if (cmpFun(x, y, p) == false)
-		{
-			//printf("Eliminated Address: $%04X\n", loc->addr );
-			it = actvSrchList.erase(it);
+	filterCandidates(SRCH_VALUE, cmpOp, y, p, !autoSearchCbox->isChecked());
 
-			if (storeHistory)
-			{
-				deactvSrchList.push_back(loc);
-				elimCount++;
-			}
-		}
-		else
-		{
-			if (storeHistory)
-			{
-				loc->hist.push_back(loc->val);
-			}
-			it++;
-		}
-	}
+	vbar->setMaximum(candCount);
+}
+//----------------------------------------------------------------------------
+void RamSearchDialog_t::SearchSpecificAddress(void)
+{
+	int64_t y = 0, p = 0;
 
-	if (storeHistory)
+	if (cmpOp == 'd')
 	{
-		deactvFrameStack.push_back(elimCount);
+		p = getLineEditValue(diffByEdit);
+	}
+	else if (cmpOp == '%')
+	{
+		p = getLineEditValue(moduloEdit);
 	}
+	y = getLineEditValue(specAddrEdit);
+
+	//printf("Performing Specific Address Search Operation %zi: 'x %c 0x%llx' '%lli'  '0x%llx' \n", undoStack.size()+1, cmpOp,
+	//     (unsigned long long int)y, (long long int)p, (unsigned long long int)p );
+
+	filterCandidates(SRCH_ADDRESS, cmpOp, y, p, !autoSearchCbox->isChecked());
 
-	vbar->setMaximum(actvSrchList.size());
+	vbar->setMaximum(candCount);
 }
 //----------------------------------------------------------------------------
-static unsigned int ReadValueAtHardwareAddress(int address, unsigned int size)
+void RamSearchDialog_t::SearchNumberChanges(void)
 {
-	unsigned int value = 0;
-	int maxAddr = ShowROM ? 0x10000 : 0x8000;
+	int64_t y = 0, p = 0;
 
-	// read as little endian
-	for (unsigned int i = 0; i < size; i++)
+	if (cmpOp == 'd')
 	{
-		if (address < maxAddr)
-		{
-			value <<= 8;
-			value |= lclMemBuf[address];
-			address++;
-		}
+		p = getLineEditValue(diffByEdit);
 	}
-	return value;
+	else if (cmpOp == '%')
+	{
+		p = getLineEditValue(moduloEdit);
+	}
+	y = getLineEditValue(numChangeEdit);
+
+	//printf("Performing Number of Changes Search Operation %zi: 'x %c 0x%llx' '%lli'  '0x%llx' \n", undoStack.size()+1, cmpOp,
+	//     (unsigned long long int)y, (long long int)p, (unsigned long long int)p );
+
+	filterCandidates(SRCH_CHANGES, cmpOp, y, p, !autoSearchCbox->isChecked());
+
+	vbar->setMaximum(candCount);
 }
 //----------------------------------------------------------------------------
 void RamSearchDialog_t::runSearch(void)
@@ -1102,15 +1107,28 @@ void RamSearchDialog_t::runSearch(void)
 		SearchNumberChanges();
 	}
 
-	undoButton->setEnabled(deactvFrameStack.size() > 0);
+	undoButton->setEnabled(undoStack.size() > 0);
 }
 //----------------------------------------------------------------------------
 void RamSearchDialog_t::copyRamToLocalBuffer(void)
 {
-	for (unsigned int addr = 0; addr < 0x10000; addr++)
+	for (unsigned int addr = 0; addr < 0x8000; addr++)
 	{
 		lclMemBuf[addr] = GetMem(addr);
 	}
+
+	// ROM only reads back when it is being searched.
+	if (ShowROM)
+	{
+		for (unsigned int addr = 0x8000; addr < 0x10000; addr++)
+		{
+			lclMemBuf[addr] = GetMem(addr);
+		}
+	}
+	else
+	{
+		memset(&lclMemBuf[0x8000], 0, 0x8000);
+	}
 }
 //----------------------------------------------------------------------------
 void RamSearchDialog_t::resetSearch(void)
@@ -1121,21 +1139,9 @@ void RamSearchDialog_t::resetSearch(void)
 	copyRamToLocalBuffer();
 	fceuWrapperUnLock();
 
-	actvSrchList.clear();
-	deactvSrchList.clear();
-	deactvFrameStack.clear();
-
-	for (unsigned int addr = 0; addr < 0x10000; addr++)
-	{
-		memLoc[addr].hist.clear();
-		memLoc[addr].addr = addr;
-		memLoc[addr].val.v8.u = lclMemBuf[addr];
-		memLoc[addr].val.v16.u = ReadValueAtHardwareAddress(addr, 2);
-		memLoc[addr].val.v32.u = ReadValueAtHardwareAddress(addr, 4);
-		memLoc[addr].elimMask = 0;
-		memLoc[addr].chgCount = 0;
-		memLoc[addr].hist.push_back(memLoc[addr].val);
-	}
+	memcpy(lastMemBuf, lclMemBuf, sizeof(lastMemBuf));
+	memcpy(prevMemBuf, lclMemBuf, sizeof(prevMemBuf));
+	memset(chgCount, 0, sizeof(chgCount));
 
 	calcRamList();
 
@@ -1144,107 +1150,45 @@ void RamSearchDialog_t::resetSearch(void)
 //----------------------------------------------------------------------------
 void RamSearchDialog_t::undoSearch(void)
 {
-	int elimCount = 0;
-	memoryLocation_t *loc = NULL;
-	std::list<struct memoryLocation_t *>::iterator it;
-
-	if (deactvFrameStack.empty())
+	if (undoStack.empty())
 	{
 		printf("Error: UNDO Stack is empty\n");
 		return;
 	}
-	printf("UNDO Search Operation: %zi \n", deactvFrameStack.size());
+	printf("UNDO Search Operation: %zi \n", undoStack.size());
 	// To Undo a search operation:
-	// 1. Loop through all current active values and revert previous value back to what it was before the search
-	// 2. Get the number of eliminated values from the deactivate search stack and tranfer those values back into the active search list.
+	// 1. Set the bits the search eliminated back in the candidate set.
+	// 2. Put back the previous values the search overwrote.
+	searchUndo_t &undo = undoStack.back();
 
-	it = actvSrchList.begin();
-
-	while (it != actvSrchList.end())
+	for (size_t i = 0; i < undo.word.size(); i++)
 	{
-		loc = *it;
-
-		if (!loc->hist.empty())
-		{
-			loc->hist.pop_back();
-		}
-		it++;
+		candBits[undo.word[i]] |= undo.bits[i];
+		candCount += bitCount(undo.bits[i]);
 	}
 
-	elimCount = deactvFrameStack.back();
-	deactvFrameStack.pop_back();
-
-	while (elimCount > 0)
+	for (size_t i = 0; i < undo.prevAddr.size(); i++)
 	{
-		if (deactvSrchList.empty())
-		{
-			printf("Error: Something went wrong with UNDO operation\n");
-			break;
-		}
-		loc = deactvSrchList.back();
-		deactvSrchList.pop_back();
-		actvSrchList.push_back(loc);
-		elimCount--;
+		prevMemBuf[undo.prevAddr[i]] = undo.prevByte[i];
 	}
 
-	sortActvMemList();
+	undoStack.pop_back();
 
-	undoButton->setEnabled(deactvFrameStack.size() > 0);
+	vbar->setMaximum(candCount);
+
+	undoButton->setEnabled(undoStack.size() > 0);
 }
 //----------------------------------------------------------------------------
 void RamSearchDialog_t::clearChangeCounts(void)
 {
-	for (unsigned int addr = 0; addr < 0x10000; addr++)
-	{
-		memLoc[addr].chgCount = 0;
-	}
+	memset(chgCount, 0, sizeof(chgCount));
 }
 //----------------------------------------------------------------------------
 void RamSearchDialog_t::eliminateSelAddr(void)
 {
-	int elimCount = 0, op = '!';
-	std::list<struct memoryLocation_t *>::iterator it;
-	memoryLocation_t *loc = NULL;
-	int64_t x = 0, y = 0, p = 0;
-	bool (*cmpFun)(int64_t x, int64_t y, int64_t p) = NULL;
-
-	switch (op)
-	{
-	case '<':
-		cmpFun = LessCmp;
-		break;
-	case '>':
-		cmpFun = MoreCmp;
-		break;
-	case '=':
-		cmpFun = EqualCmp;
-		break;
-	case '!':
-		cmpFun = UnequalCmp;
-		break;
-	case 'l':
-		cmpFun = LessEqualCmp;
-		break;
-	case 'm':
-		cmpFun = MoreEqualCmp;
-		break;
-	case 'd':
-		cmpFun = DiffByCmp;
-		p = getLineEditValue(diffByEdit);
-		break;
-	case '%':
-		cmpFun = ModIsCmp;
-		p = getLineEditValue(moduloEdit);
-		break;
-	default:
-		cmpFun = NULL;
-		break;
-	}
+	int op = '!';
+	int64_t y = 0, p = 0;
 
-	if (cmpFun == NULL)
-	{
-		return;
-	}
 	y = ramView->getSelAddr();
 
 	if (y < 0)
@@ -1252,35 +1196,12 @@ void RamSearchDialog_t::eliminateSelAddr(void)
 		return;
 	}
 
-	printf("Performing Eliminate Address Operation %zi: 'x %c 0x%llx' '%lli'  '0x%llx' \n", deactvFrameStack.size() + 1, cmpOp,
+	printf("Performing Eliminate Address Operation %zi: 'x %c 0x%llx' '%lli'  '0x%llx' \n", undoStack.size() + 1, cmpOp,
 		   (unsigned long long int)y, (long long int)p, (unsigned long long int)p);
 
-	it = actvSrchList.begin();
-
-	while (it != actvSrchList.end())
-	{
-		loc = *it;
-
-		x = loc->addr;
-
-		if (cmpFun(x, y, p) == false)
-		{
-			//printf("Eliminated Address: $%04X\n", loc->addr );
-			it = actvSrchList.erase(it);
-
-			deactvSrchList.push_back(loc);
-			elimCount++;
-		}
-		else
-		{
-			loc->hist.push_back(loc->val);
-			it++;
-		}
-	}
-
-	deactvFrameStack.push_back(elimCount);
+	filterCandidates(SRCH_ADDRESS, op, y, p, true);
 
-	vbar->setMaximum(actvSrchList.size());
+	vbar->setMaximum(candCount);
 }
 //----------------------------------------------------------------------------
 void RamSearchDialog_t::addCheatClicked(void)
@@ -1475,98 +1396,74 @@ void RamSearchDialog_t::calcRamList(void)
 	{
 		dataSize = 1;
 	}
-	else if (dpySize == 'd')
-	{
-		dataSize = 4;
-	}
-	else if (dpySize == 'w')
-	{
-		dataSize = 2;
-	}
 	else
 	{
-		dataSize = 1;
+		dataSize = dataBytes();
 	}
 
-	actvSrchList.clear();
+	memset(candBits, 0, sizeof(candBits));
+	candCount = 0;
 
-	for (addr = 0; addr < endAddr; addr += dataSize)
+	for (addr = 0; (addr + dataBytes()) <= endAddr; addr += dataSize)
 	{
-		switch (dpySize)
-		{
-		case 'd':
-			if ((addr + 3) < endAddr)
-			{
-				if ((memLoc[addr].elimMask == 0) &&
-					(memLoc[addr + 1].elimMask == 0) &&
-					(memLoc[addr + 2].elimMask == 0) &&
-					(memLoc[addr + 3].elimMask == 0))
-				{
-					actvSrchList.push_back(&memLoc[addr]);
-				}
-			}
-			break;
-		case 'w':
-			if ((addr + 1) < endAddr)
-			{
-				if ((memLoc[addr].elimMask == 0) &&
-					(memLoc[addr + 1].elimMask == 0))
-				{
-					actvSrchList.push_back(&memLoc[addr]);
-				}
-			}
-			break;
-		default:
-		case 'b':
-			if (memLoc[addr].elimMask == 0)
-			{
-				actvSrchList.push_back(&memLoc[addr]);
-			}
-			break;
-		}
+		candBits[addr / SRCH_BLOCK] |= (1ULL << (addr % SRCH_BLOCK));
+		candCount++;
 	}
-	vbar->setMaximum(actvSrchList.size());
+
+	// Undo steps refer to the candidates of the old size and alignment.
+	undoStack.clear();
+
+	undoButton->setEnabled(false);
+
+	vbar->setMaximum(candCount);
 }
 //----------------------------------------------------------------------------
 void RamSearchDialog_t::updateRamValues(void)
 {
-	std::list<struct memoryLocation_t *>::iterator it;
-	memoryLocation_t *loc = NULL;
-	memoryState_t val;
+	uint8_t diff[SRCH_BLOCK + 3], chg[SRCH_BLOCK];
+	uint64_t bits;
+	int addr, n = dataBytes();
 
-	for (it = actvSrchList.begin(); it != actvSrchList.end(); it++)
+	// A value changed when any of its bytes did since the last frame.
+	for (int w = 0; w < SRCH_WORDS; w++)
 	{
-		loc = *it;
-
-		val.v8.u = lclMemBuf[loc->addr];
-		val.v16.u = ReadValueAtHardwareAddress(loc->addr, 2);
-		val.v32.u = ReadValueAtHardwareAddress(loc->addr, 4);
+		if (candBits[w] == 0)
+		{
+			continue;
+		}
+		addr = w * SRCH_BLOCK;
 
-		if (dpySize == 'd')
+		for (int i = 0; i < SRCH_BLOCK + 3; i++)
 		{
-			if (memLoc[loc->addr].val.v32.u != val.v32.u)
-			{
-				memLoc[loc->addr].val = val;
-				memLoc[loc->addr].chgCount++;
-			}
+			diff[i] = lclMemBuf[addr + i] ^ lastMemBuf[addr + i];
 		}
-		else if (dpySize == 'w')
+		for (int i = 0; i < SRCH_BLOCK; i++)
 		{
-			if (memLoc[loc->addr].val.v16.u != val.v16.u)
+			chg[i] = diff[i];
+
+			if (n > 1)
+			{
+				chg[i] |= diff[i + 1];
+			}
+			if (n > 2)
 			{
-				memLoc[loc->addr].val = val;
-				memLoc[loc->addr].chgCount++;
+				chg[i] |= diff[i + 2] | diff[i + 3];
 			}
 		}
-		else
+		bits = candBits[w];
+
+		while (bits)
 		{
-			if (memLoc[loc->addr].val.v8.u != val.v8.u)
+			int i = lowBit(bits);
+
+			if (chg[i])
 			{
-				memLoc[loc->addr].val = val;
-				memLoc[loc->addr].chgCount++;
+				chgCount[addr + i]++;
 			}
+			bits &= bits - 1;
 		}
 	}
+	memcpy(lastMemBuf, lclMemBuf, sizeof(lastMemBuf));
 }
 //----------------------------------------------------------------------------
 QRamSearchView::QRamSearchView(QWidget *parent)
@@ -1720,9 +1617,9 @@ void QRamSearchView::keyPressEvent(QKeyEvent *event)
 		selAddr = -1;
 		selLine++;
 
-		if (selLine >= actvSrchList.size())
+		if (selLine >= candCount)
 		{
-			selLine = actvSrchList.size() - 1;
+			selLine = candCount - 1;
 		}
 
 		if (selLine >= (lineOffset + viewLines))
@@ -1820,11 +1717,10 @@ void QRamSearchView::wheelEvent(QWheelEvent *event)
 //----------------------------------------------------------------------------
 void QRamSearchView::paintEvent(QPaintEvent *event)
 {
-	int i, x, y, row, nrow;
-	std::list<struct memoryLocation_t *>::iterator it;
+	int i, x, y, row, nrow, addr;
+	int64_t val, prev;
 	char addrStr[32], valStr[32], prevStr[32], chgStr[32];
 	QPainter painter(this);
-	memoryLocation_t *loc = NULL;
 	int fieldWidth, fieldPad[4], fieldLen[4], fieldStart[4];
 	const char *fieldText[4];
 
@@ -1845,7 +1741,7 @@ void QRamSearchView::paintEvent(QPaintEvent *event)
 
 	viewLines = nrow;
 
-	maxLineOffset = actvSrchList.size() - nrow;
+	maxLineOffset = candCount - nrow;
 
 	if (maxLineOffset < 1)
 		maxLineOffset = 1;
@@ -1865,17 +1761,7 @@ void QRamSearchView::paintEvent(QPaintEvent *event)
 		vbar->setValue(0);
 	}
 
-	i = 0;
-	it = actvSrchList.begin();
-	while (it != actvSrchList.end())
-	{
-		if (i == lineOffset)
-		{
-			break;
-		}
-		i++;
-		it++;
-	}
+	addr = candidateAt(lineOffset);
 
 	painter.fillRect(0, 0, viewWidth, viewHeight, this->palette().color(QPalette::Window));
 
@@ -1909,16 +1795,7 @@ void QRamSearchView::paintEvent(QPaintEvent *event)
 
 	for (row = 0; row < nrow; row++)
 	{
-		if (it != actvSrchList.end())
-		{
-			loc = *it;
-		}
-		else
-		{
-			loc = NULL;
-		}
-
-		if (loc == NULL)
+		if (addr < 0)
 		{
 			continue;
 		}
@@ -1926,73 +1803,77 @@ void QRamSearchView::paintEvent(QPaintEvent *event)
 		{
 			if (selLine == (lineOffset + row))
 			{
-				selAddr = loc->addr;
+				selAddr = addr;
 			}
 		}
-		it++;
 
-		if (selAddr == loc->addr)
+		if (selAddr == addr)
 		{
 			painter.fillRect(0, y - pxLineSpacing + pxLineLead, viewWidth, pxLineSpacing, QColor("light blue"));
 		}
 
-		sprintf(addrStr, "$%04X", loc->addr);
+		sprintf(addrStr, "$%04X", addr);
+
+		val = valueAt(lclMemBuf, addr);
+		prev = valueAt(prevMemBuf, addr);
 
 		if (dpySize == 'd')
 		{
 			if (dpyType == 'h')
 			{
-				sprintf(valStr, "0x%08X", loc->val.v32.u);
-				sprintf(prevStr, "0x%08X", loc->hist.back().v32.u);
+				sprintf(valStr, "0x%08X", (unsigned int)val);
+				sprintf(prevStr, "0x%08X", (unsigned int)prev);
 			}
 			else if (dpyType == 'u')
 			{
-				sprintf(valStr, "%u", loc->val.v32.u);
-				sprintf(prevStr, "%u", loc->hist.back().v32.u);
+				sprintf(valStr, "%u", (unsigned int)val);
+				sprintf(prevStr, "%u", (unsigned int)prev);
 			}
 			else
 			{
-				sprintf(valStr, "%i", loc->val.v32.i);
-				sprintf(prevStr, "%i", loc->hist.back().v32.i);
+				sprintf(valStr, "%i", (int)val);
+				sprintf(prevStr, "%i", (int)prev);
 			}
 		}
 		else if (dpySize == 'w')
 		{
 			if (dpyType == 'h')
 			{
-				sprintf(valStr, "0x%04X", loc->val.v16.u);
-				sprintf(prevStr, "0x%04X", loc->hist.back().v16.u);
+				sprintf(valStr, "0x%04X", (unsigned int)val);
+				sprintf(prevStr, "0x%04X", (unsigned int)prev);
 			}
 			else if (dpyType == 'u')
 			{
-				sprintf(valStr, "%u", loc->val.v16.u);
-				sprintf(prevStr, "%u", loc->hist.back().v16.u);
+				sprintf(valStr, "%u", (unsigned int)val);
+				sprintf(prevStr, "%u", (unsigned int)prev);
 			}
 			else
 			{
-				sprintf(valStr, "%i", loc->val.v16.i);
-				sprintf(prevStr, "%i", loc->hist.back().v16.i);
+				sprintf(valStr, "%i", (int)val);
+				sprintf(prevStr, "%i", (int)prev);
 			}
 		}
 		else
 		{
 			if (dpyType == 'h')
 			{
-				sprintf(valStr, "0x%02X", loc->val.v8.u);
-				sprintf(prevStr, "0x%02X", loc->hist.back().v8.u);
+				sprintf(valStr, "0x%02X", (unsigned int)val);
+				sprintf(prevStr, "0x%02X", (unsigned int)prev);
 			}
 			else if (dpyType == 'u')
 			{
-				sprintf(valStr, "%u", loc->val.v8.u);
-				sprintf(prevStr, "%u", loc->hist.back().v8.u);
+				sprintf(valStr, "%u", (unsigned int)val);
+				sprintf(prevStr, "%u", (unsigned int)prev);
 			}
 			else
 			{
-				sprintf(valStr, "%i", loc->val.v8.i);
-				sprintf(prevStr, "%i", loc->hist.back().v8.i);
+				sprintf(valStr, "%i", (int)val);
+				sprintf(prevStr, "%i", (int)prev);
 			}
 		}
-		sprintf(chgStr, "%u", loc->chgCount);
+		sprintf(chgStr, "%u", chgCount[addr]);
+
+		addr = nextCandidate(addr);
 
 		for (i = 0; i < 4; i++)
 		{
@@ -489,11 +489,18 @@ InitConfig()
 	config->addOption("soundrate", "SDL.Sound.Rate", 44100);
 	config->addOption("soundq", "SDL.Sound.Quality", 1);
 	config->addOption("soundrecord", "SDL.Sound.RecordFile", "");
+	config->addOption("stemrecord", "SDL.Sound.StemFile", "");
+	config->addOption("stemsplit", "SDL.Sound.StemSplit", 0);
+	config->addOption("nsftrack", "SDL.NSFRender.Track", 0);
+	config->addOption("nsfseconds", "SDL.NSFRender.Seconds", 0.0);
 	config->addOption("soundbufsize", "SDL.Sound.BufSize", 128);
 	config->addOption("lowpass", "SDL.Sound.LowPass", 0);
 	config->addOption("SDL.Sound.UseGlobalFocus", 1);
+	config->addOption("SDL.Sound.RecordExpSound", 0);
     
 	config->addOption('g', "gamegenie", "SDL.GameGenie", 0);
+	config->addOption("shareroms", "SDL.ShareROMs", 0);
+	config->addOption("idleskip", "SDL.IdleSkip", 0);
 	config->addOption("pal", "SDL.PAL", 0);
 	config->addOption("autoPal", "SDL.AutoDetectPAL", 1);
 	config->addOption("frameskip", "SDL.Frameskip", 0);
@@ -703,6 +710,7 @@ InitConfig()
 	config->addOption("SDL.SubtitlesOnAVI"         , 0 );
 	config->addOption("SDL.AutoMovieBackup"        , 0 );
 	config->addOption("SDL.MovieFullSaveStateLoads", 0 );
+	config->addOption("SDL.MovieSeekCacheMB"       , 64 );
 	
 	config->addOption("fourscore", "SDL.FourScore", 0);
 
@@ -773,6 +781,39 @@ InitConfig()
 	// fcm -> fm2 conversion
 	config->addOption("fcmconvert", "SDL.FCMConvert", "");
     
+	// ROM library scanning
+	config->addOption("scanlib", "SDL.ScanLibrary", "");
+	config->addOption("scanthreads", "SDL.ScanThreads", 0);
+	config->addOption("findrom", "SDL.FindRom", "");
+
+	// headless benchmark and regression runs
+	config->addOption("benchmark", "SDL.Benchmark.Path", "");
+	config->addOption("benchframes", "SDL.Benchmark.Frames", 600);
+	config->addOption("benchinterval", "SDL.Benchmark.Interval", 60);
+	config->addOption("benchbaseline", "SDL.Benchmark.Baseline", "");
+	config->addOption("benchupdate", "SDL.Benchmark.Update", 0);
+	config->addOption("benchtolerance", "SDL.Benchmark.Tolerance", 0.1);
+	config->addOption("benchcheats", "SDL.Benchmark.Cheats", 0);
+	config->addOption("benchmovie", "SDL.Benchmark.Movie", "");
+	config->addOption("benchgen", "SDL.Benchmark.Generate", "");
+	config->addOption("benchopll", "SDL.Benchmark.OPLL", 0);
+#ifdef FCEU_THREADED_CPU
+	config->addOption("benchcores", "SDL.Benchmark.Cores", 0);
+#endif
+
+	// finding where two configurations part ways on a movie
+	config->addOption("desync", "SDL.Desync.Path", "");
+	config->addOption("desyncmovie", "SDL.Desync.Movie", "");
+	config->addOption("desynca", "SDL.Desync.ArgsA", "");
+	config->addOption("desyncb", "SDL.Desync.ArgsB", "");
+	config->addOption("desyncbina", "SDL.Desync.ProgramA", "");
+	config->addOption("desyncbinb", "SDL.Desync.ProgramB", "");
+	config->addOption("desyncinterval", "SDL.Desync.Interval", 600);
+	config->addOption("desyncout", "SDL.Desync.Output", "");
+	config->addOption("desyncraminit", "SDL.Desync.RamInit", -1);
+	config->addOption("desyncworker", "SDL.Desync.Worker", "");
+	config->addOption("desynctrace", "SDL.Desync.TraceFrame", -1);
+
 	// fm2 -> srt conversion
 	config->addOption("ripsubs", "SDL.RipSubs", "");
 	
@@ -1013,6 +1054,12 @@ UpdateEMUCore(Config *config)
 	config->getOption("SDL.GameGenie", &flag);
 	FCEUI_SetGameGenie(flag ? 1 : 0);
 
+	config->getOption("SDL.ShareROMs", &flag);
+	FCEUI_SetShareROMs(flag ? 1 : 0);
+
+	config->getOption("SDL.IdleSkip", &flag);
+	FCEUI_SetIdleSkip(flag ? 1 : 0);
+
 	config->getOption("SDL.Sound.LowPass", &flag);
 	FCEUI_SetLowPass(flag ? 1 : 0);
 
@@ -13,6 +13,11 @@ void WriteSound(int32 *Buffer, int Count);
 int KillSound(void);
 uint32 GetMaxSound(void);
 uint32 GetWriteSound(void);
+uint32 GetNativeSoundRate(uint32 deviceRate);
+uint32 GetEmuSoundRate(void);
+uint32 GetSoundStarveCount(void);
+uint32 GetSoundOverrunCount(void);
+void ResetSoundBufferCounters(void);
 void FCEUD_MuteSoundOutput(bool value);
 
 void SilenceSound(int s); /* DOS and SDL */
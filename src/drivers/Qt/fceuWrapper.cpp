@@ -24,8 +24,11 @@
 #include <stdint.h>
 #include <limits.h>
 #include <unzip.h>
+#include <sstream>
 
 #include <QStyleFactory>
+#include <QProcess>
+#include <QCoreApplication>
 #include "Qt/main.h"
 #include "Qt/throttle.h"
 #include "Qt/config.h"
@@ -50,6 +53,7 @@
 #include "../../cheat.h"
 #include "../../movie.h"
 #include "../../version.h"
+#include "../../x6502.h"
 
 #ifdef _S9XLUA_H
 #include "../../fceulua.h"
@@ -468,6 +472,8 @@ CloseGame(void)
 	if(filename.size()) {
 		FCEUI_EndWaveRecord();
 	}
+	FCEUI_EndExpSoundWaveRecord();
+	FCEUI_EndStemRecord();
 
 	InputUserActiveFix();
 	return(1);
@@ -544,6 +550,10 @@ static const char *DriverUsage =
 "                          familykeyboard oekakids arkanoid shadow bworld\n"
 "                          4player\n"
 "--gamegenie    {0|1}   Enable emulated Game Genie.\n"
+"--shareroms    {0|1}   Map .nes files instead of copying them into memory,\n"
+"                         sharing them between running emulators.\n"
+"--idleskip     {0|1}   Skip ahead through CPU loops that only wait for the\n"
+"                         next interrupt.  Same results, less CPU time.\n"
 "--frameskip    x       Set # of frames to skip per emulated frame.\n"
 "--xres         x       Set horizontal resolution for full screen mode.\n"
 "--yres         x       Set vertical resolution for full screen mode.\n"
@@ -564,9 +574,60 @@ static const char *DriverUsage =
 "--soundbufsize x       Set sound buffer size to x ms.\n"
 "--volume      {0-256}  Set volume to x.\n"
 "--soundrecord  f       Record sound to file f.\n"
+"--stemrecord   f       Record each sound channel on its own to file f.\n"
+"--stemsplit    {0|1}   Write stems as one file per channel instead of a\n"
+"                         single multichannel file.\n"
+"--nsftrack     x       Play track x of the NSF file given and exit, recording\n"
+"                         to the --soundrecord and --stemrecord files.  Run with\n"
+"                         -platform offscreen to not need a display.\n"
+"--nsfseconds   x       Number of seconds of the track to play.\n"
 "--playmov      f       Play back a recorded FCM/FM2/FM3 movie from filename f.\n"
 "--pauseframe   x       Pause movie playback at frame x.\n"
 "--fcmconvert   f       Convert fcm movie file f to fm2.\n"
+"--scanlib      d       Scan directory d for ROMs into the library index and\n"
+"                         exit.\n"
+"--scanthreads  x       Number of threads to scan with, 0 picks one per CPU.\n"
+"--findrom      s       Search the library index for s (part of a path, or a\n"
+"                         CRC32 or MD5 in hex) and exit.\n"
+"--benchmark    p       Run ROM p, or every ROM found under directory p, as\n"
+"                         fast as possible with fixed input, print the speed\n"
+"                         of each and exit.\n"
+"--benchframes  x       Number of frames to run each ROM for.\n"
+"--benchinterval x      Hash RAM and the picture every x frames.\n"
+"--benchbaseline f      Compare with baseline file f, exiting non-zero if\n"
+"                         any ROM's hashes differ or it got slower.\n"
+"--benchupdate  {0|1}   Write the baseline file instead of comparing.\n"
+"--benchtolerance x     How much slower is allowed, 0.1 for 10%.\n"
+"--benchcheats  x       Add x compare codes that change nothing, to time\n"
+"                         the cheat read path.\n"
+"--benchmovie   f       Instead of the speed run, time loading movie f and\n"
+"                         loading a savestate carrying it, playing it on\n"
+"                         ROM p for benchframes frames first.\n"
+"--benchgen     d       Write a synthetic test ROM for every mapper to\n"
+"                         directory d and exit.\n"
+"--benchopll    x       Check the VRC7 sound chip's block synthesis against\n"
+"                         its per-sample output over x random register write\n"
+"                         sequences and exit.\n"
+#ifdef FCEU_THREADED_CPU
+"--benchcores   {0|1}   Instead of the speed run, play ROM p on each CPU\n"
+"                         core, report the first instruction where they\n"
+"                         differ, then time each core.\n"
+#endif
+"--desync       p       Play the --desyncmovie movie on ROM p in two\n"
+"                         configurations at once, each in its own process,\n"
+"                         and report the first instruction where they part\n"
+"                         ways.  The workers start from the default config.\n"
+"--desyncmovie  f       The FM2 movie to compare on.\n"
+"--desynca      s       Options for the first configuration, e.g.\n"
+"                         \"--newppu 1\" or \"--desyncraminit 3\".\n"
+"--desyncb      s       Options for the second configuration.\n"
+"--desyncbina   f       Run the first configuration with fceux binary f,\n"
+"                         to compare two builds.  Default is this one.\n"
+"--desyncbinb   f       Binary for the second configuration.\n"
+"--desyncinterval x     Keep a savestate every x frames to trace from.\n"
+"--desyncout    f       Prefix for the work files and the report, f.txt.\n"
+"                         Default is the movie's name with .desync added.\n"
+"--desyncraminit x      RAM initialization to use instead of the movie's.\n"
 "--ripsubs      f       Convert movie's subtitles to srt\n"
 "--subtitles    {0|1}   Enable subtitle display\n"
 "--fourscore    {0|1}   Enable fourscore emulation\n"
@@ -630,6 +691,398 @@ static void ShowUsage(const char *prog)
 	
 }
 
+// Headless NSF rendering, for ripping music.  Plays one track for a fixed
+// time as fast as possible, records it and exits before any window is shown.
+static void nsfRenderAndExit(void)
+{
+	int track = 0, split = 0, rate = 48000, quality = 1;
+	double seconds = 0.0;
+	bool ok = true;
+	std::string wavFile, stemFile;
+
+	g_config->getOption("SDL.NSFRender.Track", &track);
+	g_config->getOption("SDL.NSFRender.Seconds", &seconds);
+
+	if ( (track <= 0) || (seconds <= 0.0) )
+	{
+		return;
+	}
+	g_config->getOption("SDL.Sound.RecordFile", &wavFile);
+	g_config->getOption("SDL.Sound.StemFile", &stemFile);
+	g_config->getOption("SDL.Sound.StemSplit", &split);
+	g_config->getOption("SDL.Sound.Rate", &rate);
+	g_config->getOption("SDL.Sound.Quality", &quality);
+
+	// No audio device is needed, but the emulated sound must be on.
+	KillSound();
+	FCEUI_Sound( GetNativeSoundRate( rate ) );
+	FCEUI_SetSoundQuality( (quality < 1) ? 1 : quality );
+
+	if ( wavFile.size() )
+	{
+		ok = ok && FCEUI_BeginWaveRecord( wavFile.c_str() );
+	}
+	if ( stemFile.size() )
+	{
+		ok = ok && FCEUI_BeginStemRecord( stemFile.c_str(), split ? true : false );
+	}
+
+	if ( ok )
+	{
+		ok = FCEUI_NSFRender( track, seconds );
+
+		if ( !ok )
+		{
+			printf("Error: --nsftrack needs an NSF file to be loaded\n");
+		}
+	}
+	else
+	{
+		printf("Error: Could not open sound recording files\n");
+	}
+	FCEUI_EndWaveRecord();
+	FCEUI_EndStemRecord();
+
+	fceuWrapperClose();
+
+	exit( ok ? 0 : -1 );
+}
+
+static void benchmarkProgress(const BENCHMARKRESULT &r)
+{
+	if ( !r.loaded )
+	{
+		printf("%s: could not be loaded\n", r.path.c_str());
+		return;
+	}
+	printf("%8.1f fps %7.2f MIPS  %08X  %s\n",
+		(r.seconds > 0) ? r.frames / r.seconds : 0.0,
+		(r.seconds > 0) ? r.instructions / r.seconds / 1e6 : 0.0,
+		r.hashes.size() ? r.hashes.back() : 0, r.path.c_str() );
+	fflush(stdout);
+}
+
+#ifdef FCEU_THREADED_CPU
+// Checks the threaded CPU core against the switch one instruction by
+// instruction, then times the whole set on each.  Returns the number of ROMs
+// where they differ.
+static int benchmarkCores( const std::string &path, int frames, int interval )
+{
+	std::string report;
+	bool keep = X6502_threaded;
+	int n = FCEUI_BenchmarkCompareCores( path.c_str(), frames, report );
+
+	if ( n < 0 )
+	{
+		printf("Error: %s does not exist\n", path.c_str());
+		return 1;
+	}
+	printf("%s%i ROMs differ between the CPU cores\n", report.c_str(), n);
+
+	for (int threaded = 0; threaded < 2; threaded++)
+	{
+		std::vector<BENCHMARKRESULT> results;
+		double seconds = 0, instructions = 0;
+
+		X6502_threaded = threaded != 0;
+		FCEUI_Benchmark( path.c_str(), frames, interval, 0, results, NULL );
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			seconds += results[i].seconds;
+			instructions += results[i].instructions;
+		}
+		printf("%7.2f MIPS  %s core\n", (seconds > 0) ? instructions / seconds / 1e6 : 0.0,
+				threaded ? "threaded" : "switch");
+	}
+	X6502_threaded = keep;
+	fflush(stdout);
+
+	return n;
+}
+#endif
+
+// Headless benchmark, for checking emulation speed and accuracy over a set of
+// ROMs.  Runs each one for a fixed number of frames, optionally compares the
+// results against a saved baseline and exits before any window is shown.
+static void benchmarkAndExit(void)
+{
+	int frames = 600, interval = 60, cheats = 0, update = 0, rate = 48000, opll = 0, failures = 0;
+	double tolerance = 0.1;
+	std::string path, baseline, genDir, movie;
+	std::vector<BENCHMARKRESULT> results;
+#ifdef FCEU_THREADED_CPU
+	int cores = 0;
+
+	g_config->getOption("SDL.Benchmark.Cores", &cores);
+#endif
+
+	g_config->getOption("SDL.Benchmark.Path", &path);
+	g_config->setOption("SDL.Benchmark.Path", "");
+	g_config->getOption("SDL.Benchmark.Generate", &genDir);
+	g_config->setOption("SDL.Benchmark.Generate", "");
+	g_config->getOption("SDL.Benchmark.OPLL", &opll);
+	g_config->setOption("SDL.Benchmark.OPLL", 0);
+
+	if ( path.empty() && genDir.empty() && (opll <= 0) )
+	{
+		return;
+	}
+	g_config->getOption("SDL.Benchmark.Frames", &frames);
+	g_config->getOption("SDL.Benchmark.Interval", &interval);
+	g_config->getOption("SDL.Benchmark.Baseline", &baseline);
+	g_config->getOption("SDL.Benchmark.Update", &update);
+	g_config->getOption("SDL.Benchmark.Tolerance", &tolerance);
+	g_config->getOption("SDL.Benchmark.Cheats", &cheats);
+	g_config->getOption("SDL.Benchmark.Movie", &movie);
+	g_config->getOption("SDL.Sound.Rate", &rate);
+
+	if ( genDir.size() )
+	{
+		int count = FCEUI_GenerateBenchmarkROMs( genDir.c_str() );
+
+		if ( count < 0 )
+		{
+			printf("Error: Could not write test ROMs to %s\n", genDir.c_str());
+			failures++;
+		}
+		else
+		{
+			printf("%i test ROMs written to %s\n", count, genDir.c_str());
+		}
+	}
+
+	if ( opll > 0 )
+	{
+		// Ten seconds of sound at 48 kHz for each sequence.
+		std::string report;
+		int n = FCEUI_BenchmarkCheckOPLL( opll, 480000, report );
+
+		printf("%s%i of %i VRC7 sequences differ from per-sample output\n", report.c_str(), n, opll);
+		failures += n;
+	}
+
+	if ( path.size() )
+	{
+		// Sound is part of what is being measured, but no device is needed.
+		KillSound();
+		FCEUI_Sound( GetNativeSoundRate( rate ) );
+
+		if ( movie.size() )
+		{
+			const int repeats = 10;
+			double loadSeconds, stateSeconds;
+
+			if ( !FCEUI_BenchmarkMovie( path.c_str(), movie.c_str(), frames, repeats, loadSeconds, stateSeconds ) )
+			{
+				printf("Error: Could not play %s on %s\n", movie.c_str(), path.c_str());
+				failures++;
+			}
+			else
+			{
+				printf("%9.2f ms  movie load      %s\n", loadSeconds * 1000 / repeats, movie.c_str());
+				printf("%9.2f ms  savestate load  at frame %i\n", stateSeconds * 1000 / repeats, frames);
+			}
+		}
+#ifdef FCEU_THREADED_CPU
+		else if ( cores )
+		{
+			failures += benchmarkCores( path, frames, interval );
+		}
+#endif
+		else if ( FCEUI_Benchmark( path.c_str(), frames, interval, cheats, results, benchmarkProgress ) < 0 )
+		{
+			printf("Error: %s does not exist\n", path.c_str());
+			failures++;
+		}
+		else if ( baseline.size() && update )
+		{
+			if ( !FCEUI_SaveBenchmarkBaseline( baseline.c_str(), results ) )
+			{
+				printf("Error: Could not write %s\n", baseline.c_str());
+				failures++;
+			}
+		}
+		else if ( baseline.size() )
+		{
+			std::string report;
+			int n = FCEUI_CompareBenchmarkBaseline( baseline.c_str(), results, tolerance, report );
+
+			if ( n < 0 )
+			{
+				printf("Error: Could not read %s\n", baseline.c_str());
+				failures++;
+			}
+			else
+			{
+				printf("%s%i of %i ROMs differ from the baseline\n", report.c_str(), n, (int)results.size());
+				failures += n;
+			}
+		}
+	}
+
+	fceuWrapperClose();
+
+	exit( failures ? -1 : 0 );
+}
+
+// Starts the workers for both sides of a desync search and waits for them.
+static bool runDesyncWorkers( const std::string program[2], const std::string args[2],
+		const std::string out[2], const std::string &path, const std::string &movie,
+		int interval, int traceFrame )
+{
+	QProcess proc[2];
+	bool ok = true;
+
+	for (int i=0; i<2; i++)
+	{
+		QStringList list;
+		std::istringstream words( args[i] );
+		std::string word;
+
+		while ( words >> word )
+		{
+			list << QString::fromStdString( word );
+		}
+		list << "-platform" << "offscreen" << "--no-config" << "1";
+		list << "--desync" << QString::fromStdString( path );
+		list << "--desyncmovie" << QString::fromStdString( movie );
+		list << "--desyncinterval" << QString::number( interval );
+		list << "--desynctrace" << QString::number( traceFrame );
+		list << "--desyncworker" << QString::fromStdString( out[i] );
+
+		proc[i].setProcessChannelMode( QProcess::ForwardedErrorChannel );
+		proc[i].setStandardOutputFile( QProcess::nullDevice() );
+		proc[i].start( QString::fromStdString( program[i] ), list );
+	}
+	for (int i=0; i<2; i++)
+	{
+		if ( !proc[i].waitForFinished(-1) || (proc[i].exitStatus() != QProcess::NormalExit) || proc[i].exitCode() )
+		{
+			printf("Error: The worker for %s failed\n", out[i].c_str());
+			ok = false;
+		}
+	}
+	return ok;
+}
+
+// Headless desync search.  Each configuration plays the movie in its own
+// process, hashing the CPU state every frame; the first frame whose hashes
+// differ is then played again from a savestate in both, tracing every
+// instruction, and the traces compared.  A worker is this same program
+// started with --desyncworker.
+static void desyncAndExit(void)
+{
+	int interval = 600, ramInit = -1, traceFrame = -1, frame, cycleFrame;
+	std::string path, movie, worker, prefix, args[2], program[2], out[2];
+
+	g_config->getOption("SDL.Desync.Path", &path);
+	g_config->setOption("SDL.Desync.Path", "");
+	g_config->getOption("SDL.Desync.Worker", &worker);
+	g_config->setOption("SDL.Desync.Worker", "");
+
+	if ( path.empty() )
+	{
+		return;
+	}
+	g_config->getOption("SDL.Desync.Movie", &movie);
+	g_config->getOption("SDL.Desync.Interval", &interval);
+	g_config->getOption("SDL.Desync.RamInit", &ramInit);
+	g_config->getOption("SDL.Desync.TraceFrame", &traceFrame);
+
+	if ( worker.size() )
+	{
+		bool ok;
+
+		g_config->getOption("SDL.NewPPU", &newppu);
+
+		if ( traceFrame < 0 )
+		{
+			ok = FCEUI_DesyncRun( path.c_str(), movie.c_str(), ramInit, interval, worker.c_str() );
+		}
+		else
+		{
+			ok = FCEUI_DesyncTrace( path.c_str(), movie.c_str(), ramInit, worker.c_str(), traceFrame );
+		}
+		if ( !ok )
+		{
+			fprintf(stderr, "Error: Could not play %s on %s\n", movie.c_str(), path.c_str());
+		}
+		fceuWrapperClose();
+
+		exit( ok ? 0 : -1 );
+	}
+
+	g_config->getOption("SDL.Desync.ArgsA", &args[0]);
+	g_config->getOption("SDL.Desync.ArgsB", &args[1]);
+	g_config->getOption("SDL.Desync.ProgramA", &program[0]);
+	g_config->getOption("SDL.Desync.ProgramB", &program[1]);
+	g_config->getOption("SDL.Desync.Output", &prefix);
+
+	if ( prefix.empty() )
+	{
+		prefix = movie + ".desync";
+	}
+	out[0] = prefix + ".a";
+	out[1] = prefix + ".b";
+
+	for (int i=0; i<2; i++)
+	{
+		if ( program[i].empty() )
+		{
+			program[i] = QCoreApplication::applicationFilePath().toStdString();
+		}
+	}
+
+	printf("Playing %s in both configurations...\n", movie.c_str());
+
+	if ( !runDesyncWorkers( program, args, out, path, movie, interval, -1 ) )
+	{
+		fceuWrapperClose();
+		exit(-1);
+	}
+	if ( !FCEUI_DesyncCompare( out[0].c_str(), out[1].c_str(), frame, cycleFrame ) )
+	{
+		printf("Error: Could not read %s or %s\n", out[0].c_str(), out[1].c_str());
+		fceuWrapperClose();
+		exit(-1);
+	}
+	if ( frame < 0 )
+	{
+		printf("No desync: the CPU state agrees after every frame\n");
+		if ( cycleFrame >= 0 )
+		{
+			printf("The cycle counts differ after frame %i\n", cycleFrame);
+		}
+		fceuWrapperClose();
+		exit(0);
+	}
+
+	printf("Tracing frame %i in both configurations...\n", frame);
+
+	std::string report;
+
+	if ( !runDesyncWorkers( program, args, out, path, movie, interval, frame ) ||
+	     !FCEUI_DesyncReport( out[0].c_str(), out[1].c_str(), frame, cycleFrame, report ) )
+	{
+		fceuWrapperClose();
+		exit(-1);
+	}
+	printf("%s", report.c_str());
+
+	FILE *f = fopen( (prefix + ".txt").c_str(), "w" );
+
+	if ( f )
+	{
+		fputs( report.c_str(), f );
+		fclose(f);
+	}
+	fceuWrapperClose();
+
+	// A desync found is a result, not an error, but scripts want to tell.
+	exit(1);
+}
+
 int  fceuWrapperInit( int argc, char *argv[] )
 {
 	int opt, error;
@@ -729,6 +1182,66 @@ int  fceuWrapperInit( int argc, char *argv[] )
 	  SDL_Quit();
 	  return 0;
 	}
+	// scan a directory into the ROM library index and/or search the index
+	{
+		std::string scanDir, findText;
+		int scanThreads;
+
+		g_config->getOption ("SDL.ScanLibrary", &scanDir);
+		g_config->setOption ("SDL.ScanLibrary", "");
+		g_config->getOption ("SDL.FindRom", &findText);
+		g_config->setOption ("SDL.FindRom", "");
+		g_config->getOption ("SDL.ScanThreads", &scanThreads);
+
+		if (!scanDir.empty() || !findText.empty())
+		{
+			if (!scanDir.empty())
+			{
+				int count = FCEUI_ScanRomLibrary (scanDir.c_str(), scanThreads, NULL);
+
+				if (count < 0)
+				{
+					printf ("Error: could not scan %s\n", scanDir.c_str());
+				}
+				else
+				{
+					printf ("%i ROMs found in %s\n", count, scanDir.c_str());
+				}
+			}
+			if (!findText.empty())
+			{
+				std::vector<const ROMLIBENTRY*> matches;
+
+				FCEUI_FindInRomLibrary (findText.c_str(), matches);
+
+				for (size_t i=0; i<matches.size(); i++)
+				{
+					const ROMLIBENTRY *e = matches[i];
+					const char *region[4] = { "NTSC", "PAL", "Dual", "Dendy" };
+					char mapper[64];
+
+					if (e->mapper < 0)
+					{
+						snprintf (mapper, sizeof(mapper), "%s", e->board.c_str());
+					}
+					else
+					{
+						snprintf (mapper, sizeof(mapper), "%i", e->mapper);
+					}
+					printf ("%s\t%s\t%s\t%s\t%08X\n", e->path.c_str(), e->format.c_str(),
+						mapper, ((e->region >= 0) && (e->region < 4)) ? region[e->region] : "?", e->crc32);
+				}
+				printf ("%i matches\n", (int)matches.size());
+			}
+			DriverKill();
+			SDL_Quit();
+			exit(0);
+		}
+	}
+
+	benchmarkAndExit();
+	desyncAndExit();
+
 	// If x/y res set to 0, store current display res in SDL.LastX/YRes
 	int yres, xres;
 	g_config->getOption("SDL.XResolution", &xres);
@@ -773,6 +1286,7 @@ int  fceuWrapperInit( int argc, char *argv[] )
 	g_config->getOption("SDL.SubtitlesOnAVI"         , &subtitlesOnAVI);
 	g_config->getOption("SDL.AutoMovieBackup"        , &autoMovieBackup);
 	g_config->getOption("SDL.MovieFullSaveStateLoads", &fullSaveStateLoads);
+	g_config->getOption("SDL.MovieSeekCacheMB"       , &movieSeekCacheMB);
 
 	// check to see if movie messages are disabled
 	int mm;
@@ -913,6 +1427,8 @@ int  fceuWrapperInit( int argc, char *argv[] )
 		}
 		g_config->setOption("SDL.LastOpenFile", argv[romIndex]);
 		g_config->save();
+
+		nsfRenderAndExit();
 	}
 
 	aviRecordInit();
@@ -1339,7 +1855,6 @@ FCEUFILE* FCEUD_OpenArchive(ArchiveScanRecord& asr, std::string& fname, std::str
 	unz_file_info fi;
 	char filename[512];
 	char foundFile = 0;
-	void *tmpMem = NULL;
 	std::string searchFile;
 
 	if ( innerFilename != NULL )
@@ -1426,25 +1941,13 @@ FCEUFILE* FCEUD_OpenArchive(ArchiveScanRecord& asr, std::string& fname, std::str
 		return fp;
 	}
 
-	tmpMem = ::malloc( fi.uncompressed_size );
-
-	if ( tmpMem == NULL )
+	if ( unzOpenCurrentFile( zf ) != UNZ_OK )
 	{
 		unzClose( zf );
 		return fp;
 	}
 
-	EMUFILE_MEMORY* ms = new EMUFILE_MEMORY(fi.uncompressed_size);
-
-	unzOpenCurrentFile( zf );
-	unzReadCurrentFile( zf, tmpMem, fi.uncompressed_size );
-	unzCloseCurrentFile( zf );
-
-	ms->fwrite( tmpMem, fi.uncompressed_size );
-
-	free( tmpMem );
-
-	//if we extracted the file correctly
+	// the stream inflates the file as it is read and closes zf when done
 	fp = new FCEUFILE();
 	fp->archiveFilename = fname;
 	fp->filename = searchFile;
@@ -1452,11 +1955,8 @@ FCEUFILE* FCEUD_OpenArchive(ArchiveScanRecord& asr, std::string& fname, std::str
 	fp->archiveIndex = ret;
 	fp->mode = FCEUFILE::READ;
 	fp->size = fi.uncompressed_size;
-	fp->stream = ms;
+	fp->stream = FCEU_OpenZipStream( zf, fi.uncompressed_size );
 	fp->archiveCount = (int)asr.numFilesInArchive;
-	ms->fseek(0,SEEK_SET); //rewind so that the rom analyzer sees a freshly opened file
-
-	unzClose( zf );
 
 	return fp;
 }
@@ -1476,7 +1976,6 @@ FCEUFILE* FCEUD_OpenArchiveIndex(ArchiveScanRecord& asr, std::string &fname, int
 	unz_file_info fi;
 	char filename[512];
 	char foundFile = 0;
-	void *tmpMem = NULL;
 
 	zf = unzOpen( fname.c_str() );
 
@@ -1514,25 +2013,13 @@ FCEUFILE* FCEUD_OpenArchiveIndex(ArchiveScanRecord& asr, std::string &fname, int
 		return fp;
 	}
 
-	tmpMem = ::malloc( fi.uncompressed_size );
-
-	if ( tmpMem == NULL )
+	if ( unzOpenCurrentFile( zf ) != UNZ_OK )
 	{
 		unzClose( zf );
 		return fp;
 	}
 
-	EMUFILE_MEMORY* ms = new EMUFILE_MEMORY(fi.uncompressed_size);
-
-	unzOpenCurrentFile( zf );
-	unzReadCurrentFile( zf, tmpMem, fi.uncompressed_size );
-	unzCloseCurrentFile( zf );
-
-	ms->fwrite( tmpMem, fi.uncompressed_size );
-
-	free( tmpMem );
-
-	//if we extracted the file correctly
+	// the stream inflates the file as it is read and closes zf when done
 	fp = new FCEUFILE();
 	fp->archiveFilename = fname;
 	fp->filename = filename;
@@ -1540,11 +2027,8 @@ FCEUFILE* FCEUD_OpenArchiveIndex(ArchiveScanRecord& asr, std::string &fname, int
 	fp->archiveIndex = ret;
 	fp->mode = FCEUFILE::READ;
 	fp->size = fi.uncompressed_size;
-	fp->stream = ms;
+	fp->stream = FCEU_OpenZipStream( zf, fi.uncompressed_size );
 	fp->archiveCount = (int)asr.numFilesInArchive;
-	ms->fseek(0,SEEK_SET); //rewind so that the rom analyzer sees a freshly opened file
-
-	unzClose( zf );
 
 	return fp;
 }
@@ -1586,7 +2070,8 @@ bool FCEUD_ShouldDrawInputAids(void)
 	return drawInputAidsEnable;
 }
 
-void FCEUD_TurboOn	 (void) { /* TODO */ };
-void FCEUD_TurboOff   (void) { /* TODO */ };
+// bit 0 follows the turbo hotkey, bit 1 is turbo requested by the core or Lua
+void FCEUD_TurboOn	 (void) { NoWaiting |= 0x02; };
+void FCEUD_TurboOff   (void) { NoWaiting &= ~0x02; };
 void FCEUD_TurboToggle(void) { /* TODO */ };
 
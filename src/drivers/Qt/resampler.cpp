@@ -0,0 +1,217 @@
+/* FCE Ultra - NES/Famicom Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+/// \file
+/// \brief Streaming arbitrary ratio audio resampler.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Qt/resampler.h"
+
+#define  RESAMPLE_PHASES       256
+#define  RESAMPLE_BASE_TAPS     16   // Half width of kernel when not decimating
+#define  RESAMPLE_MAX_TAPS      64   // Upper bound on kernel half width
+#define  RESAMPLE_HIST_SIZE   4096
+
+// Fraction of the output Nyquist frequency to pass through.
+static const double passBand = 0.95;
+
+//----------------------------------------------------------------------------
+AudioResampler::AudioResampler(void)
+{
+	ratio    = 1.0;
+	step     = 1.0;
+	frac     = 0.0;
+	cutoff   = 0.0;
+	halfTaps = 0;
+	numTaps  = 0;
+	histPos  = 0;
+	kernel   = NULL;
+
+	hist = (float*)malloc( RESAMPLE_HIST_SIZE * sizeof(float) );
+
+	buildKernel( passBand );
+
+	reset();
+}
+//----------------------------------------------------------------------------
+AudioResampler::~AudioResampler(void)
+{
+	if ( kernel )
+	{
+		free( kernel ); kernel = NULL;
+	}
+	if ( hist )
+	{
+		free( hist ); hist = NULL;
+	}
+}
+//----------------------------------------------------------------------------
+void AudioResampler::reset(void)
+{
+	memset( hist, 0, RESAMPLE_HIST_SIZE * sizeof(float) );
+
+	// Always keep the maximum kernel width worth of history so that
+	// the kernel can be widened without losing continuity.
+	histPos = 2 * RESAMPLE_MAX_TAPS;
+	frac    = 0.0;
+}
+//----------------------------------------------------------------------------
+void AudioResampler::setRatio( double r )
+{
+	double c;
+
+	if ( r <= 0.0 )
+	{
+		return;
+	}
+	ratio = r;
+	step  = 1.0 / r;
+
+	c = passBand * ( (r < 1.0) ? r : 1.0 );
+
+	// Small ratio adjustments from rate control should not cause
+	// the kernel to be rebuilt on every call.
+	if ( fabs( c - cutoff ) > (0.01 * cutoff) )
+	{
+		buildKernel( c );
+	}
+}
+//----------------------------------------------------------------------------
+int AudioResampler::maxOutput( int inCount )
+{
+	return (int)ceil( (double)inCount * ratio ) + 2;
+}
+//----------------------------------------------------------------------------
+void AudioResampler::buildKernel( double c )
+{
+	int p, k;
+	double f, x, w, s, sum;
+	float *row;
+
+	cutoff   = c;
+	halfTaps = (int)ceil( (double)RESAMPLE_BASE_TAPS / c );
+
+	if ( halfTaps > RESAMPLE_MAX_TAPS )
+	{
+		halfTaps = RESAMPLE_MAX_TAPS;
+	}
+	numTaps = 2 * halfTaps;
+
+	if ( kernel )
+	{
+		free( kernel );
+	}
+	kernel = (float*)malloc( (RESAMPLE_PHASES+1) * numTaps * sizeof(float) );
+
+	// One extra phase row so that interpolation between
+	// phases never needs to wrap around.
+	for (p=0; p<=RESAMPLE_PHASES; p++)
+	{
+		f   = (double)p / (double)RESAMPLE_PHASES;
+		row = &kernel[ p * numTaps ];
+		sum = 0.0;
+
+		for (k=0; k<numTaps; k++)
+		{
+			x = (double)(k - (halfTaps-1)) - f;
+
+			// Blackman window over [-halfTaps, halfTaps]
+			w = 0.42 + 0.50 * cos( M_PI * x / halfTaps ) + 0.08 * cos( 2.0 * M_PI * x / halfTaps );
+
+			if ( fabs(x) < 1e-9 )
+			{
+				s = c;
+			}
+			else
+			{
+				s = sin( M_PI * c * x ) / (M_PI * x);
+			}
+			row[k] = (float)(s * w);
+
+			sum += row[k];
+		}
+
+		// Normalize each phase for unity gain at DC.
+		for (k=0; k<numTaps; k++)
+		{
+			row[k] = (float)(row[k] / sum);
+		}
+	}
+}
+//----------------------------------------------------------------------------
+int AudioResampler::process( const int32_t *in, int inCount, int32_t *out, int outMax )
+{
+	int i, k, p, outCount = 0;
+	double fp, a, y;
+	float acc0, acc1;
+	const float *win, *k0, *k1;
+
+	for (i=0; i<inCount; i++)
+	{
+		if ( histPos >= RESAMPLE_HIST_SIZE )
+		{
+			memmove( hist, &hist[ histPos - 2*RESAMPLE_MAX_TAPS ], 2 * RESAMPLE_MAX_TAPS * sizeof(float) );
+
+			histPos = 2 * RESAMPLE_MAX_TAPS;
+		}
+		hist[ histPos++ ] = (float)in[i];
+
+		win = &hist[ histPos - numTaps ];
+
+		// Output samples lie between window positions
+		// halfTaps-1 and halfTaps.
+		while ( frac < 1.0 )
+		{
+			fp = frac * RESAMPLE_PHASES;
+			p  = (int)fp;
+			a  = fp - (double)p;
+
+			k0 = &kernel[ p * numTaps ];
+			k1 = k0 + numTaps;
+
+			acc0 = acc1 = 0.0f;
+
+			for (k=0; k<numTaps; k++)
+			{
+				acc0 += win[k] * k0[k];
+				acc1 += win[k] * k1[k];
+			}
+			y = acc0 + a * (acc1 - acc0);
+
+			if ( y > 32767.0 )
+			{
+				y = 32767.0;
+			}
+			else if ( y < -32768.0 )
+			{
+				y = -32768.0;
+			}
+
+			if ( outCount < outMax )
+			{
+				out[ outCount++ ] = (int32_t)lrint(y);
+			}
+			frac += step;
+		}
+		frac -= 1.0;
+	}
+	return outCount;
+}
+//----------------------------------------------------------------------------
@@ -0,0 +1,47 @@
+// resampler.h
+//
+#pragma once
+
+#include <stdint.h>
+
+// Streaming arbitrary ratio audio resampler.
+//
+// Uses a windowed sinc kernel stored as a polyphase table, with
+// linear interpolation between adjacent phases. The ratio may be
+// changed between calls to process without introducing discontinuities,
+// which allows it to be driven by a dynamic rate control loop.
+class AudioResampler
+{
+	public:
+		AudioResampler(void);
+		~AudioResampler(void);
+
+		void  reset(void);
+
+		// Ratio is output rate divided by input rate.
+		void  setRatio( double ratio );
+		double getRatio(void){ return ratio; }
+
+		// Returns an upper bound on the number of output samples
+		// that process can produce for inCount input samples.
+		int   maxOutput( int inCount );
+
+		// Resample inCount samples from in to out.
+		// Returns number of samples written to out.
+		int   process( const int32_t *in, int inCount, int32_t *out, int outMax );
+
+	private:
+		void  buildKernel( double cutoff );
+
+		double  ratio;
+		double  step;
+		double  frac;
+		double  cutoff;
+
+		int     halfTaps;
+		int     numTaps;
+		int     histPos;
+
+		float  *kernel;
+		float  *hist;
+};
@@ -27,22 +27,78 @@
 #include "utils/memory.h"
 #include "Qt/nes_shm.h"
 #include "Qt/throttle.h"
+#include "Qt/resampler.h"
 
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <atomic>
 
 extern Config *g_config;
 
-static volatile int *s_Buffer = 0;
+/**
+ * Wait-free single producer/single consumer sample ring. The emulator
+ * thread is the only writer of head and the SDL audio callback is the
+ * only writer of tail, each index lives on its own cache line so that
+ * the two threads do not false share. One slot is always left empty to
+ * tell a full ring from an empty one.
+ */
+struct sndRingBuf_t
+{
+	alignas(64) std::atomic<unsigned int> head;
+	alignas(64) std::atomic<unsigned int> tail;
+	alignas(64) int *data;
+	unsigned int  slots;
+
+	// Samples dropped by the producer because the ring was full.
+	std::atomic<unsigned int> overrunCount;
+
+	unsigned int count(void)
+	{
+		unsigned int h = head.load(std::memory_order_acquire);
+		unsigned int t = tail.load(std::memory_order_acquire);
+
+		return (h >= t) ? (h - t) : (slots - t + h);
+	}
+
+	unsigned int capacity(void)
+	{
+		return slots ? (slots - 1) : 0;
+	}
+
+	// Producer side, never blocks. Returns number of samples accepted.
+	unsigned int write( const int32 *buf, unsigned int n )
+	{
+		unsigned int h = head.load(std::memory_order_relaxed);
+		unsigned int t = tail.load(std::memory_order_acquire);
+		unsigned int avail = (h >= t) ? (slots - 1 - h + t) : (t - h - 1);
+		unsigned int i;
+
+		if ( n > avail )
+		{
+			n = avail;
+		}
+		for (i=0; i<n; i++)
+		{
+			data[h] = buf[i];
+
+			if ( ++h == slots ) h = 0;
+		}
+		head.store(h, std::memory_order_release);
+
+		return n;
+	}
+};
+
+static sndRingBuf_t s_Ring;
 static unsigned int s_BufferSize;
-static unsigned int s_BufferSize25;
-static unsigned int s_BufferSize50;
-static unsigned int s_BufferSize75;
-static unsigned int s_BufferRead;
-static unsigned int s_BufferWrite;
-static volatile unsigned int s_BufferIn;
 static unsigned int s_SampleRate = 44100;
+static unsigned int s_EmuSampleRate = 44100;
+static double s_FrmRateAdjRatio = 1.0;
+static double s_BufferFillAvg = 0.50;
+static AudioResampler *resampler = NULL;
+static int32 *s_ResampleBuf = NULL;
+static int    s_ResampleBufSize = 0;
 static double noiseGate = 0.0;
 static double noiseGateRate = 0.010;
 static bool   noiseGateActive = true;
@@ -50,6 +106,11 @@ static bool   muteSoundOutput = false;
 
 static int s_mute = 0;
 
+// Dynamic rate control: maximum deviation from the nominal
+// resampling ratio used to hold the buffer at its target fill level.
+static const double rateCtrlMaxDelta = 0.005;
+static const double rateCtrlTargetFill = 0.50;
+
 extern int EmulationPaused;
 extern double frmRateAdjRatio;
 extern double g_fpsScale;
@@ -62,15 +123,25 @@ fillaudio(void *udata,
 		uint8 *stream,
 		int len)
 {
-	char bufStarveDetected = 0;
 	static int16_t sample = 0;
 	char mute;
-	//unsigned int starve_lp = nes_shm->sndBuf.starveCounter;
+	unsigned int rd, wr, avail;
 	int16 *tmps = (int16*)stream;
 	len >>= 1;
 
+	if ( s_Ring.data == NULL )
+	{
+		memset( stream, 0, len * sizeof(int16) );
+		return;
+	}
 	mute = EmulationPaused || muteSoundOutput;
 
+	// Take a snapshot of the producer index once per callback, anything
+	// written after this point will be picked up on the next callback.
+	rd = s_Ring.tail.load(std::memory_order_relaxed);
+	wr = s_Ring.head.load(std::memory_order_acquire);
+	avail = (wr >= rd) ? (wr - rd) : (s_Ring.slots - rd + wr);
+
 	if ( mute || noiseGateActive )
 	{
 		// This noise gate helps avoid abrupt snaps in audio
@@ -89,7 +160,7 @@ fillaudio(void *udata,
 			}
 			else
 			{
-				if ( s_BufferIn )
+				if ( avail )
 				{	
 					noiseGate += noiseGateRate;
 
@@ -100,11 +171,11 @@ fillaudio(void *udata,
 					}
 				}
 			}
-			if (s_BufferIn) 
+			if (avail) 
 			{
-				sample = s_Buffer[s_BufferRead] * noiseGate;
-				s_BufferRead = (s_BufferRead + 1) % s_BufferSize;
-				s_BufferIn--;
+				sample = s_Ring.data[rd] * noiseGate;
+				if ( ++rd == s_Ring.slots ) rd = 0;
+				avail--;
 
 				*tmps = sample;
 			}
@@ -123,16 +194,15 @@ fillaudio(void *udata,
 	{
 		while (len) 
 		{
-			if (s_BufferIn) 
+			if (avail) 
 			{
-				sample = s_Buffer[s_BufferRead];
-				s_BufferRead = (s_BufferRead + 1) % s_BufferSize;
-				s_BufferIn--;
+				sample = s_Ring.data[rd];
+				if ( ++rd == s_Ring.slots ) rd = 0;
+				avail--;
 			} else {
         	 		// Retain last known sample value, helps avoid clicking
         	 		// noise when sound system is starved of audio data.
 				//sample = 0; 
-				bufStarveDetected = 1;
 				nes_shm->sndBuf.starveCounter++;
 			}
 
@@ -143,11 +213,7 @@ fillaudio(void *udata,
 			len--;
 		}
 	}
-	if ( bufStarveDetected )
-	{
-		//s_StarveCounter = nes_shm->sndBuf.starveCounter - starve_lp;
-		//printf("Starve:%u\n", s_StarveCounter );
-	}
+	s_Ring.tail.store(rd, std::memory_order_release);
 }
 
 /**
@@ -159,7 +225,6 @@ InitSound()
 	int sound, soundrate, soundbufsize, soundvolume, soundtrianglevolume, soundsquare1volume, soundsquare2volume, soundnoisevolume, soundpcmvolume, soundq;
 	SDL_AudioSpec spec;
 	const char *driverName;
-	int frmRateSampleAdj = 0;
 
 	g_config->getOption("SDL.Sound", &sound);
 	if (!sound) 
@@ -201,9 +266,6 @@ InitSound()
 	{
 		s_BufferSize = spec.samples * 2;
 	}
-	s_BufferSize25 =    s_BufferSize/4;
-	s_BufferSize50 =    s_BufferSize/2;
-	s_BufferSize75 = (3*s_BufferSize)/4;
 
 	//printf("Audio Buffer: %i  %i \n", spec.samples, s_BufferSize );
 
@@ -211,13 +273,15 @@ InitSound()
 	noiseGateRate = 1.0 / (double)spec.samples;
 	noiseGateActive = true;
 
-	s_Buffer = (int *)FCEU_dmalloc(sizeof(int) * s_BufferSize);
+	s_Ring.data = (int *)FCEU_dmalloc(sizeof(int) * (s_BufferSize+1));
 
-	if (!s_Buffer)
+	if (!s_Ring.data)
 	{
 		return 0;
 	}
-	s_BufferRead = s_BufferWrite = s_BufferIn = 0;
+	s_Ring.slots = s_BufferSize+1;
+	s_Ring.head.store(0);
+	s_Ring.tail.store(0);
 
 	if (SDL_OpenAudio(&spec, 0) < 0)
 	{
@@ -234,13 +298,22 @@ InitSound()
 		fprintf(stderr, "Loading SDL sound with %s driver...\n", driverName);
 	}
  
-	frmRateSampleAdj = (int)( ( ((double)soundrate) * getFrameRateAdjustmentRatio()) - ((double)soundrate) );
-	//frmRateSampleAdj = 0;
-	//printf("Sample Rate Adjustment: %+i\n", frmRateSampleAdj );
+	// The emulator always renders at one of the rates that the core has
+	// filter tables for, the resampler converts that to the device rate.
+	s_EmuSampleRate  = GetNativeSoundRate( soundrate );
+	s_FrmRateAdjRatio = getFrameRateAdjustmentRatio();
+	s_BufferFillAvg  = rateCtrlTargetFill;
+
+	if ( resampler == NULL )
+	{
+		resampler = new AudioResampler();
+	}
+	resampler->reset();
+	resampler->setRatio( (double)s_SampleRate / ((double)s_EmuSampleRate * s_FrmRateAdjRatio) );
 
 	FCEUI_SetSoundVolume(soundvolume);
 	FCEUI_SetSoundQuality(soundq);
-	FCEUI_Sound(soundrate + frmRateSampleAdj);
+	FCEUI_Sound(s_EmuSampleRate);
 	FCEUI_SetTriangleVolume(soundtrianglevolume);
 	FCEUI_SetSquare1Volume(soundsquare1volume);
 	FCEUI_SetSquare2Volume(soundsquare2volume);
@@ -250,13 +323,45 @@ InitSound()
 }
 
 
+/**
+ * Returns the rate the emulator core renders audio at for a given
+ * device sample rate. These are the rates that MakeFilters has
+ * coefficient tables for.
+ */
+uint32
+GetNativeSoundRate(uint32 deviceRate)
+{
+	static const uint32 nativeRates[] = { 44100, 48000, 96000 };
+	const int numRates = sizeof(nativeRates) / sizeof(nativeRates[0]);
+
+	// Prefer the lowest native rate at or above the device rate
+	// so that the resampler only ever needs to decimate.
+	for (int i=0; i<numRates; i++)
+	{
+		if ( nativeRates[i] >= deviceRate )
+		{
+			return nativeRates[i];
+		}
+	}
+	return nativeRates[numRates-1];
+}
+
+/**
+ * Returns the sample rate that the emulator core is rendering audio at.
+ */
+uint32
+GetEmuSoundRate(void)
+{
+	return s_EmuSampleRate;
+}
+
 /**
  * Returns the size of the audio buffer.
  */
 uint32
 GetMaxSound(void)
 {
-	return(s_BufferSize);
+	return(s_Ring.capacity());
 }
 
 /**
@@ -265,7 +370,7 @@ GetMaxSound(void)
 uint32
 GetWriteSound(void)
 {
-	return(s_BufferSize - s_BufferIn);
+	return(s_Ring.capacity() - s_Ring.count());
 }
 
 /**
@@ -275,161 +380,96 @@ void
 WriteSound(int32 *buf,
            int Count)
 {
+	double fill, ratio;
 
-	int uflowMode = 0;
-	int ovrFlowSkip = 1;
-	int udrFlowDup  = 1;
-	static int skipCounter = 0;
-
-	if ( NoWaiting & 0x01 )
+	if ( NoWaiting & 0x03 )
 	{	// During Turbo mode, don't bother with sound as
 		// overflowing the audio buffer can cause delays.
 		return;
 	}
-
-	if ( g_fpsScale >= 0.99995 )
+	if ( (resampler == NULL) || (s_Ring.data == NULL) )
 	{
-		uflowMode = 0;
-		ovrFlowSkip = (int)(g_fpsScale * 1000);
-
-		if ( s_BufferIn >= s_BufferSize50 )
-		{
-			ovrFlowSkip += 100;
-		}
+		return;
 	}
-	else
-	{
-		udrFlowDup = (int)(1.0 / g_fpsScale);
 
-		if ( udrFlowDup < 1 )
-		{
-			udrFlowDup = 1;
-		}
-		if ( s_BufferIn < s_BufferSize50 )
-		{
-			udrFlowDup++;
-		}
-		else if ( s_BufferIn > s_BufferSize75 )
-		{
-			udrFlowDup--;
-		}
-		uflowMode = (udrFlowDup > 1);
-	}
 	extern int EmulationPaused;
 	if (EmulationPaused == 0)
 	{
-		int waitCount = 0;
+		unsigned int outCount, written;
 
-		if ( uflowMode )
-		{	// Underflow mode
-			SDL_LockAudio();
-			while (Count)
-			{
-				if ( s_BufferIn == s_BufferSize )
-				{
-					SDL_UnlockAudio();
-					while (s_BufferIn == s_BufferSize) 
-					{
-						SDL_Delay(1); waitCount++;
+		// Dynamic rate control, nudge the resampling ratio so that the
+		// device buffer converges on its target fill level. The raw fill
+		// level is averaged as it moves in steps of the callback size.
+		fill = (double)s_Ring.count() / (double)s_Ring.capacity();
 
-						if ( waitCount > 1000 )
-						{
-							printf("Error: Sound sink is not draining... Breaking out of audio loop to prevent lockup.\n");
-							return;
-						}
-					}
-					SDL_LockAudio();
-				}
+		s_BufferFillAvg = (0.90 * s_BufferFillAvg) + (0.10 * fill);
 
-				for (int i=0; i<udrFlowDup; i++)
-				{
-					s_Buffer[s_BufferWrite] = *buf;
-					s_BufferWrite = (s_BufferWrite + 1) % s_BufferSize;
-            
-					s_BufferIn++;
-				}
-            
-				Count--;
-				buf++;
-			}
-			SDL_UnlockAudio();
-		}
-		else
-		{
-			if ( ovrFlowSkip <= 1000 )
-			{	// Perfect one to one realtime
-				skipCounter = 0;
+		// Emulation speed changes are applied as part of the resampling
+		// ratio, rather than by duplicating or skipping samples.
+		ratio = (double)s_SampleRate / ((double)s_EmuSampleRate * s_FrmRateAdjRatio * g_fpsScale);
 
-				SDL_LockAudio();
-				while (Count)
-				{
-					if (s_BufferIn == s_BufferSize) 
-					{
-						SDL_UnlockAudio();
-						while (s_BufferIn == s_BufferSize) 
-						{
-							SDL_Delay(1); waitCount++;
-
-							if ( waitCount > 1000 )
-							{
-								printf("Error: Sound sink is not draining... Breaking out of audio loop to prevent lockup.\n");
-								return;
-							}
-						}
-						SDL_LockAudio();
-					}
+		ratio *= 1.0 + rateCtrlMaxDelta * ((rateCtrlTargetFill - s_BufferFillAvg) / rateCtrlTargetFill);
 
-					s_Buffer[s_BufferWrite] = *buf;
-					Count--;
-					s_BufferWrite = (s_BufferWrite + 1) % s_BufferSize;
-            
-					s_BufferIn++;
-					buf++;
-				}
-				SDL_UnlockAudio();
-			}
-			else
-			{	// Overflow mode
-				SDL_LockAudio();
-				while (Count)
-				{
-					if (s_BufferIn == s_BufferSize) 
-					{
-						SDL_UnlockAudio();
-						while (s_BufferIn == s_BufferSize) 
-						{
-							SDL_Delay(1); waitCount++;
-
-							if ( waitCount > 1000 )
-							{
-								printf("Error: Sound sink is not draining... Breaking out of audio loop to prevent lockup.\n");
-								return;
-							}
-						}
-						SDL_LockAudio();
-					}
+		resampler->setRatio( ratio );
 
-					if ( skipCounter >= ovrFlowSkip )
-					{
-						s_Buffer[s_BufferWrite] = *buf;
-						s_BufferWrite = (s_BufferWrite + 1) % s_BufferSize;
-            
-						s_BufferIn++;
+		if ( resampler->maxOutput( Count ) > s_ResampleBufSize )
+		{
+			s_ResampleBufSize = resampler->maxOutput( Count );
 
-						skipCounter -= ovrFlowSkip;
-					}
-					skipCounter = (skipCounter+1000);
-            
-					Count--;
-					buf++;
-				}
-				SDL_UnlockAudio();
+			if ( s_ResampleBuf )
+			{
+				free( s_ResampleBuf );
 			}
+			s_ResampleBuf = (int32*)FCEU_dmalloc( sizeof(int32) * s_ResampleBufSize );
+
+			if ( s_ResampleBuf == NULL )
+			{
+				s_ResampleBufSize = 0;
+				return;
+			}
+		}
+		outCount = resampler->process( buf, Count, s_ResampleBuf, s_ResampleBufSize );
+
+		// Never wait on the audio thread, if the sink is not draining
+		// the excess is dropped and counted instead of stalling the frame.
+		written = s_Ring.write( s_ResampleBuf, outCount );
 
+		if ( written < outCount )
+		{
+			s_Ring.overrunCount.fetch_add( outCount - written, std::memory_order_relaxed );
 		}
 	}
 }
 
+/**
+ * Returns the number of samples that the audio callback
+ * had to make up due to the buffer running empty.
+ */
+uint32
+GetSoundStarveCount(void)
+{
+	return nes_shm->sndBuf.starveCounter;
+}
+
+/**
+ * Returns the number of samples dropped due to the buffer being full.
+ */
+uint32
+GetSoundOverrunCount(void)
+{
+	return s_Ring.overrunCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * Clear the audio buffer starve and overrun counters.
+ */
+void
+ResetSoundBufferCounters(void)
+{
+	nes_shm->sndBuf.starveCounter = 0;
+	s_Ring.overrunCount.store(0, std::memory_order_relaxed);
+}
+
 /**
  * Pause (1) or unpause (0) the audio output.
  */
@@ -448,9 +488,19 @@ KillSound(void)
 	FCEUI_Sound(0);
 	SDL_CloseAudio();
 	SDL_QuitSubSystem(SDL_INIT_AUDIO);
-	if(s_Buffer) {
-		free((void *)s_Buffer);
-		s_Buffer = 0;
+	if(s_Ring.data) {
+		free((void *)s_Ring.data);
+		s_Ring.data = 0;
+		s_Ring.slots = 0;
+	}
+	if(s_ResampleBuf) {
+		free(s_ResampleBuf);
+		s_ResampleBuf = 0;
+		s_ResampleBufSize = 0;
+	}
+	if(resampler) {
+		delete resampler;
+		resampler = NULL;
 	}
 	return 0;
 }
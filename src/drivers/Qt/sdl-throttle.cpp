@@ -189,6 +189,18 @@ int  getFrameTimingStats( struct frameTimingStat_t *stats )
 	stats->videoTimeDel.min = videoPeriodMin;
 	stats->videoTimeDel.max = videoPeriodMax;
 
+	stats->audio.starveCount  = GetSoundStarveCount();
+	stats->audio.overrunCount = GetSoundOverrunCount();
+
+	if ( GetMaxSound() > 0 )
+	{
+		stats->audio.bufFill = 1.0 - ((double)GetWriteSound() / (double)GetMaxSound());
+	}
+	else
+	{
+		stats->audio.bufFill = 0.0;
+	}
+
 	return 0;
 }
 
@@ -221,6 +233,8 @@ void resetFrameTiming(void)
 	frameIdleMin = 1.0;
 	videoPeriodMin = 1.0;
 	videoPeriodMax = 0.0;
+
+	ResetSoundBufferCounters();
 }
 
 /* LOGMUL = exp(log(2) / 3)
@@ -316,7 +330,7 @@ int highPrecSleep( double timeSeconds )
 int
 SpeedThrottle(void)
 {
-	if ( (g_fpsScale >= 32) || (NoWaiting & 0x01) )
+	if ( (g_fpsScale >= 32) || (NoWaiting & 0x03) )
 	{
 		return 0; /* Done waiting */
 	}
@@ -45,6 +45,12 @@ struct frameTimingStat_t
 
 	unsigned int lateCount;
 
+	struct {
+		unsigned int starveCount;
+		unsigned int overrunCount;
+		double  bufFill; // fraction of buffer in use
+	} audio;
+
 	bool enabled;
 };
 
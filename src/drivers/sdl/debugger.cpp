@@ -1714,6 +1714,12 @@ void FCEUD_TraceInstruction(uint8 *opcode, int size)
    // Place holder to allow for compiling. GTK GUI doesn't support this. Qt Does.
 }
 
+int FCEUD_TraceLoggerRunning(void)
+{
+   // Place holder to allow for compiling. GTK GUI doesn't support this. Qt Does.
+   return 0;
+}
+
 void FCEUD_UpdatePPUView(int scanline, int refreshchr)
 {
    // Place holder to allow for compiling. GTK GUI doesn't support this. Qt Does.
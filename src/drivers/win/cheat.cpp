@@ -774,18 +774,15 @@ INT_PTR CALLBACK CheatConsoleCallB(HWND hwndDlg, UINT uMsg, WPARAM wParam, LPARA
 
 							LVITEM lvi;
 							lvi.iSubItem = 0;
-							struct CHEATF* cheat = cheats;
-							 
-							while (cheat != NULL)
+							for (i = 0; i < (int)cheats.size(); ++i)
 							{
+								struct CHEATF* cheat = &cheats[i];
 								if (cheat->addr > 0x7FFF)
 								{
 									CreateCheatStr(buf, cheat->addr, cheat->val, cheat->compare);
 									lvi.pszText = buf;
 									SendDlgItemMessage(hwndDlg, IDC_LIST_CHEATS, LVM_SETITEMTEXT, i, (LPARAM)&lvi);
 								}
-								cheat = cheat->next;
-								++i;
 							}
 						}
 					}
@@ -1080,7 +1077,7 @@ void UpdateCheatListGroupBoxUI()
 	}
 	SetDlgItemText(hCheat, IDC_GROUPBOX_CHEATLIST, temp);
 
-	EnableWindow(GetDlgItem(hCheat, IDC_BTN_CHEAT_EXPORTTOFILE), cheats != 0);
+	EnableWindow(GetDlgItem(hCheat, IDC_BTN_CHEAT_EXPORTTOFILE), !cheats.empty());
 }
 
 //Used by cheats and external dialogs such as hex editor to update items in the cheat search dialog
@@ -1512,7 +1509,7 @@ bool ShowCheatFileBox(HWND hwnd, char* buf, bool save)
 
 void AskSaveCheat()
 {
-	if (cheats)
+	if (!cheats.empty())
 	{
 		HWND hwnd = hCheat ? hCheat : hAppWnd;
 		if (MessageBox(hwnd, "Save cheats?", "Cheat Console", MB_YESNO | MB_ICONASTERISK) == IDYES)
@@ -1523,7 +1520,7 @@ void AskSaveCheat()
 
 void SaveCheatAs(HWND hwnd, bool flush)
 {
-	if (cheats)
+	if (!cheats.empty())
 	{
 		char filename[2048];
 		if (ShowCheatFileBox(hwnd, filename, true))
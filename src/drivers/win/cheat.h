@@ -27,7 +27,7 @@ char* GetCheatToolTipStr(HWND hwndDlg, UINT id);
 
 extern unsigned int FrozenAddressCount;
 //void ConfigAddCheat(HWND wnd); //bbit edited:commented out this line
-extern struct CHEATF* cheats;
+extern std::vector<struct CHEATF> cheats;
 extern char* GameGenieLetters;
 
 void DisableAllCheats();
@@ -66,6 +66,7 @@ extern bool Show_FPS;
 extern int movieRecordMode;
 extern bool oldInputDisplay;
 extern bool fullSaveStateLoads;
+extern int movieSeekCacheMB;
 extern int frameSkipAmt;
 extern int32 fps_scale_frameadvance;
 extern bool symbDebugEnabled;
@@ -298,6 +299,7 @@ static CFGSTRUCT fceuconfig[] =
 	AC(hexeditorFontHeight),
 	ACS(hexeditorFontName),
 	AC(fullSaveStateLoads),
+	AC(movieSeekCacheMB),
 	AC(frameSkipAmt),
 	AC(fps_scale_frameadvance),
 
@@ -168,17 +168,17 @@ void EDITOR::toggleInput(int start, int end, int joy, int button, int consecutiv
 	if (end >= currMovieData.getNumRecords())
 		return;
 
-	if (currMovieData.records[check_frame].checkBit(joy, button))
+	if (currMovieData.records.checkBit(check_frame, joy, button))
 	{
 		// clear range
 		for (int i = start; i <= end; ++i)
-			currMovieData.records[i].clearBit(joy, button);
+			currMovieData.records.clearBit(i, joy, button);
 		greenzone.invalidateAndUpdatePlayback(history.registerChanges(MODTYPE_UNSET, start, end, 0, NULL, consecutivenessTag));
 	} else
 	{
 		// set range
 		for (int i = start; i <= end; ++i)
-			currMovieData.records[i].setBit(joy, button);
+			currMovieData.records.setBit(i, joy, button);
 		greenzone.invalidateAndUpdatePlayback(history.registerChanges(MODTYPE_SET, start, end, 0, NULL, consecutivenessTag));
 	}
 }
@@ -207,10 +207,10 @@ void EDITOR::setInputUsingPattern(int start, int end, int joy, int button, int c
 		if (taseditorConfig.autofirePatternSkipsLag && greenzone.lagLog.getLagInfoAtFrame(i) == LAGGED_YES)
 			continue;
 		value = (patterns[current_pattern][pattern_offset] != 0);
-		if (currMovieData.records[i].checkBit(joy, button) != value)
+		if (currMovieData.records.checkBit(i, joy, button) != value)
 		{
 			changes_made = true;
-			currMovieData.records[i].setBitValue(joy, button, value);
+			currMovieData.records.setBitValue(i, joy, button, value);
 		}
 		pattern_offset++;
 		if (pattern_offset >= (int)patterns[current_pattern].size())
@@ -332,7 +332,7 @@ bool EDITOR::handleInputColumnSet(int joy, int button)
 	bool newValue = false;
 	for(RowsSelection::iterator it(current_selection_begin); it != current_selection_end; it++)
 	{
-		if (!(currMovieData.records[*it].checkBit(joy,button)))
+		if (!(currMovieData.records.checkBit(*it, joy,button)))
 		{
 			newValue = true;
 			break;
@@ -340,7 +340,7 @@ bool EDITOR::handleInputColumnSet(int joy, int button)
 	}
 	// apply newValue
 	for(RowsSelection::iterator it(current_selection_begin); it != current_selection_end; it++)
-		currMovieData.records[*it].setBitValue(joy,button,newValue);
+		currMovieData.records.setBitValue(*it, joy,button,newValue);
 
 	int first_changes;
 	if (newValue)
@@ -372,7 +372,7 @@ bool EDITOR::handleInputColumnSetUsingPattern(int joy, int button)
 		// skip lag frames
 		if (taseditorConfig.autofirePatternSkipsLag && greenzone.lagLog.getLagInfoAtFrame(*it) == LAGGED_YES)
 			continue;
-		currMovieData.records[*it].setBitValue(joy, button, patterns[current_pattern][pattern_offset] != 0);
+		currMovieData.records.setBitValue(*it, joy, button, patterns[current_pattern][pattern_offset] != 0);
 		pattern_offset++;
 		if (pattern_offset >= (int)patterns[current_pattern].size())
 			pattern_offset -= patterns[current_pattern].size();
@@ -52,8 +52,8 @@ void INPUTLOG::init(MovieData& md, bool hotchanges, int force_input_type)
 	for (int frame = 0; frame < size; ++frame)
 	{
 		for (joy = num_joys - 1; joy >= 0; joy--)
-			joysticks[frame * num_joys * BYTES_PER_JOYSTICK + joy * BYTES_PER_JOYSTICK] = md.records[frame].joysticks[joy];
-		commands[frame] = md.records[frame].commands;
+			joysticks[frame * num_joys * BYTES_PER_JOYSTICK + joy * BYTES_PER_JOYSTICK] = md.records.joystick(frame, joy);
+		commands[frame] = md.records.commands(frame);
 	}
 	alreadyCompressed = false;
 }
@@ -78,7 +78,7 @@ void INPUTLOG::reinit(MovieData& md, bool hotchanges, int frame_of_change)
 		for (joy = num_joys - 1; joy >= 0; joy--)
 		{
 			my_joy = getJoystickData(frame_of_change, joy);
-			their_joy = md.records[frame_of_change].joysticks[joy];
+			their_joy = md.records.joystick(frame_of_change, joy);
 			if (my_joy != their_joy)
 				setMaxHotChangeBits(frame_of_change, joy, my_joy ^ their_joy);
 		}
@@ -90,8 +90,8 @@ void INPUTLOG::reinit(MovieData& md, bool hotchanges, int frame_of_change)
 
 	// update Input vector
 	for (joy = num_joys - 1; joy >= 0; joy--)
-		joysticks[frame_of_change * num_joys * BYTES_PER_JOYSTICK + joy * BYTES_PER_JOYSTICK] = md.records[frame_of_change].joysticks[joy];
-	commands[frame_of_change] = md.records[frame_of_change].commands;
+		joysticks[frame_of_change * num_joys * BYTES_PER_JOYSTICK + joy * BYTES_PER_JOYSTICK] = md.records.joystick(frame_of_change, joy);
+	commands[frame_of_change] = md.records.commands(frame_of_change);
 	alreadyCompressed = false;
 }
 
@@ -105,8 +105,8 @@ void INPUTLOG::toMovie(MovieData& md, int start, int end)
 	for (int frame = start; frame <= end; ++frame)
 	{
 		for (joy = num_joys - 1; joy >= 0; joy--)
-			md.records[frame].joysticks[joy] = joysticks[frame * num_joys * BYTES_PER_JOYSTICK + joy * BYTES_PER_JOYSTICK];
-		md.records[frame].commands = commands[frame];
+			md.records.setJoystick(frame, joy, joysticks[frame * num_joys * BYTES_PER_JOYSTICK + joy * BYTES_PER_JOYSTICK]);
+		md.records.setCommands(frame, commands[frame]);
 	}
 }
 
@@ -274,8 +274,8 @@ int INPUTLOG::findFirstChange(MovieData& md, int start, int end)
 	for (int frame = start; frame <= end; ++frame)
 	{
 		for (joy = num_joys - 1; joy >= 0; joy--)
-			if (getJoystickData(frame, joy) != md.records[frame].joysticks[joy]) return frame;
-		if (getCommandsData(frame) != md.records[frame].commands) return frame;
+			if (getJoystickData(frame, joy) != md.records.joystick(frame, joy)) return frame;
+		if (getCommandsData(frame) != md.records.commands(frame)) return frame;
 	}
 	// no difference was found
 
@@ -660,15 +660,15 @@ void PIANO_ROLL::update()
 						{
 							joy = (column_index - COLUMN_JOYPAD1_A) / NUM_JOYPAD_BUTTONS;
 							bit = (column_index - COLUMN_JOYPAD1_A) % NUM_JOYPAD_BUTTONS;
-							if (dragMode == DRAG_MODE_SET && !currMovieData.records[row_index].checkBit(joy, bit))
+							if (dragMode == DRAG_MODE_SET && !currMovieData.records.checkBit(row_index, joy, bit))
 							{
-								currMovieData.records[row_index].setBit(joy, bit);
+								currMovieData.records.setBit(row_index, joy, bit);
 								changes_made = true;
 								if (min_row_index > row_index) min_row_index = row_index;
 								if (max_row_index < row_index) max_row_index = row_index;
-							} else if (dragMode == DRAG_MODE_UNSET && currMovieData.records[row_index].checkBit(joy, bit))
+							} else if (dragMode == DRAG_MODE_UNSET && currMovieData.records.checkBit(row_index, joy, bit))
 							{
-								currMovieData.records[row_index].clearBit(joy, bit);
+								currMovieData.records.clearBit(row_index, joy, bit);
 								changes_made = true;
 								if (min_row_index > row_index) min_row_index = row_index;
 								if (max_row_index < row_index) max_row_index = row_index;
@@ -1319,7 +1319,7 @@ void PIANO_ROLL::getDispInfo(NMLVDISPINFO* nmlvDispInfo)
 			{
 				int joy = (item.iSubItem - COLUMN_JOYPAD1_A) / NUM_JOYPAD_BUTTONS;
 				int bit = (item.iSubItem - COLUMN_JOYPAD1_A) % NUM_JOYPAD_BUTTONS;
-				uint8 data = ((int)currMovieData.records.size() > item.iItem) ? currMovieData.records[item.iItem].joysticks[joy] : 0;
+				uint8 data = ((int)currMovieData.records.size() > item.iItem) ? currMovieData.records.joystick(item.iItem, joy) : 0;
 				if (data & (1<<bit))
 				{
 					item.pszText[0] = buttonNames[bit][0];
@@ -1438,7 +1438,7 @@ LONG PIANO_ROLL::handleCustomDraw(NMLVCUSTOMDRAW* msg)
 					int joy = (cell_x - COLUMN_JOYPAD1_A) / NUM_JOYPAD_BUTTONS;
 					int bit = (cell_x - COLUMN_JOYPAD1_A) % NUM_JOYPAD_BUTTONS;
 					if ((int)currMovieData.records.size() <= cell_y ||
-						((currMovieData.records[cell_y].joysticks[joy]) & (1<<bit)) )
+						((currMovieData.records.joystick(cell_y, joy)) & (1<<bit)) )
 						SelectObject(msg->nmcd.hdc, hMainListFont);
 					else
 						SelectObject(msg->nmcd.hdc, hMainListSelectFont);
@@ -1497,7 +1497,7 @@ LONG PIANO_ROLL::handleCustomDraw(NMLVCUSTOMDRAW* msg)
 					int joy = (cell_x - COLUMN_JOYPAD1_A) / NUM_JOYPAD_BUTTONS;
 					int bit = (cell_x - COLUMN_JOYPAD1_A) % NUM_JOYPAD_BUTTONS;
 					if ((int)currMovieData.records.size() <= cell_y ||
-						((currMovieData.records[cell_y].joysticks[joy]) & (1<<bit)) )
+						((currMovieData.records.joystick(cell_y, joy)) & (1<<bit)) )
 						SelectObject(msg->nmcd.hdc, hMainListFont);
 					else
 						SelectObject(msg->nmcd.hdc, hMainListSelectFont);
@@ -1737,10 +1737,10 @@ void PIANO_ROLL::crossGaps(int zDelta)
 						if (row_index < last_frame)
 						{
 							int frame = row_index + 1;
-							bool result_of_closest_frame = currMovieData.records[frame].checkBit(joy, button);
+							bool result_of_closest_frame = currMovieData.records.checkBit(frame, joy, button);
 							while ((++frame) <= last_frame)
 							{
-								if (currMovieData.records[frame].checkBit(joy, button) != result_of_closest_frame)
+								if (currMovieData.records.checkBit(frame, joy, button) != result_of_closest_frame)
 								{
 									// found different result, so we crossed the gap
 									ListView_Scroll(hwndList, 0, listRowHeight * (frame - row_index));
@@ -1755,10 +1755,10 @@ void PIANO_ROLL::crossGaps(int zDelta)
 						if (row_index > first_frame)
 						{
 							int frame = row_index - 1;
-							bool result_of_closest_frame = currMovieData.records[frame].checkBit(joy, button);
+							bool result_of_closest_frame = currMovieData.records.checkBit(frame, joy, button);
 							while ((--frame) >= first_frame)
 							{
-								if (currMovieData.records[frame].checkBit(joy, button) != result_of_closest_frame)
+								if (currMovieData.records.checkBit(frame, joy, button) != result_of_closest_frame)
 								{
 									// found different result, so we crossed the gap
 									ListView_Scroll(hwndList, 0, listRowHeight * (frame - row_index));
@@ -1974,7 +1974,7 @@ LRESULT APIENTRY listWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 						if (taseditorConfig.drawInputByDragging)
 						{
 							// if clicked this click created buttonpress, then start painting, else start erasing
-							if (currMovieData.records[row_index].checkBit(joy, button))
+							if (currMovieData.records.checkBit(row_index, joy, button))
 								pianoRoll.dragMode = DRAG_MODE_SET;
 							else
 								pianoRoll.dragMode = DRAG_MODE_UNSET;
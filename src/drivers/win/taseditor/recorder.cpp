@@ -247,7 +247,7 @@ void RECORDER::recordInput()
 	{
 		oldJoyData[i] = history.getCurrentSnapshot().inputlog.getJoystickData(currFrameCounter, i);
 		if (!taseditorConfig.recordingUsePattern || editor.patterns[oldCurrentPattern][patternOffset])
-			newJoyData[i] = currMovieData.records[currFrameCounter].joysticks[i];
+			newJoyData[i] = currMovieData.records.joystick(currFrameCounter, i);
 		else
 			newJoyData[i] = 0;		// blank
 	}
@@ -263,7 +263,7 @@ void RECORDER::recordInput()
 			if (taseditorConfig.superimpose == SUPERIMPOSE_CHECKED || (taseditorConfig.superimpose == SUPERIMPOSE_INDETERMINATE && newJoyData[i] == 0))
 				newJoyData[i] |= oldJoyData[i];
 			// change this joystick
-			currMovieData.records[currFrameCounter].joysticks[i] = newJoyData[i];
+			currMovieData.records.setJoystick(currFrameCounter, i, newJoyData[i]);
 			if (newJoyData[i] != oldJoyData[i])
 			{
 				changes_made = true;
@@ -285,9 +285,9 @@ void RECORDER::recordInput()
 			newJoyData[joy] |= oldJoyData[joy];
 		// other joysticks should not be changed
 		for (int i = num_joys-1; i >= 0; i--)
-			currMovieData.records[currFrameCounter].joysticks[i] = oldJoyData[i];	// revert to old
+			currMovieData.records.setJoystick(currFrameCounter, i, oldJoyData[i]);	// revert to old
 		// change only this joystick
-		currMovieData.records[currFrameCounter].joysticks[joy] = newJoyData[joy];
+		currMovieData.records.setJoystick(currFrameCounter, joy, newJoyData[joy]);
 		if (newJoyData[joy] != oldJoyData[joy])
 		{
 			changes_made = true;
@@ -300,7 +300,7 @@ void RECORDER::recordInput()
 	}
 
 	// check if new commands were recorded
-	if (currMovieData.records[currFrameCounter].commands != history.getCurrentSnapshot().inputlog.getCommandsData(currFrameCounter))
+	if (currMovieData.records.commands(currFrameCounter) != history.getCurrentSnapshot().inputlog.getCommandsData(currFrameCounter))
 	{
 		changes_made = true;
 		joypad_diff_bits |= 1;		// bit 0 = Commands, bit 1 = Joypad 1, bit 2 = Joypad 2, bit 3 = Joypad 3, bit 4 = Joypad 4
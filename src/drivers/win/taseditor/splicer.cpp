@@ -306,7 +306,7 @@ void SPLICER::clearSelectedFrames(RowsSelection* currentSelectionOverride)
 	RowsSelection::iterator current_selection_end(currentSelectionOverride->end());
 	for(RowsSelection::iterator it(currentSelectionOverride->begin()); it != current_selection_end; it++)
 	{
-		currMovieData.records[*it].clear();
+		currMovieData.records.set(*it, MovieRecord());
 	}
 	if (cut)
 		greenzone.invalidateAndUpdatePlayback(history.registerChanges(MODTYPE_CUT, *currentSelectionOverride->begin(), *currentSelectionOverride->rbegin()));
@@ -377,14 +377,14 @@ bool SPLICER::copySelectedInputToClipboard(RowsSelection* currentSelectionOverri
 			int cjoy=0;
 			for (int joy = 0; joy < num_joypads; ++joy)
 			{
-				while (currMovieData.records[*it].joysticks[joy] && cjoy<joy) 
+				while (currMovieData.records.joystick(*it, joy) && cjoy<joy) 
 				{
 					clipString << '|';
 					++cjoy;
 				}
 				for (int bit=0; bit<NUM_JOYPAD_BUTTONS; ++bit)
 				{
-					if (currMovieData.records[*it].joysticks[joy] & (1<<bit))
+					if (currMovieData.records.joystick(*it, joy) & (1<<bit))
 					{
 						clipString << buttonNames[bit];
 					}
@@ -480,10 +480,10 @@ bool SPLICER::pasteInputFromClipboard()
 				
 				if (taseditorConfig.superimpose == SUPERIMPOSE_UNCHECKED)
 				{
-					currMovieData.records[pos].joysticks[0] = 0;
-					currMovieData.records[pos].joysticks[1] = 0;
-					currMovieData.records[pos].joysticks[2] = 0;
-					currMovieData.records[pos].joysticks[3] = 0;
+					currMovieData.records.setJoystick(pos, 0, 0);
+					currMovieData.records.setJoystick(pos, 1, 0);
+					currMovieData.records.setJoystick(pos, 2, 0);
+					currMovieData.records.setJoystick(pos, 3, 0);
 				}
 				// read this frame Input
 				joy = 0;
@@ -496,12 +496,12 @@ bool SPLICER::pasteInputFromClipboard()
 						// flush buttons to movie data
 						if (taseditorConfig.superimpose == SUPERIMPOSE_CHECKED || (taseditorConfig.superimpose == SUPERIMPOSE_INDETERMINATE && new_buttons == 0))
 						{
-							flash_joy[joy] |= (new_buttons & (~currMovieData.records[pos].joysticks[joy]));		// highlight buttons that are new
-							currMovieData.records[pos].joysticks[joy] |= new_buttons;
+							flash_joy[joy] |= (new_buttons & (~currMovieData.records.joystick(pos, joy)));		// highlight buttons that are new
+							currMovieData.records.setJoystick(pos, joy, currMovieData.records.joystick(pos, joy) | new_buttons);
 						} else
 						{
 							flash_joy[joy] |= new_buttons;		// highlight buttons that were added
-							currMovieData.records[pos].joysticks[joy] = new_buttons;
+							currMovieData.records.setJoystick(pos, joy, new_buttons);
 						}
 						joy++;
 						new_buttons = 0;
@@ -522,12 +522,12 @@ bool SPLICER::pasteInputFromClipboard()
 				// before going to next frame, flush buttons to movie data
 				if (taseditorConfig.superimpose == SUPERIMPOSE_CHECKED || (taseditorConfig.superimpose == SUPERIMPOSE_INDETERMINATE && new_buttons == 0))
 				{
-					flash_joy[joy] |= (new_buttons & (~currMovieData.records[pos].joysticks[joy]));		// highlight buttons that are new
-					currMovieData.records[pos].joysticks[joy] |= new_buttons;
+					flash_joy[joy] |= (new_buttons & (~currMovieData.records.joystick(pos, joy)));		// highlight buttons that are new
+					currMovieData.records.setJoystick(pos, joy, currMovieData.records.joystick(pos, joy) | new_buttons);
 				} else
 				{
 					flash_joy[joy] |= new_buttons;		// highlight buttons that were added
-					currMovieData.records[pos].joysticks[joy] = new_buttons;
+					currMovieData.records.setJoystick(pos, joy, new_buttons);
 				}
 				// find CRLF
 				pGlobal = strchr(pGlobal, '\n');
@@ -631,7 +631,7 @@ bool SPLICER::pasteInsertInputFromClipboard()
 						{
 							if (*frame == buttonNames[bit][0])
 							{
-								currMovieData.records[pos].joysticks[joy] |= (1<<bit);
+								currMovieData.records.setJoystick(pos, joy, currMovieData.records.joystick(pos, joy) | (1<<bit));
 								flash_joy[joy] |= (1<<bit);		// highlight buttons
 								break;
 							}
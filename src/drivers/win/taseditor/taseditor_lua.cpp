@@ -293,15 +293,15 @@ int TASEDITOR_LUA::getinput(int frame, int joypad)
 		switch (joypad)
 		{
 			case LUA_JOYPAD_COMMANDS:
-				return currMovieData.records[frame].commands;
+				return currMovieData.records.commands(frame);
 			case LUA_JOYPAD_1P:
-				return currMovieData.records[frame].joysticks[0];
+				return currMovieData.records.joystick(frame, 0);
 			case LUA_JOYPAD_2P:
-				return currMovieData.records[frame].joysticks[1];
+				return currMovieData.records.joystick(frame, 1);
 			case LUA_JOYPAD_3P:
-				return currMovieData.records[frame].joysticks[2];
+				return currMovieData.records.joystick(frame, 2);
 			case LUA_JOYPAD_4P:
-				return currMovieData.records[frame].joysticks[3];
+				return currMovieData.records.joystick(frame, 3);
 		}
 		return -1;
 	} else
@@ -393,19 +393,19 @@ int TASEDITOR_LUA::applyinputchanges(const char* name)
 						switch (pending_changes[i].joypad)
 						{
 							case LUA_JOYPAD_COMMANDS:
-								currMovieData.records[pending_changes[i].frame].commands = pending_changes[i].data;
+								currMovieData.records.setCommands(pending_changes[i].frame, pending_changes[i].data);
 								break;
 							case LUA_JOYPAD_1P:
-								currMovieData.records[pending_changes[i].frame].joysticks[0] = pending_changes[i].data;
+								currMovieData.records.setJoystick(pending_changes[i].frame, 0, pending_changes[i].data);
 								break;
 							case LUA_JOYPAD_2P:
-								currMovieData.records[pending_changes[i].frame].joysticks[1] = pending_changes[i].data;
+								currMovieData.records.setJoystick(pending_changes[i].frame, 1, pending_changes[i].data);
 								break;
 							case LUA_JOYPAD_3P:
-								currMovieData.records[pending_changes[i].frame].joysticks[2] = pending_changes[i].data;
+								currMovieData.records.setJoystick(pending_changes[i].frame, 2, pending_changes[i].data);
 								break;
 							case LUA_JOYPAD_4P:
-								currMovieData.records[pending_changes[i].frame].joysticks[3] = pending_changes[i].data;
+								currMovieData.records.setJoystick(pending_changes[i].frame, 3, pending_changes[i].data);
 								break;
 						}
 						break;
@@ -732,6 +732,11 @@ void BeginLoggingSequence(void)
 	return;
 }
 
+int FCEUD_TraceLoggerRunning(void)
+{
+	return logging;
+}
+
 //todo: really speed this up
 void FCEUD_TraceInstruction(uint8 *opcode, int size)
 {
@@ -86,10 +86,9 @@ void EMUFILE_FILE::truncate(s32 length)
 	#else
 		ftruncate(fileno(fp),length);
 	#endif
-	// this is probably wrong if mode is "wb"
-	fclose(fp);
-	fp = NULL;
-	open(fname.c_str(),mode);
+	//reopening would empty a file opened "wb", so just keep the position inside it
+	if(ftell() > length)
+		fseek(length,SEEK_SET);
 }
 
 
@@ -382,7 +382,7 @@ static DECLFW(BRAMH) {
 	RAM[A & 0x7FF] = V;
 }
 
-static DECLFR(ARAML) {
+DECLFR(ARAML) {
 	return RAM[A];
 }
 
@@ -397,6 +397,7 @@ void ResetGameLoaded(void) {
 	GameStateRestore = 0;
 	PPU_hook = NULL;
 	GameHBIRQHook = NULL;
+	PPU_A12Hook = NULL;
 	FFCEUX_PPURead = NULL;
 	FFCEUX_PPUWrite = NULL;
 	if (GameExpSound.Kill)
@@ -790,6 +791,7 @@ void FCEUI_Emulate(uint8 **pXBuf, int32 **SoundBuf, int32 *SoundBufSize, int ski
 
 	AutoFire();
 	UpdateAutosave();
+	FCEUMOV_UpdateSeekCache();
 
 #ifdef _S9XLUA_H
 	FCEU_LuaFrameBoundary();
@@ -833,6 +835,7 @@ void FCEUI_Emulate(uint8 **pXBuf, int32 **SoundBuf, int32 *SoundBufSize, int ski
 		exit(0);
 #endif
 
+	X6502_Rebase();
 	timestampbase += timestamp;
 	timestamp = 0;
 	soundtimestamp = 0;
@@ -877,6 +880,7 @@ void FCEUI_CloseGame(void) {
 void ResetNES(void) {
 	FCEUMOV_AddCommand(FCEUNPCMD_RESET);
 	if (!GameInfo) return;
+	X6502_SyncEvents();
 	GameInterface(GI_RESETM2);
 	FCEUSND_Reset();
 	FCEUPPU_Reset();
@@ -1195,6 +1199,16 @@ void FCEUI_SetGameGenie(bool a) {
 	FSettings.GameGenie = a;
 }
 
+//Enable or disable running ROM images straight from a mapping of the file.
+void FCEUI_SetShareROMs(bool a) {
+	FSettings.ShareROMs = a;
+}
+
+//Enable or disable counting up idle CPU loops instead of running them.
+void FCEUI_SetIdleSkip(bool a) {
+	FSettings.IdleSkip = a;
+}
+
 //this variable isn't used at all, snap is always name-based
 //void FCEUI_SetSnapName(bool a)
 //{
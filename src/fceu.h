@@ -80,6 +80,7 @@ void FCEU_WriteRomByte(uint32 i, uint8 value);
 
 extern readfunc ARead[0x10000];
 extern writefunc BWrite[0x10000];
+DECLFR(ARAML);	//internal RAM, $0000-$07FF
 
 enum GI {
 	GI_RESETM2	=1,
@@ -112,6 +113,8 @@ typedef struct fceu_settings_struct {
 	int NoiseVolume;
 	int PCMVolume;
 	bool GameGenie;
+	bool ShareROMs;
+	bool IdleSkip;
 
 	//the currently selected first and last rendered scanlines.
 	int FirstSLine;
@@ -28,6 +28,7 @@ enum LuaMemHookType
 	LUAMEMHOOK_COUNT
 };
 void CallRegisteredLuaMemHook(unsigned int address, int size, unsigned int value, LuaMemHookType hookType);
+bool FCEU_LuaExecHooked(); // whether any script wants to hear about instructions executing
 
 struct LuaSaveData
 {
@@ -217,6 +217,16 @@ void FCEU_FDSSelect(void)
 	FCEU_DispMessage("Disk %d Side %c Selected", 0, SelectDisk >> 1, (SelectDisk & 1) ? 'B' : 'A');
 }
 
+static void FDSIRQSchedule(void) {
+	int32 cycles = X6502_MAPIRQ_MAXDELAY;
+
+	if ((IRQa & 2) && IRQCount && IRQCount < cycles)
+		cycles = IRQCount;
+	if (DiskSeekIRQ > 0 && DiskSeekIRQ < cycles)
+		cycles = DiskSeekIRQ;
+	X6502_MapIRQSchedule(cycles);
+}
+
 static void FDSFix(int a) {
 	if ((IRQa & 2) && IRQCount) {
 		IRQCount -= a;
@@ -237,6 +247,7 @@ static void FDSFix(int a) {
 			}
 		}
 	}
+	FDSIRQSchedule();
 }
 
 static DECLFR(FDSRead4030) {
@@ -258,6 +269,7 @@ static DECLFR(FDSRead4031) {
 
 	ret = 0xff;
 	if (mapperFDS_diskinsert && mapperFDS_control & 0x04) {
+		X6502_MapIRQSync();
 		mapperFDS_diskaccess = 1;
 
 		ret = 0;
@@ -288,6 +300,7 @@ static DECLFR(FDSRead4031) {
 
 		DiskSeekIRQ = 150;
 		X6502_IRQEnd(FCEU_IQEXT2);
+		FDSIRQSchedule();
 	}
 
 	return ret;
@@ -561,6 +574,7 @@ void FDSSoundReset(void) {
 	GameExpSound.HiFill = RenderSoundHQ;
 	GameExpSound.Fill = FDSSound;
 	GameExpSound.RChange = FDS_ESI;
+	GameExpSound.Name = "FDS";
 }
 
 static DECLFW(FDSWrite) {
@@ -576,9 +590,11 @@ static DECLFW(FDSWrite) {
 		IRQLatch |= V << 8;
 		break;
 	case 0x4022:
+		X6502_MapIRQSync();
 		X6502_IRQEnd(FCEU_IQEXT);
 		IRQCount = IRQLatch;
 		IRQa = V & 3;
+		FDSIRQSchedule();
 		break;
 	case 0x4023: break;
 	case 0x4024:
@@ -618,6 +634,7 @@ static DECLFW(FDSWrite) {
 		}
 		break;
 	case 0x4025:
+		X6502_MapIRQSync();
 		X6502_IRQEnd(FCEU_IQEXT2);
 		if (mapperFDS_diskinsert) {
 			if (V & 0x40 && ~mapperFDS_control & 0x40) {
@@ -664,6 +681,7 @@ static DECLFW(FDSWrite) {
 		}
 		mapperFDS_control = V;
 		setmirror(((V >> 3) & 1) ^ 1);
+		FDSIRQSchedule();
 		break;
 	}
 	FDSRegs[A & 7] = V;
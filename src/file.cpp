@@ -53,6 +53,13 @@
 #include <zlib.h>
 #endif
 
+#ifdef WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#endif
+
 using namespace std;
 
 bool bindSavestate = true;	//Toggle that determines if a savestate filename will include the movie filename
@@ -194,6 +201,169 @@ FileBaseInfo DetermineFileBase(const char *f) {
 
 inline FileBaseInfo DetermineFileBase(const std::string& str) { return DetermineFileBase(str.c_str()); }
 
+//Reads a zip member straight out of the inflater.  The start of the member
+//is kept so the loaders can probe for their headers and seek back to 0,
+//small reads go through a read-ahead buffer and large ones are inflated
+//directly into the caller's buffer.  Seeking backwards past the header
+//restarts the member, so reads should mostly be sequential.
+class EMUFILE_UNZIP : public EMUFILE {
+	enum { HEAD_SIZE = 1024, AHEAD_SIZE = 4096 };
+
+	unzFile zf;
+	s32 pos, len;
+	s32 zpos;	//bytes taken from the inflater so far
+
+	u8 head[HEAD_SIZE];
+	s32 headLen;
+	u8 ahead[AHEAD_SIZE];
+	s32 aheadStart, aheadLen;
+
+	s32 zread(void *dst, s32 bytes) {
+		int ret = unzReadCurrentFile(zf, dst, bytes);
+		if(ret <= 0)
+			return 0;
+		zpos += ret;
+		return ret;
+	}
+
+	bool zseek(s32 to) {
+		if(to < zpos) {
+			unzCloseCurrentFile(zf);
+			if(unzOpenCurrentFile(zf) != UNZ_OK)
+				return false;
+			zpos = 0;
+			aheadLen = 0;
+		}
+		while(zpos < to) {
+			if(!zread(ahead, std::min<s32>(to - zpos, AHEAD_SIZE))) {
+				aheadLen = 0;
+				return false;
+			}
+		}
+		aheadLen = 0;
+		return true;
+	}
+
+public:
+	EMUFILE_UNZIP(unzFile zipfile, s32 size)
+		: zf(zipfile), pos(0), len(size), zpos(0), aheadStart(0), aheadLen(0)
+	{
+		headLen = zread(head, std::min<s32>(len, HEAD_SIZE));
+		if(headLen < std::min<s32>(len, HEAD_SIZE))
+			failbit = true;
+	}
+
+	virtual ~EMUFILE_UNZIP() {
+		unzCloseCurrentFile(zf);
+		unzClose(zf);
+	}
+
+	virtual EMUFILE* memwrap() {
+		EMUFILE_MEMORY* mem = new EMUFILE_MEMORY(len);
+		s32 oldpos = pos;
+		pos = 0;
+		_fread(mem->buf(), len);
+		pos = oldpos;
+		mem->fseek(oldpos, SEEK_SET);
+		return mem;
+	}
+
+	virtual FILE *get_fp() { return NULL; }
+
+	virtual int fprintf(const char *format, ...) {
+		failbit = true;
+		return -1;
+	}
+
+	virtual int fgetc() {
+		u8 temp;
+		if(pos >= headLen && pos >= aheadStart && pos < aheadStart + aheadLen) {
+			return ahead[pos++ - aheadStart];
+		}
+		if(_fread(&temp, 1) != 1)
+			return EOF;
+		return temp;
+	}
+
+	virtual int fputc(int c) {
+		failbit = true;
+		return EOF;
+	}
+
+	virtual size_t _fread(const void *ptr, size_t bytes) {
+		u8 *dst = (u8*)ptr;
+		size_t done = 0, want = bytes;
+		s32 n;
+
+		if(pos >= len)
+			want = 0;
+		else if(want > (size_t)(len - pos))
+			want = len - pos;
+
+		while(done < want) {
+			s32 rem = (s32)(want - done);
+
+			if(pos < headLen) {
+				n = std::min<s32>(rem, headLen - pos);
+				memcpy(dst + done, head + pos, n);
+			} else if(pos >= aheadStart && pos < aheadStart + aheadLen) {
+				n = std::min<s32>(rem, aheadStart + aheadLen - pos);
+				memcpy(dst + done, ahead + pos - aheadStart, n);
+			} else if(pos != zpos && !zseek(pos)) {
+				break;
+			} else if(rem >= AHEAD_SIZE) {
+				if(!(n = zread(dst + done, rem)))
+					break;
+			} else {
+				aheadStart = pos;
+				if(!(aheadLen = zread(ahead, std::min<s32>(len - pos, AHEAD_SIZE))))
+					break;
+				continue;
+			}
+			pos += n;
+			done += n;
+		}
+
+		if(done < bytes)
+			failbit = true;
+		return done;
+	}
+
+	virtual void fwrite(const void *ptr, size_t bytes) {
+		failbit = true;
+	}
+
+	virtual int fseek(int offset, int origin) {
+		switch(origin) {
+			case SEEK_SET:
+				pos = offset;
+				break;
+			case SEEK_CUR:
+				pos += offset;
+				break;
+			case SEEK_END:
+				pos = len + offset;
+				break;
+			default:
+				assert(false);
+		}
+		return 0;
+	}
+
+	virtual int ftell() { return pos; }
+	virtual int size() { return len; }
+	virtual void fflush() {}
+
+	virtual void truncate(s32 length) {
+		failbit = true;
+	}
+};
+
+EMUFILE *FCEU_OpenZipStream(void *zipfile, uint32 size)
+{
+	return new EMUFILE_UNZIP((unzFile)zipfile, size);
+}
+
 static FCEUFILE * TryUnzip(const std::string& path) {
 	unzFile tz;
 	if((tz=unzOpen(path.c_str())))  // If it's not a zip file, use regular file handlers.
@@ -249,13 +419,9 @@ zpfail:
 		unzGetCurrentFileInfo(tz,&ufo,0,0,0,0,0,0);
 
 		int size = ufo.uncompressed_size;
-		EMUFILE_MEMORY* ms = new EMUFILE_MEMORY(size);
-		unzReadCurrentFile(tz,ms->buf(),ufo.uncompressed_size);
-		unzCloseCurrentFile(tz);
-		unzClose(tz);
 
 		FCEUFILE *fceufp = new FCEUFILE();
-		fceufp->stream = ms;
+		fceufp->stream = FCEU_OpenZipStream(tz, size);
 		fceufp->size = size;
 		return fceufp;
 
@@ -454,6 +620,77 @@ int FCEU_fisarchive(FCEUFILE *fp)
 	else return 1;
 }
 
+uint8 *FCEU_fmap(FCEUFILE *fp, size_t *size)
+{
+	//Only plain files on disk can be mapped.  Archives, gzipped files and
+	//IPS patched files have already been unpacked into a memory stream.
+	EMUFILE_FILE *ef = dynamic_cast<EMUFILE_FILE*>(fp->stream);
+	FILE *f;
+	void *base;
+
+	if(!ef || !(f = ef->get_fp()) || fp->size <= 0)
+		return NULL;
+
+#ifdef WIN32
+	HANDLE fh = (HANDLE)_get_osfhandle(_fileno(f));
+	HANDLE mh;
+
+	if(fh == INVALID_HANDLE_VALUE)
+		return NULL;
+	if(!(mh = CreateFileMapping(fh, NULL, PAGE_WRITECOPY, 0, 0, NULL)))
+		return NULL;
+	base = MapViewOfFile(mh, FILE_MAP_COPY, 0, 0, fp->size);
+	//The view keeps the mapping object alive.
+	CloseHandle(mh);
+	if(!base)
+		return NULL;
+#else
+	base = mmap(NULL, fp->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(f), 0);
+	if(base == MAP_FAILED)
+		return NULL;
+#endif
+
+	*size = fp->size;
+	return (uint8*)base;
+}
+
+bool FCEU_fdetach(uint8 *base, size_t size)
+{
+#ifdef WIN32
+	//There is no way to swap other memory in under a view, and the file
+	//can't be truncated for rewriting while the view exists.
+	return false;
+#else
+	uint8 *copy = (uint8*)malloc(size);
+
+	if(!copy)
+		return false;
+	memcpy(copy, base, size);
+
+	//Atomically swap in anonymous memory at the same address, so pointers
+	//into the mapping stay valid.
+	if(mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED)
+	{
+		free(copy);
+		return false;
+	}
+	memcpy(base, copy, size);
+	free(copy);
+	return true;
+#endif
+}
+
+void FCEU_funmap(uint8 *base, size_t size)
+{
+	if(!base)
+		return;
+#ifdef WIN32
+	UnmapViewOfFile(base);
+#else
+	munmap(base, size);
+#endif
+}
+
 std::string GetMfn() //Retrieves the movie filename from curMovieFilename (for adding to savestate and auto-save files)
 {
 	std::string movieFilenamePart;
@@ -757,6 +994,8 @@ std::string FCEU_MakeFName(int type, int id1, const char *cd1)
 			strcpy(ret,FCEU_MakeIpsFilename(CurrentFileBase()).c_str());
 			break;
 		case FCEUMKF_GGROM:sprintf(ret,"%s" PSS "gg.rom",BaseDirectory.c_str());break;
+		case FCEUMKF_ROMCACHE:sprintf(ret,"%s" PSS "romcache.dat",BaseDirectory.c_str());break;
+		case FCEUMKF_ROMLIB:sprintf(ret,"%s" PSS "romlib.idx",BaseDirectory.c_str());break;
 		case FCEUMKF_FDSROM:
 			if(odirs[FCEUIOD_FDSROM])
 				sprintf(ret,"%s" PSS "disksys.rom",odirs[FCEUIOD_FDSROM]);
@@ -135,6 +135,26 @@ int FCEU_fgetc(FCEUFILE*);
 uint64 FCEU_fgetsize(FCEUFILE*);
 int FCEU_fisarchive(FCEUFILE*);
 
+//Map the whole of a plain, unpatched file copy-on-write.  Processes that
+//load the same file share its pages until one of them writes to them.
+//Returns NULL if the file can't be mapped, read it as usual then.
+//Pages nobody has written to are still read from the file, so another
+//program rebuilding it in place while the game runs changes the ROM under
+//the emulator, and truncating it makes touching the lost pages raise SIGBUS
+//on POSIX systems.  Windows refuses to truncate a mapped file.
+uint8 *FCEU_fmap(FCEUFILE*, size_t *size);
+//Cut a mapping loose from its file in place, for when the file is about to
+//be overwritten.  The contents and address stay the same.  Returns false if
+//that can't be done, always so on Windows, and the caller has to copy the
+//contents elsewhere and unmap it instead.
+bool FCEU_fdetach(uint8 *base, size_t size);
+void FCEU_funmap(uint8 *base, size_t size);
+
+//Wrap a zip member opened with unzOpenCurrentFile() in a read only stream
+//that inflates on demand.  The stream takes ownership of the unzFile and
+//closes it when deleted.
+EMUFILE *FCEU_OpenZipStream(void *zipfile, uint32 size);
+
 
 
 void GetFileBase(const char *f);
@@ -167,4 +187,6 @@ void FCEU_SplitArchiveFilename(std::string src, std::string& archive, std::strin
 #define FCEUMKF_AVI			 21
 #define FCEUMKF_TASEDITOR    22
 #define FCEUMKF_RESUMESTATE  23
+#define FCEUMKF_ROMCACHE     24
+#define FCEUMKF_ROMLIB       25
 #endif
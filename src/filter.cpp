@@ -7,6 +7,7 @@
 #include "x6502.h"
 #include "fceu.h"
 #include "filter.h"
+#include "sndprof.h"
 
 #include "fcoeffs.h"
 
@@ -50,7 +51,17 @@ void SexyFilter2(int32 *in, int32 count)
 
 void SexyFilter(int32 *in, int32 *out, int32 count)
 {
- static int64 acc1=0,acc2=0;
+ static int64 acc[2]={0,0};
+
+ SexyFilterStream(in,out,count,acc);
+}
+
+/* SexyFilter() with caller provided state, for filtering streams other
+   than the main mix the same way.
+*/
+void SexyFilterStream(int32 *in, int32 *out, int32 count, int64 *acc)
+{
+ int64 acc1=acc[0],acc2=acc[1];
  int32 mul1,mul2,vmul;
 
  mul1=(94<<16)/FSettings.SndRate;
@@ -79,6 +90,40 @@ void SexyFilter(int32 *in, int32 *out, int32 count)
   out++;
   count--;
  }
+ acc[0]=acc1;
+ acc[1]=acc2;
+}
+
+/* Approximate gain from a sample added to the mixer to the final output,
+   ignoring the DC blocking done in SexyFilter().  prefir is set for samples
+   added ahead of the FIR in HQ mode (HiFill), which go through its DC gain.
+*/
+double FilterOutputGain(int prefir)
+{
+ double g;
+ int32 vmul;
+ uint32 x;
+
+ vmul=(FSettings.SoundVolume<<16)*3/4/100;
+ if(FSettings.soundq) vmul/=4;
+ else vmul*=2;
+
+ g=-(double)vmul/65536;
+
+ if(prefir)
+ {
+  int64 sum=0;
+
+  if(FSettings.soundq==2)
+   for(x=0;x<SQ2NCOEFFS;x++)
+    sum+=sq2coeffs[x];
+  else
+   for(x=0;x<NCOEFFS;x++)
+    sum+=coeffs[x];
+
+  g*=(double)sum/(1<<17);
+ }
+ return g;
 }
 
 /* Returns number of samples written to out. */
@@ -93,11 +138,10 @@ void SexyFilter(int32 *in, int32 *out, int32 count)
    code to be higher, or you *might* overflow the FIR code.
 */
 
-int32 NeoFilterSound(int32 *in, int32 *out, uint32 inlen, int32 *leftover)
+static int32 NeoFilterFIR(int32 *in, int32 *out, uint32 inlen, uint32 *index)
 {
 	uint32 x;
 	uint32 max;
-	int32 *outsave=out;
 	int32 count=0;
 
 //	for(x=0;x<inlen;x++)
@@ -107,7 +151,7 @@ int32 NeoFilterSound(int32 *in, int32 *out, uint32 inlen, int32 *leftover)
         max=(inlen-1)<<16;
 
 	if(FSettings.soundq==2)
-        for(x=mrindex;x<max;x+=mrratio)
+        for(x=*index;x<max;x+=mrratio)
         {
 			int32 acc=0,acc2=0;
 			unsigned int c;
@@ -125,7 +169,7 @@ int32 NeoFilterSound(int32 *in, int32 *out, uint32 inlen, int32 *leftover)
 			count++;
         }
 	else
-		for(x=mrindex;x<max;x+=mrratio)
+		for(x=*index;x<max;x+=mrratio)
 		{
 			int32 acc=0,acc2=0;
 			unsigned int c;
@@ -143,21 +187,39 @@ int32 NeoFilterSound(int32 *in, int32 *out, uint32 inlen, int32 *leftover)
 			count++;
 		}
 
-	mrindex=x-max;
+	*index=x-max;
+
+	if(FSettings.soundq==2)
+         *index+=SQ2NCOEFFS*65536;
+	else
+         *index+=NCOEFFS*65536;
+
+	return(count);
+}
+
+int32 NeoFilterSound(int32 *in, int32 *out, uint32 inlen, int32 *leftover)
+{
+	int32 *outsave=out;
+	int32 count;
+
+	count=NeoFilterFIR(in,out,inlen,&mrindex);
 
 	if(FSettings.soundq==2)
-	{
-         mrindex+=SQ2NCOEFFS*65536;
          *leftover=SQ2NCOEFFS+1;
-	}
 	else
-	{
-         mrindex+=NCOEFFS*65536;
          *leftover=NCOEFFS+1;
-	}
 
 	if(GameExpSound.NeoFill)
-	 GameExpSound.NeoFill(outsave,count);
+	{
+	 if(FCEU_ExpSoundProfActive)
+	 {
+	  FCEU_ExpSoundProfBegin(outsave,count);
+	  GameExpSound.NeoFill(outsave,count);
+	  FCEU_ExpSoundProfEnd(outsave,count);
+	 }
+	 else
+	  GameExpSound.NeoFill(outsave,count);
+	}
 
 	SexyFilter(outsave,outsave,count);
 	if(FSettings.lowpass)
@@ -165,6 +227,17 @@ int32 NeoFilterSound(int32 *in, int32 *out, uint32 inlen, int32 *leftover)
 	return(count);
 }
 
+/* Resample another CPU rate stream exactly like the main one.  Must be
+   called before NeoFilterSound() for the same frame, with the same inlen,
+   so it produces the same number of samples and leaves the same leftover.
+*/
+int32 NeoFilterStream(int32 *in, int32 *out, uint32 inlen)
+{
+	uint32 index=mrindex;
+
+	return NeoFilterFIR(in,out,inlen,&index);
+}
+
 void MakeFilters(int32 rate)
 {
  const int32 *tabs[6]={C44100NTSC,C44100PAL,C48000NTSC,C48000PAL,C96000NTSC,
@@ -1,3 +1,6 @@
 int32 NeoFilterSound(int32 *in, int32 *out, uint32 inlen, int32 *leftover);
 void MakeFilters(int32 rate);
+int32 NeoFilterStream(int32 *in, int32 *out, uint32 inlen);
 void SexyFilter(int32 *in, int32 *out, int32 count);
+void SexyFilterStream(int32 *in, int32 *out, int32 count, int64 *acc);
+double FilterOutputGain(int prefir);
@@ -37,10 +37,13 @@
 #include "cheat.h"
 #include "vsuni.h"
 #include "driver.h"
+#include "romcache.h"
 
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <map>
+#include <set>
 
 extern SFORMAT FCEUVSUNI_STATEINFO[];
 
@@ -56,6 +59,63 @@ static CartInfo iNESCart;
 uint8 Mirroring = 0;
 uint32 ROM_size = 0;
 uint32 VROM_size = 0;
+
+//When the ROM file could be mapped, ROM and VROM point into the mapping
+//rather than being malloc'd.
+static uint8 *ROMMap = NULL;
+static size_t ROMMapSize = 0;
+
+static bool iNESMapped(uint8 *p) {
+	return ROMMap && p >= ROMMap && p < ROMMap + ROMMapSize;
+}
+
+static void iNESFreeVROM() {
+	if (VROM && !iNESMapped(VROM))
+		free(VROM);
+	VROM = NULL;
+}
+
+//Cut ROM and VROM loose from the file they are mapped from, for when it is
+//about to be overwritten.  Where the mapping can't be detached in place they
+//are copied into memory of their own and everything pointing at them is
+//moved along.
+static bool iNESDetach() {
+	uint8 *rom, *vrom = NULL;
+
+	if (!ROMMap || FCEU_fdetach(ROMMap, ROMMapSize))
+		return true;
+
+	if ((rom = (uint8*)FCEU_malloc(ROM_size << 14)) == NULL)
+		return false;
+	if (VROM && (vrom = (uint8*)FCEU_malloc(VROM_size << 13)) == NULL) {
+		free(rom);
+		return false;
+	}
+
+	memcpy(rom, ROM, ROM_size << 14);
+	MoveCartMemory(ROM, ROM_size << 14, rom);
+	ROM = rom;
+	if (vrom) {
+		memcpy(vrom, VROM, VROM_size << 13);
+		MoveCartMemory(VROM, VROM_size << 13, vrom);
+		VROM = vrom;
+	}
+
+	FCEU_funmap(ROMMap, ROMMapSize);
+	ROMMap = NULL;
+	ROMMapSize = 0;
+	return true;
+}
+
+static void iNESFreeROM() {
+	if (ROM && !iNESMapped(ROM))
+		free(ROM);
+	ROM = NULL;
+	iNESFreeVROM();
+	FCEU_funmap(ROMMap, ROMMapSize);
+	ROMMap = NULL;
+	ROMMapSize = 0;
+}
 char LoadedRomFName[2048]; //mbg merge 7/17/06 added
 
 static int CHRRAMSize = -1;
@@ -106,14 +166,7 @@ void iNESGI(GI h) { //bbit edited: removed static keyword
 		FCEU_SaveGameSave(&iNESCart);
 		if (iNESCart.Close)
 			iNESCart.Close();
-		if (ROM) {
-			free(ROM);
-			ROM = NULL;
-		}
-		if (VROM) {
-			free(VROM);
-			VROM = NULL;
-		}
+		iNESFreeROM();
 		if (trainerpoo) {
 			free(trainerpoo);
 			trainerpoo = NULL;
@@ -244,14 +297,16 @@ static struct BADINF BadROMImages[] =
 };
 
 void CheckBad(uint64 md5partial) {
-	int32 x = 0;
-	while (BadROMImages[x].name) {
-		if (BadROMImages[x].md5partial == md5partial) {
-			FCEU_PrintError("The copy game you have loaded, \"%s\", is bad, and will not work properly in FCEUX.", BadROMImages[x].name);
-			return;
-		}
-		x++;
+	static std::map<uint64, const char *> index;
+	std::map<uint64, const char *>::iterator it;
+
+	if (index.empty()) {
+		for (int32 x = 0; BadROMImages[x].name; x++)
+			index.insert(std::make_pair(BadROMImages[x].md5partial, BadROMImages[x].name));
 	}
+	it = index.find(md5partial);
+	if (it != index.end())
+		FCEU_PrintError("The copy game you have loaded, \"%s\", is bad, and will not work properly in FCEUX.", it->second);
 }
 
 
@@ -326,9 +381,24 @@ static void CheckHInfo(void) {
 	{
 		#include "ines-correct.h"
 	};
+	//Both tables are looked up through these, built on first use.
+	static std::map<uint32, const struct CHINF *> mooIndex;
+	static std::set<uint64> savieIndex;
+	std::map<uint32, const struct CHINF *>::iterator it;
 	int32 tofix = 0, x, mask;
 	uint64 partialmd5 = 0;
 
+	if (mooIndex.empty()) {
+		x = 0;
+		do {
+			mooIndex.insert(std::make_pair(moo[x].crc32, &moo[x]));
+			x++;
+		} while (moo[x].mirror >= 0 || moo[x].mapper >= 0);
+
+		for (x = 0; savie[x] != 0; x++)
+			savieIndex.insert(savie[x]);
+	}
+
 	for (x = 0; x < 8; x++)
 		partialmd5 |= (uint64)iNESCart.MD5[15 - x] << (x * 8);
 	CheckBad(partialmd5);
@@ -350,55 +420,48 @@ static void CheckHInfo(void) {
 		break;
 	}
 
-	x = 0;
-	do {
-		if (moo[x].crc32 == iNESGameCRC32) {
-			if (moo[x].mapper >= 0) {
-				if (moo[x].mapper & 0x800 && VROM_size) {
-					VROM_size = 0;
-					free(VROM);
-					VROM = NULL;
-					tofix |= 8;
-				}
-				if (moo[x].mapper & 0x1000)
-					mask = 0xFFF;
-				else
-					mask = 0xFF;
-				if (MapperNo != (moo[x].mapper & mask)) {
-					tofix |= 1;
-					MapperNo = moo[x].mapper & mask;
-				}
+	it = mooIndex.find(iNESGameCRC32);
+	if (it != mooIndex.end()) {
+		const struct CHINF *mi = it->second;
+
+		if (mi->mapper >= 0) {
+			if (mi->mapper & 0x800 && VROM_size) {
+				VROM_size = 0;
+				iNESFreeVROM();
+				tofix |= 8;
 			}
-			if (moo[x].mirror >= 0) {
-				if (moo[x].mirror == 8) {
-					if (Mirroring == 2) {	/* Anything but hard-wired(four screen). */
-						tofix |= 2;
-						Mirroring = 0;
-					}
-				} else if (Mirroring != moo[x].mirror) {
-					if (Mirroring != (moo[x].mirror & ~4))
-						if ((moo[x].mirror & ~4) <= 2)	/* Don't complain if one-screen mirroring
-														needs to be set(the iNES header can't
-														hold this information).
-														*/
-							tofix |= 2;
-					Mirroring = moo[x].mirror;
-				}
+			if (mi->mapper & 0x1000)
+				mask = 0xFFF;
+			else
+				mask = 0xFF;
+			if (MapperNo != (mi->mapper & mask)) {
+				tofix |= 1;
+				MapperNo = mi->mapper & mask;
 			}
-			break;
 		}
-		x++;
-	} while (moo[x].mirror >= 0 || moo[x].mapper >= 0);
-
-	x = 0;
-	while (savie[x] != 0) {
-		if (savie[x] == partialmd5) {
-			if (!(head.ROM_type & 2)) {
-				tofix |= 4;
-				head.ROM_type |= 2;
+		if (mi->mirror >= 0) {
+			if (mi->mirror == 8) {
+				if (Mirroring == 2) {	/* Anything but hard-wired(four screen). */
+					tofix |= 2;
+					Mirroring = 0;
+				}
+			} else if (Mirroring != mi->mirror) {
+				if (Mirroring != (mi->mirror & ~4))
+					if ((mi->mirror & ~4) <= 2)	/* Don't complain if one-screen mirroring
+													needs to be set(the iNES header can't
+													hold this information).
+													*/
+						tofix |= 2;
+				Mirroring = mi->mirror;
 			}
 		}
-		x++;
+	}
+
+	if (savieIndex.count(partialmd5)) {
+		if (!(head.ROM_type & 2)) {
+			tofix |= 4;
+			head.ROM_type |= 2;
+		}
 	}
 
 	/* Games that use these iNES mappers tend to have the four-screen bit set
@@ -736,64 +799,63 @@ BMAPPINGLocal bmap[] = {
 	{"",					0, NULL}
 };
 
-int iNESLoad(const char *name, FCEUFILE *fp, int OverwriteVidMode) {
-	struct md5_context md5;
+static std::map<int, BMAPPINGLocal *> iNESMapperIndex() {
+	std::map<int, BMAPPINGLocal *> index;
 
-	if (FCEU_fread(&head, 1, 16, fp) != 16 || memcmp(&head, "NES\x1A", 4))
-		return LOADER_INVALID_FORMAT;
-	
-	head.cleanup();
+	for (BMAPPINGLocal *tmp = bmap; tmp->init; tmp++)
+		index.insert(std::make_pair((int)tmp->number, tmp));
+	return index;
+}
 
-	memset(&iNESCart, 0, sizeof(iNESCart));
+static BMAPPINGLocal *iNESFindMapper(int num) {
+	//Initialized once even when the library scanner calls this from several
+	//threads at the same time.
+	static const std::map<int, BMAPPINGLocal *> index = iNESMapperIndex();
+	std::map<int, BMAPPINGLocal *>::const_iterator it;
 
-	iNES2 = ((head.ROM_type2 & 0x0C) == 0x08);
-	if(iNES2)
-	{
-		iNESCart.ines2 = true;
-		iNESCart.wram_size = (head.RAM_size & 0x0F)?(64 << (head.RAM_size & 0x0F)):0;
-		iNESCart.battery_wram_size = (head.RAM_size & 0xF0)?(64 << ((head.RAM_size & 0xF0)>>4)):0;
-		iNESCart.vram_size = (head.VRAM_size & 0x0F)?(64 << (head.VRAM_size & 0x0F)):0;
-		iNESCart.battery_vram_size = (head.VRAM_size & 0xF0)?(64 << ((head.VRAM_size & 0xF0)>>4)):0;
-		iNESCart.submapper = head.ROM_type3 >> 4;
-	}
+	it = index.find(num);
+	return (it == index.end()) ? NULL : it->second;
+}
 
-	MapperNo = (head.ROM_type >> 4);
-	MapperNo |= (head.ROM_type2 & 0xF0);
-	if(iNES2) MapperNo |= ((head.ROM_type3 & 0x0F) << 8);
-	
-	if (head.ROM_type & 8) {
-		Mirroring = 2;
-	} else
-		Mirroring = (head.ROM_type & 1);
+static int iNESGetMapper(const iNES_HEADER &h, int ines2) {
+	int mapper = (h.ROM_type >> 4);
+	mapper |= (h.ROM_type2 & 0xF0);
+	if(ines2) mapper |= ((h.ROM_type3 & 0x0F) << 8);
+	return mapper;
+}
 
+//PRG and CHR ROM sizes in 16KiB and 8KiB units as iNESLoad lays the image
+//out in memory.  Returns false if only notRoundSize units of PRG ROM are in
+//the file for this mapper.
+static int iNESGetSizes(const iNES_HEADER &h, int ines2, int mapper, uint32 *prg, uint32 *chr, int *notRoundSize) {
 	int not_round_size;
-	if (!iNES2)	{
-		not_round_size = head.ROM_size;
+	if (!ines2)	{
+		not_round_size = h.ROM_size;
 	}
 	else {
-		if ((head.Upper_ROM_VROM_size & 0x0F) != 0x0F)
+		if ((h.Upper_ROM_VROM_size & 0x0F) != 0x0F)
 			// simple notation
-			not_round_size = head.ROM_size | ((head.Upper_ROM_VROM_size & 0x0F) << 8);
+			not_round_size = h.ROM_size | ((h.Upper_ROM_VROM_size & 0x0F) << 8);
 		else
 			// exponent-multiplier notation
-			not_round_size = ((1 << (head.ROM_size >> 2)) * ((head.ROM_size & 0b11) * 2 + 1)) >> 14;
+			not_round_size = ((1 << (h.ROM_size >> 2)) * ((h.ROM_size & 0b11) * 2 + 1)) >> 14;
 	}
 	
-	if (!head.ROM_size && !iNES2)
-		ROM_size = 256;
+	if (!h.ROM_size && !ines2)
+		*prg = 256;
 	else
-		ROM_size = uppow2(not_round_size);
+		*prg = uppow2(not_round_size);
 
-	VROM_size = uppow2(head.VROM_size | (iNES2?((head.Upper_ROM_VROM_size & 0xF0)<<4):0));
-	if (!iNES2)	{
-		VROM_size = head.VROM_size;
+	*chr = uppow2(h.VROM_size | (ines2?((h.Upper_ROM_VROM_size & 0xF0)<<4):0));
+	if (!ines2)	{
+		*chr = h.VROM_size;
 	}
 	else {
-		if ((head.Upper_ROM_VROM_size & 0xF0) != 0xF0)
+		if ((h.Upper_ROM_VROM_size & 0xF0) != 0xF0)
 			// simple notation
-			VROM_size = uppow2(head.VROM_size | ((head.Upper_ROM_VROM_size & 0xF0) << 4));
+			*chr = uppow2(h.VROM_size | ((h.Upper_ROM_VROM_size & 0xF0) << 4));
 		else
-			VROM_size = ((1 << (head.VROM_size >> 2)) * ((head.VROM_size & 0b11) * 2 + 1)) >> 13;
+			*chr = ((1 << (h.VROM_size >> 2)) * ((h.VROM_size & 0b11) * 2 + 1)) >> 13;
 	}
 
 	int round = true;
@@ -803,24 +865,86 @@ int iNESLoad(const char *name, FCEUFILE *fp, int OverwriteVidMode) {
 		//since PRGCartMapping wants ROM_size to be to the power of 2
 		//so instead if not to power of 2, we just use head.ROM_size when
 		//we use FCEU_read
-		if (not_power2[i] == MapperNo) {
+		if (not_power2[i] == mapper) {
 			round = false;
 			break;
 		}
 	}
 
-	if ((ROM = (uint8*)FCEU_malloc(ROM_size << 14)) == NULL)
-		return 0;
-	memset(ROM, 0xFF, ROM_size << 14);
-
-	if (VROM_size) {
-		if ((VROM = (uint8*)FCEU_malloc(VROM_size << 13)) == NULL) {
-			free(ROM);
-			ROM = NULL;
-			FCEU_PrintError("Unable to allocate memory.");
-			return LOADER_HANDLED_ERROR;
+	*notRoundSize = not_round_size;
+	return round;
+}
+
+static bool iNESNameIsPAL(const char *name) {
+	return strstr(name, "(E)") || strstr(name, "(e)")
+		|| strstr(name, "(Europe)") || strstr(name, "(PAL)")
+		|| strstr(name, "(F)") || strstr(name, "(f)")
+		|| strstr(name, "(G)") || strstr(name, "(g)")
+		|| strstr(name, "(I)") || strstr(name, "(i)");
+}
+
+int iNESLoad(const char *name, FCEUFILE *fp, int OverwriteVidMode) {
+	struct md5_context md5;
+
+	if (FCEU_fread(&head, 1, 16, fp) != 16 || memcmp(&head, "NES\x1A", 4))
+		return LOADER_INVALID_FORMAT;
+	
+	head.cleanup();
+
+	memset(&iNESCart, 0, sizeof(iNESCart));
+
+	iNES2 = ((head.ROM_type2 & 0x0C) == 0x08);
+	if(iNES2)
+	{
+		iNESCart.ines2 = true;
+		iNESCart.wram_size = (head.RAM_size & 0x0F)?(64 << (head.RAM_size & 0x0F)):0;
+		iNESCart.battery_wram_size = (head.RAM_size & 0xF0)?(64 << ((head.RAM_size & 0xF0)>>4)):0;
+		iNESCart.vram_size = (head.VRAM_size & 0x0F)?(64 << (head.VRAM_size & 0x0F)):0;
+		iNESCart.battery_vram_size = (head.VRAM_size & 0xF0)?(64 << ((head.VRAM_size & 0xF0)>>4)):0;
+		iNESCart.submapper = head.ROM_type3 >> 4;
+	}
+
+	MapperNo = iNESGetMapper(head, iNES2);
+	
+	if (head.ROM_type & 8) {
+		Mirroring = 2;
+	} else
+		Mirroring = (head.ROM_type & 1);
+
+	int not_round_size;
+	int round = iNESGetSizes(head, iNES2, MapperNo, &ROM_size, &VROM_size, &not_round_size);
+
+	//Use the image in place when the file holds all of it, so that processes
+	//running the same ROM share one copy.  Anything writing to it, like the
+	//hex editor or flash mappers, gets a private copy of the page.
+	if (FSettings.ShareROMs && round && (ROMMap = FCEU_fmap(fp, &ROMMapSize))) {
+		uint32 offset = 16 + ((head.ROM_type & 4) ? 512 : 0);
+
+		if (ROMMapSize >= offset + (ROM_size << 14) + (VROM_size << 13)) {
+			ROM = ROMMap + offset;
+			if (VROM_size)
+				VROM = ROM + (ROM_size << 14);
+		} else {
+			FCEU_funmap(ROMMap, ROMMapSize);
+			ROMMap = NULL;
+			ROMMapSize = 0;
+		}
+	}
+
+	if (!ROMMap) {
+		if ((ROM = (uint8*)FCEU_malloc(ROM_size << 14)) == NULL)
+			return 0;
+		memset(ROM, 0xFF, ROM_size << 14);
+
+		if (VROM_size) {
+			if ((VROM = (uint8*)FCEU_malloc(VROM_size << 13)) == NULL) {
+				free(ROM);
+				ROM = NULL;
+				FCEU_PrintError("Unable to allocate memory.");
+				return LOADER_HANDLED_ERROR;
+			}
+			memset(VROM, 0xFF, VROM_size << 13);
 		}
-		memset(VROM, 0xFF, VROM_size << 13);
 	}
 
 	if (head.ROM_type & 4) {	/* Trainer */
@@ -833,21 +957,27 @@ int iNESLoad(const char *name, FCEUFILE *fp, int OverwriteVidMode) {
 
 	SetupCartPRGMapping(0, ROM, ROM_size << 14, 0);
 
-	FCEU_fread(ROM, 0x4000, (round) ? ROM_size : not_round_size, fp);
+	if (!ROMMap) {
+		FCEU_fread(ROM, 0x4000, (round) ? ROM_size : not_round_size, fp);
 
-	if (VROM_size)
-		FCEU_fread(VROM, 0x2000, VROM_size, fp);
+		if (VROM_size)
+			FCEU_fread(VROM, 0x2000, VROM_size, fp);
+	}
 
-	md5_starts(&md5);
-	md5_update(&md5, ROM, ROM_size << 14);
+	if (!FCEU_RomCacheLookup(fp, iNESCart.MD5, &iNESGameCRC32)) {
+		md5_starts(&md5);
+		md5_update(&md5, ROM, ROM_size << 14);
 
-	iNESGameCRC32 = CalcCRC32(0, ROM, ROM_size << 14);
+		iNESGameCRC32 = CalcCRC32(0, ROM, ROM_size << 14);
 
-	if (VROM_size) {
-		iNESGameCRC32 = CalcCRC32(iNESGameCRC32, VROM, VROM_size << 13);
-		md5_update(&md5, VROM, VROM_size << 13);
+		if (VROM_size) {
+			iNESGameCRC32 = CalcCRC32(iNESGameCRC32, VROM, VROM_size << 13);
+			md5_update(&md5, VROM, VROM_size << 13);
+		}
+		md5_finish(&md5, iNESCart.MD5);
+
+		FCEU_RomCacheStore(fp, iNESCart.MD5, iNESGameCRC32);
 	}
-	md5_finish(&md5, iNESCart.MD5);
 	memcpy(&GameInfo->MD5, &iNESCart.MD5, sizeof(iNESCart.MD5));
 
 	iNESCart.CRC32 = iNESGameCRC32;
@@ -864,13 +994,10 @@ int iNESLoad(const char *name, FCEUFILE *fp, int OverwriteVidMode) {
 	}
 
 	const char* mappername = "Not Listed";
+	BMAPPINGLocal *mapper = iNESFindMapper(MapperNo);
 
-	for (int mappertest = 0; mappertest < (sizeof bmap / sizeof bmap[0]) - 1; mappertest++) {
-		if (bmap[mappertest].number == MapperNo) {
-			mappername = bmap[mappertest].name;
-			break;
-		}
-	}
+	if (mapper)
+		mappername = mapper->name;
 
 	FCEU_printf(" Mapper #: %d\n", MapperNo);
 	FCEU_printf(" Mapper name: %s\n", mappername);
@@ -931,12 +1058,9 @@ int iNESLoad(const char *name, FCEUFILE *fp, int OverwriteVidMode) {
 		FCEU_PrintError("Unable to allocate CHR-RAM.");
 		break;
 	}
-	if (ROM) free(ROM);
-	if (VROM) free(VROM);
+	iNESFreeROM();
 	if (trainerpoo) free(trainerpoo);
 	if (ExtraNTARAM) free(ExtraNTARAM);
-	ROM = NULL;
-	VROM = NULL;
 	trainerpoo = NULL;
 	ExtraNTARAM = NULL;
 	return LOADER_HANDLED_ERROR;
@@ -965,11 +1089,7 @@ init_ok:
 	if (iNES2) {
 		FCEUI_SetVidSystem(((head.TV_system & 3) == 1) ? 1 : 0);
 	} else if (OverwriteVidMode) {
-		if (strstr(name, "(E)") || strstr(name, "(e)")
-			|| strstr(name, "(Europe)") || strstr(name, "(PAL)")
-			|| strstr(name, "(F)") || strstr(name, "(f)")
-			|| strstr(name, "(G)") || strstr(name, "(g)")
-			|| strstr(name, "(I)") || strstr(name, "(i)"))
+		if (iNESNameIsPAL(name))
 			FCEUI_SetVidSystem(1);
 		else
 			FCEUI_SetVidSystem(0);
@@ -998,6 +1118,10 @@ int iNesSaveAs(const char* name)
 	if (GameInfo->type != GIT_CART) return 0;
 	if (GameInterface != iNESGI) return 0;
 
+	//This may well be the file ROM is mapped from.
+	if (!iNESDetach())
+		return 0;
+
 	fp = fopen(name, "wb");
 	if (!fp)
 		return 0;
@@ -1035,61 +1159,128 @@ char *iNesShortFName(void) {
 	return ret + 1;
 }
 
+//Identifies an iNES image in memory without loading it, for the ROM library
+//scanner.  Hashes it as iNESLoad does, padding included.  Only uses the
+//header, the corrections CheckHInfo applies aren't looked up.
+bool iNESIdentify(const char *name, const uint8 *data, uint32 size, ROMLIBENTRY *e) {
+	uint8 ff[4096];
+	iNES_HEADER h;
+	struct md5_context md5;
+	uint32 prg, chr, pos, len[2], total[2];
+	int ines2, notRound, round;
+
+	if (size < 16 || memcmp(data, "NES\x1A", 4))
+		return false;
+	memcpy(&h, data, 16);
+	h.cleanup();
+
+	ines2 = ((h.ROM_type2 & 0x0C) == 0x08);
+	e->mapper = iNESGetMapper(h, ines2);
+	round = iNESGetSizes(h, ines2, e->mapper, &prg, &chr, &notRound);
+
+	//Don't trust nonsense sizes from a broken header.
+	if (prg > 4096 || chr > 8192)
+		return false;
+
+	//Same reads as iNESLoad: PRG, then CHR straight after it, each filled
+	//up with 0xFF to its rounded size if the file is short.
+	pos = 16 + ((h.ROM_type & 4) ? 512 : 0);
+	total[0] = prg << 14;
+	total[1] = chr << 13;
+	len[0] = (round ? prg : notRound) << 14;
+	len[1] = total[1];
+
+	memset(ff, 0xFF, sizeof(ff));
+	md5_starts(&md5);
+	e->crc32 = 0;
+	for (int x = 0; x < 2; x++) {
+		uint32 n = (pos < size) ? size - pos : 0;
+
+		if (n > len[x])
+			n = len[x];
+		md5_update(&md5, (uint8 *)data + pos, n);
+		e->crc32 = CalcCRC32(e->crc32, (uint8 *)data + pos, n);
+		pos += n;
+
+		while (n < total[x]) {
+			uint32 f = total[x] - n;
+
+			if (f > sizeof(ff))
+				f = sizeof(ff);
+			md5_update(&md5, ff, f);
+			e->crc32 = CalcCRC32(e->crc32, ff, f);
+			n += f;
+		}
+	}
+	md5_finish(&md5, e->md5);
+
+	BMAPPINGLocal *mapper = iNESFindMapper(e->mapper);
+
+	e->format = ines2 ? "NES 2.0" : "iNES";
+	e->submapper = ines2 ? (h.ROM_type3 >> 4) : 0;
+	e->board = mapper ? mapper->name : "";
+	if (ines2)
+		e->region = h.TV_system & 3;
+	else
+		e->region = iNESNameIsPAL(name) ? 1 : 0;
+	e->prgSize = (round ? prg : notRound) << 14;
+	e->chrSize = chr << 13;
+	e->battery = (h.ROM_type & 2) != 0;
+	return true;
+}
+
 static int iNES_Init(int num) {
-	BMAPPINGLocal *tmp = bmap;
+	BMAPPINGLocal *tmp = iNESFindMapper(num);
 
 	CHRRAMSize = -1;
 
 	if (GameInfo->type == GIT_VSUNI)
 		AddExState(FCEUVSUNI_STATEINFO, ~0, 0, 0);
 
-	while (tmp->init) {
-		if (num == tmp->number) {
-			UNIFchrrama = NULL;	// need here for compatibility with UNIF mapper code
-			if (!VROM_size) {
-				if(!iNESCart.ines2)
-				{
-					switch (num) {	// FIXME, mapper or game data base with the board parameters and ROM/RAM sizes
-					case 13:  CHRRAMSize = 16 * 1024; break;
-					case 6:
-					case 29:
-					case 30:
-					case 45:
-					case 96:  CHRRAMSize = 32 * 1024; break;
-					case 176: CHRRAMSize = 128 * 1024; break;
-					default:  CHRRAMSize = 8 * 1024; break;
-					}
-					iNESCart.vram_size = CHRRAMSize;
-				}
-				else
-				{
-					CHRRAMSize = iNESCart.battery_vram_size + iNESCart.vram_size;
-				}
-				if (CHRRAMSize > 0)
-				{
-					int mCHRRAMSize = (CHRRAMSize < 1024) ? 1024 : CHRRAMSize; // VPage has a resolution of 1k banks, ensure minimum allocation to prevent malicious access from NES software
-					if ((UNIFchrrama = VROM = (uint8*)FCEU_dmalloc(mCHRRAMSize)) == NULL) return 2;
-					FCEU_MemoryRand(VROM, CHRRAMSize);
-					SetupCartCHRMapping(0, VROM, CHRRAMSize, 1);
-					AddExState(VROM, CHRRAMSize, 0, "CHRR");
-				}
-				else {
-					// mapper 256 (OneBus) has not CHR-RAM _and_ has not CHR-ROM region in iNES file
-					// so zero-sized CHR should be supported at least for this mapper
-					VROM = NULL;
-				}
-			}
-			if (head.ROM_type & 8)
-			{
-				if (ExtraNTARAM != NULL)
-				{
-					AddExState(ExtraNTARAM, 2048, 0, "EXNR");
-				}
+	if (!tmp)
+		return 1;
+
+	UNIFchrrama = NULL;	// need here for compatibility with UNIF mapper code
+	if (!VROM_size) {
+		if(!iNESCart.ines2)
+		{
+			switch (num) {	// FIXME, mapper or game data base with the board parameters and ROM/RAM sizes
+			case 13:  CHRRAMSize = 16 * 1024; break;
+			case 6:
+			case 29:
+			case 30:
+			case 45:
+			case 96:  CHRRAMSize = 32 * 1024; break;
+			case 176: CHRRAMSize = 128 * 1024; break;
+			default:  CHRRAMSize = 8 * 1024; break;
 			}
-			tmp->init(&iNESCart);
-			return 0;
+			iNESCart.vram_size = CHRRAMSize;
+		}
+		else
+		{
+			CHRRAMSize = iNESCart.battery_vram_size + iNESCart.vram_size;
+		}
+		if (CHRRAMSize > 0)
+		{
+			int mCHRRAMSize = (CHRRAMSize < 1024) ? 1024 : CHRRAMSize; // VPage has a resolution of 1k banks, ensure minimum allocation to prevent malicious access from NES software
+			if ((UNIFchrrama = VROM = (uint8*)FCEU_dmalloc(mCHRRAMSize)) == NULL) return 2;
+			FCEU_MemoryRand(VROM, CHRRAMSize);
+			SetupCartCHRMapping(0, VROM, CHRRAMSize, 1);
+			AddExState(VROM, CHRRAMSize, 0, "CHRR");
+		}
+		else {
+			// mapper 256 (OneBus) has not CHR-RAM _and_ has not CHR-ROM region in iNES file
+			// so zero-sized CHR should be supported at least for this mapper
+			VROM = NULL;
 		}
-		tmp++;
 	}
-	return 1;
+	if (head.ROM_type & 8)
+	{
+		if (ExtraNTARAM != NULL)
+		{
+			AddExState(ExtraNTARAM, 2048, 0, "EXNR");
+		}
+	}
+	tmp->init(&iNESCart);
+	return 0;
 }
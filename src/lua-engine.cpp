@@ -2273,6 +2273,11 @@ void CallRegisteredLuaMemHook(unsigned int address, int size, unsigned int value
 	}
 }
 
+bool FCEU_LuaExecHooked()
+{
+	return hookedRegions[LUAMEMHOOK_EXEC].NotEmpty();
+}
+
 void CallRegisteredLuaFunctions(LuaCallID calltype)
 {
 	assert((unsigned int)calltype < (unsigned int)LUACALL_COUNT);
@@ -2646,9 +2651,10 @@ static int zapper_read(lua_State *L){
 		else
 			z = currFrameCounter -1;
 
-		x = currMovieData.records[z].zappers[1].x;	//adelikat:  Used hardcoded port 1 since as far as I know, only port 1 is valid for zappers
-		y = currMovieData.records[z].zappers[1].y;
-		click = currMovieData.records[z].zappers[1].b;
+		MovieRecord mr = currMovieData.records.get(z);
+		x = mr.zappers[1].x;	//adelikat:  Used hardcoded port 1 since as far as I know, only port 1 is valid for zappers
+		y = mr.zappers[1].y;
+		click = mr.zappers[1].b;
 	}
 	else
 	{
@@ -3293,6 +3299,19 @@ static int movie_replay (lua_State *L) {
 	return 0;
 }
 
+// bool movie.seek(int frame)
+//
+//   Plays the current movie read-only up to the given frame and pauses there,
+//   replaying from the nearest state in the seek cache.
+static int movie_seek (lua_State *L) {
+
+	int frame = luaL_checkinteger(L,1);
+
+	lua_pushboolean(L, FCEUI_MovieSeek(frame));
+
+	return 1;
+}
+
 // bool movie.play(string filename, [bool read_only, [int pauseframe]])
 //
 //   Loads and plays a movie.
@@ -6027,6 +6046,7 @@ static const struct luaL_reg movielib[] = {
 	{"readonly", movie_getreadonly},
 	{"setreadonly", movie_setreadonly},
 	{"replay", movie_replay},
+	{"seek", movie_seek},
 	{"record", movie_record},
 	{"play", movie_playback},
 
@@ -119,28 +119,17 @@ char lagcounterbuf[32] = {0};
 
 void MovieData::clearRecordRange(int start, int len)
 {
+	MovieRecord empty;
 	for(int i=0;i<len;i++)
 	{
-		records[i+start].clear();
+		records.set(i+start, empty);
 	}
 }
 
 void MovieData::eraseRecords(int at, int frames)
 {
-	if (at < (int)records.size())
-	{
-		if (frames == 1)
-		{
-			// erase 1 frame
-			records.erase(records.begin() + at);
-		} else
-		{
-			// erase many frames
-			if (at + frames > (int)records.size())
-				frames = (int)records.size() - at;
-			records.erase(records.begin() + at, records.begin() + (at + frames));
-		}
-	}
+	if (at < records.size())
+		records.erase(at, frames);
 }
 
 void MovieData::insertEmpty(int at, int frames)
@@ -150,7 +139,7 @@ void MovieData::insertEmpty(int at, int frames)
 		records.resize(records.size() + frames);
 	} else
 	{
-		records.insert(records.begin() + at, frames, MovieRecord());
+		records.insert(at, frames);
 	}
 }
 
@@ -158,10 +147,231 @@ void MovieData::cloneRegion(int at, int frames)
 {
 	if (at < 0) return;
 
-	records.insert(records.begin() + at, frames, MovieRecord());
+	records.insert(at, frames);
 
 	for(int i = 0; i < frames; i++)
-		records[i + at].Clone(records[i + at + frames]);
+		records.set(i + at, records.get(i + at + frames));
+}
+// ----------------------------------------------------------------------------
+static bool ZapperEmpty(const MovieZapper& z)
+{
+	return !z.x && !z.y && !z.b && !z.bogo && !z.zaphit;
+}
+
+static bool ZapperSame(const MovieZapper& a, const MovieZapper& b)
+{
+	return a.x == b.x && a.y == b.y && a.b == b.b && a.bogo == b.bogo && a.zaphit == b.zaphit;
+}
+
+//moves every entry at or after frame "at" by delta frames
+template<typename T>
+static void ShiftSparse(std::map<int,T>& m, int at, int delta)
+{
+	typename std::map<int,T>::iterator it = m.lower_bound(at);
+	if (it == m.end())
+		return;
+	std::map<int,T> moved(it, m.end());
+	m.erase(it, m.end());
+	for (typename std::map<int,T>::iterator i = moved.begin(); i != moved.end(); ++i)
+		m.insert(m.end(), std::make_pair(i->first + delta, i->second));
+}
+
+//the first frame before end with an entry in one map that the other doesn't match, or -1
+template<typename T>
+static int FirstSparseDifference(const std::map<int,T>& a, const std::map<int,T>& b, int end)
+{
+	typename std::map<int,T>::const_iterator i = a.begin(), j = b.begin();
+	for (;;)
+	{
+		int fi = (i != a.end()) ? i->first : end;
+		int fj = (j != b.end()) ? j->first : end;
+		int frame = std::min(fi, fj);
+		if (frame >= end)
+			return -1;
+		if (fi != fj || !(i->second == j->second))
+			return frame;
+		++i;
+		++j;
+	}
+}
+
+bool MovieRecordList::ZapperPair::operator==(const ZapperPair& other) const
+{
+	return ZapperSame(port[0], other.port[0]) && ZapperSame(port[1], other.port[1]);
+}
+
+MovieRecordList::MovieRecordList()
+	: cols(new Columns())
+{
+}
+
+//gives this list its own columns before they are changed
+MovieRecordList::Columns& MovieRecordList::edit()
+{
+	if (cols.use_count() > 1)
+		cols.reset(new Columns(*cols));
+	return *cols;
+}
+
+void MovieRecordList::clear()
+{
+	cols.reset(new Columns());
+}
+
+void MovieRecordList::resize(int frames)
+{
+	if (frames == size())
+		return;
+	Columns& c = edit();
+	c.joysticks.resize(frames * 4, 0);
+	c.commands.erase(c.commands.lower_bound(frames), c.commands.end());
+	c.zappers.erase(c.zappers.lower_bound(frames), c.zappers.end());
+}
+
+void MovieRecordList::reserve(int frames)
+{
+	edit().joysticks.reserve(frames * 4);
+}
+
+MovieRecord MovieRecordList::get(int frame) const
+{
+	MovieRecord mr;
+	memcpy(mr.joysticks.data, &cols->joysticks[frame * 4], 4);
+	mr.commands = commands(frame);
+	if (!cols->zappers.empty())
+	{
+		std::map<int,ZapperPair>::const_iterator it = cols->zappers.find(frame);
+		if (it != cols->zappers.end())
+		{
+			mr.zappers[0] = it->second.port[0];
+			mr.zappers[1] = it->second.port[1];
+		}
+	}
+	return mr;
+}
+
+void MovieRecordList::set(int frame, const MovieRecord& mr)
+{
+	Columns& c = edit();
+	memcpy(&c.joysticks[frame * 4], mr.joysticks.data, 4);
+	if (mr.commands)
+		c.commands[frame] = mr.commands;
+	else
+		c.commands.erase(frame);
+	if (!ZapperEmpty(mr.zappers[0]) || !ZapperEmpty(mr.zappers[1]))
+	{
+		ZapperPair& zp = c.zappers[frame];
+		zp.port[0] = mr.zappers[0];
+		zp.port[1] = mr.zappers[1];
+	} else
+		c.zappers.erase(frame);
+}
+
+void MovieRecordList::push_back(const MovieRecord& mr)
+{
+	Columns& c = edit();
+	int frame = size();
+	c.joysticks.insert(c.joysticks.end(), mr.joysticks.data, mr.joysticks.data + 4);
+	if (mr.commands)
+		c.commands.insert(c.commands.end(), std::make_pair(frame, mr.commands));
+	if (!ZapperEmpty(mr.zappers[0]) || !ZapperEmpty(mr.zappers[1]))
+	{
+		ZapperPair zp;
+		zp.port[0] = mr.zappers[0];
+		zp.port[1] = mr.zappers[1];
+		c.zappers.insert(c.zappers.end(), std::make_pair(frame, zp));
+	}
+}
+
+void MovieRecordList::insert(int at, int frames, const MovieRecord& mr)
+{
+	if (frames <= 0)
+		return;
+	Columns& c = edit();
+	ShiftSparse(c.commands, at, frames);
+	ShiftSparse(c.zappers, at, frames);
+	c.joysticks.insert(c.joysticks.begin() + at * 4, frames * 4, 0);
+	for (int i = 0; i < frames; i++)
+		set(at + i, mr);
+}
+
+void MovieRecordList::erase(int at, int frames)
+{
+	if (at + frames > size())
+		frames = size() - at;
+	if (frames <= 0)
+		return;
+	Columns& c = edit();
+	c.joysticks.erase(c.joysticks.begin() + at * 4, c.joysticks.begin() + (at + frames) * 4);
+	c.commands.erase(c.commands.lower_bound(at), c.commands.lower_bound(at + frames));
+	c.zappers.erase(c.zappers.lower_bound(at), c.zappers.lower_bound(at + frames));
+	ShiftSparse(c.commands, at + frames, -frames);
+	ShiftSparse(c.zappers, at + frames, -frames);
+}
+
+void MovieRecordList::setJoystick(int frame, int joy, uint8 val)
+{
+	if (joystick(frame, joy) != val)
+		edit().joysticks[frame * 4 + joy] = val;
+}
+
+uint8 MovieRecordList::commands(int frame) const
+{
+	if (cols->commands.empty())
+		return 0;
+	std::map<int,uint8>::const_iterator it = cols->commands.find(frame);
+	return (it != cols->commands.end()) ? it->second : 0;
+}
+
+void MovieRecordList::setCommands(int frame, uint8 val)
+{
+	if (commands(frame) == val)
+		return;
+	if (val)
+		edit().commands[frame] = val;
+	else
+		edit().commands.erase(frame);
+}
+
+void MovieRecordList::setBitValue(int frame, int joy, int bit, bool val)
+{
+	uint8 joy_val = joystick(frame, joy);
+	if (val)
+		joy_val |= (1 << bit);
+	else
+		joy_val &= ~(1 << bit);
+	setJoystick(frame, joy, joy_val);
+}
+
+int MovieRecordList::firstDifference(const MovieRecordList& other, int end) const
+{
+	//lists that still share their columns can't differ
+	if (cols == other.cols || end <= 0)
+		return -1;
+
+	int first = -1;
+	const uint8* a = &cols->joysticks[0];
+	const uint8* b = &other.cols->joysticks[0];
+	if (memcmp(a, b, end * 4))
+	{
+		for (int x = 0; x < end; x++)
+		{
+			if (memcmp(a + x * 4, b + x * 4, 4))
+			{
+				first = x;
+				break;
+			}
+		}
+		end = first;
+	}
+
+	int x = FirstSparseDifference(cols->commands, other.cols->commands, end);
+	if (x != -1)
+		first = end = x;
+	x = FirstSparseDifference(cols->zappers, other.cols->zappers, end);
+	if (x != -1)
+		first = x;
+	return first;
 }
 // ----------------------------------------------------------------------------
 MovieRecord::MovieRecord()
@@ -484,9 +694,8 @@ void MovieData::installValue(std::string& key, std::string& val)
 	}
 }
 
-int MovieData::dump(EMUFILE *os, bool binary, bool seekToCurrFramePos)
+void MovieData::dumpHeader(EMUFILE *os, bool binary)
 {
-	int start = os->ftell();
 	os->fprintf("version %d\n", version);
 	os->fprintf("emuVersion %d\n", emuVersion);
 	os->fprintf("rerecordCount %d\n", rerecordCount);
@@ -521,6 +730,12 @@ int MovieData::dump(EMUFILE *os, bool binary, bool seekToCurrFramePos)
 
 	if (this->loadFrameCount >= 0)
 		os->fprintf("length %d\n" , this->loadFrameCount);
+}
+
+int MovieData::dump(EMUFILE *os, bool binary, bool seekToCurrFramePos)
+{
+	int start = os->ftell();
+	dumpHeader(os, binary);
 
 	int currFramePos = -1;
 	if(binary)
@@ -531,7 +746,7 @@ int MovieData::dump(EMUFILE *os, bool binary, bool seekToCurrFramePos)
 		{
 			if (seekToCurrFramePos && currFrameCounter == i)
 				currFramePos = os->ftell();
-			records[i].dumpBinary(this, os, i);
+			records.get(i).dumpBinary(this, os, i);
 		}
 	} else
 	{
@@ -539,7 +754,7 @@ int MovieData::dump(EMUFILE *os, bool binary, bool seekToCurrFramePos)
 		{
 			if (seekToCurrFramePos && currFrameCounter == i)
 				currFramePos = os->ftell();
-			records[i].dump(this, os, i);
+			records.get(i).dump(this, os, i);
 		}
 	}
 
@@ -599,7 +814,25 @@ bool FCEUMOV_Mode(int modemask)
 	return FCEUMOV_Mode((EMOVIEMODE)modemask);
 }
 
-static void LoadFM2_binarychunk(MovieData& movieData, EMUFILE* fp, int size)
+//The input records of a movie file, found by LoadFM2Lazy but only decoded
+//once something needs them.
+struct FM2Records
+{
+	struct Line { int start, end; };
+
+	std::vector<uint8> data;		//the file, from where loading started
+	std::vector<Line> lines;		//text records, from after the first pipe to the end of the line
+	int binaryStart, binarySize;	//binary records, if binarySize isn't 0
+	int binaryCount;
+	int decoded;
+
+	FM2Records() : binaryStart(0), binarySize(0), binaryCount(0), decoded(0) {}
+	int count() const;
+	//appends the records before frame "frames" that aren't decoded yet
+	void decode(MovieData& movieData, int frames);
+};
+
+static int FM2BinaryRecordSize(MovieData& movieData)
 {
 	int recordsize = 1; //1 for the command
 	if(movieData.fourscore)
@@ -615,30 +848,162 @@ static void LoadFM2_binarychunk(MovieData& movieData, EMUFILE* fp, int size)
 			}
 		}
 	}
+	return recordsize;
+}
 
-	//find out how much remains in the file
-	int curr = fp->ftell();
-	fp->fseek(0,SEEK_END);
-	int end = fp->ftell();
-	int flen = end-curr;
-	fp->fseek(curr,SEEK_SET);
+//Reads one record of a text movie out of memory, from just after its first
+//pipe to the end of its line, the way MovieRecord::parse reads it from a file.
+class FM2TextRecord
+{
+public:
+	FM2TextRecord(const uint8* start, const uint8* end) : p(start), end(end) {}
+
+	void parse(MovieData* md, MovieRecord& mr)
+	{
+		mr.commands = dec();
+		get(); //eat the pipe
+
+		if(md->fourscore)
+		{
+			for(int i=0;i<4;i++)
+			{
+				mr.joysticks[i] = joy();
+				get(); //eat the pipe
+			}
+		}
+		else
+		{
+			for(int port=0;port<2;port++)
+			{
+				if(md->ports[port] == SI_GAMEPAD)
+					mr.joysticks[port] = joy();
+				else if(md->ports[port] == SI_ZAPPER)
+				{
+					mr.zappers[port].x = dec();
+					mr.zappers[port].y = dec();
+					mr.zappers[port].b = dec();
+					mr.zappers[port].bogo = dec();
+					mr.zappers[port].zaphit = dec();
+				}
+				get(); //eat the pipe
+			}
+		}
+	}
 
-	//the amount todo is the min of the limiting size we received and the remaining contents of the file
-	int todo = std::min<int>(size, flen);
+private:
+	const uint8 *p, *end;
 
-	int numRecords = todo/recordsize;
-	if (movieData.loadFrameCount!=-1 && movieData.loadFrameCount<numRecords)
-		numRecords=movieData.loadFrameCount;
+	int get() { return (p < end) ? *p++ : -1; }
 
-	movieData.records.resize(numRecords);
-	for(int i=0;i<numRecords;i++)
+	//like uint32DecFromIstream: skips to the first digit, stops after the last
+	uint32 dec()
 	{
-		movieData.records[i].parseBinary(&movieData,fp);
+		uint32 ret = 0;
+		bool pre = true;
+		for(;;)
+		{
+			int c = get();
+			if(c == -1) return ret;
+			int d = c - '0';
+			if(d<0 || d>9)
+			{
+				if(!pre)
+					break;
+			}
+			else
+			{
+				pre = false;
+				ret = ret * 10 + d;
+			}
+		}
+		p--;
+		return ret;
+	}
+
+	uint8 joy()
+	{
+		uint8 joystate = 0;
+		for(int i=0;i<8;i++)
+		{
+			int c = get();
+			joystate <<= 1;
+			joystate |= (c==-1||c=='.'||c==' ')?0:1;
+		}
+		return joystate;
+	}
+};
+
+static void ParseFM2BinaryRecord(MovieData* md, const uint8* p, MovieRecord& mr)
+{
+	mr.commands = *p++;
+	if(md->fourscore)
+	{
+		memcpy(mr.joysticks.data, p, 4);
+	}
+	else
+	{
+		for(int port=0;port<2;port++)
+		{
+			if(md->ports[port] == SI_GAMEPAD)
+				mr.joysticks[port] = *p++;
+			else if(md->ports[port] == SI_ZAPPER)
+			{
+				mr.zappers[port].x = p[0];
+				mr.zappers[port].y = p[1];
+				mr.zappers[port].b = p[2];
+				mr.zappers[port].bogo = p[3];
+				mr.zappers[port].zaphit = 0;
+				for(int i=11;i>=4;i--)
+					mr.zappers[port].zaphit = (mr.zappers[port].zaphit << 8) | p[i];
+				p += 12;
+			}
+		}
+	}
+}
+
+int FM2Records::count() const
+{
+	return binarySize ? binaryCount : (int)lines.size();
+}
+
+void FM2Records::decode(MovieData& movieData, int frames)
+{
+	if(frames > count())
+		frames = count();
+	if(frames <= decoded)
+		return;
+
+	movieData.records.reserve(movieData.records.size() + frames - decoded);
+	for(;decoded<frames;decoded++)
+	{
+		MovieRecord mr;
+		if(binarySize)
+			ParseFM2BinaryRecord(&movieData, &data[binaryStart + decoded * binarySize], mr);
+		else
+			FM2TextRecord(&data[lines[decoded].start], &data[0] + lines[decoded].end).parse(&movieData, mr);
+		movieData.records.push_back(mr);
 	}
 }
 
+//Reads the rest of the movie, or only the next block of it when just the
+//header is wanted.  Returns false when there is nothing left.
+static bool ReadFM2Data(EMUFILE* fp, int& remaining, bool headerOnly, std::vector<uint8>& data)
+{
+	int todo = headerOnly ? std::min(remaining, 0x10000) : remaining;
+	if(todo <= 0)
+		return false;
+	int have = (int)data.size();
+	data.resize(have + todo);
+	int got = (int)fp->fread(&data[have], todo);
+	data.resize(have + got);
+	remaining = got ? remaining - todo : 0;
+	return got > 0;
+}
+
 //yuck... another custom text parser.
-bool LoadFM2(MovieData& movieData, EMUFILE* fp, int size, bool stopAfterHeader)
+//The header goes into movieData, the input records are only found and left
+//in records for decoding later.
+static bool LoadFM2Lazy(MovieData& movieData, EMUFILE* fp, int size, bool stopAfterHeader, FM2Records& records)
 {
 	// if there's no "binary" tag in the movie header, consider it as a movie in text format
 	movieData.binaryFlag = false;
@@ -668,6 +1033,18 @@ bool LoadFM2(MovieData& movieData, EMUFILE* fp, int size, bool stopAfterHeader)
 	if(memcmp(buf,"version 3",9))
 		return false;
 
+	//read no further than size or the end of the file
+	fp->fseek(0,SEEK_END);
+	int remaining = std::min<int>(size, fp->ftell() - (int)curr);
+	fp->fseek(curr,SEEK_SET);
+
+	std::vector<uint8>& data = records.data;
+	data.clear();
+	records.lines.clear();
+	records.binarySize = records.binaryCount = records.decoded = 0;
+	int base = movieData.records.size();
+	int pos = 0;
+
 	std::string key,value;
 	enum {
 		NEWLINE, KEY, SEPARATOR, VALUE, RECORD, COMMENT, SUBTITLE
@@ -677,20 +1054,26 @@ bool LoadFM2(MovieData& movieData, EMUFILE* fp, int size, bool stopAfterHeader)
 	int c;
 	for(;;)
 	{
-		if(size--<=0) goto bail;
-		c = fp->fgetc();
-		if(c == -1)
+		if(pos == (int)data.size() && !ReadFM2Data(fp, remaining, stopAfterHeader, data))
 			goto bail;
+		c = data[pos++];
 		iswhitespace = (c==' '||c=='\t');
 		isrecchar = (c=='|');
 		isnewline = (c==10||c==13);
 		if(isrecchar && movieData.binaryFlag && !stopAfterHeader)
 		{
-			LoadFM2_binarychunk(movieData, fp, size);
-			return true;
-		} else if (isnewline && movieData.loadFrameCount == movieData.records.size())
+			//the rest is fixed size records
+			movieData.records.clear();
+			records.binarySize = FM2BinaryRecordSize(movieData);
+			records.binaryStart = pos;
+			records.binaryCount = ((int)data.size() - pos) / records.binarySize;
+			if (movieData.loadFrameCount!=-1 && movieData.loadFrameCount<records.binaryCount)
+				records.binaryCount = movieData.loadFrameCount;
+			pos += records.binaryCount * records.binarySize;
+			break;
+		} else if (isnewline && movieData.loadFrameCount == base + (int)records.lines.size())
 			// exit prematurely if loaded the specified amound of records
-			return true;
+			break;
 		switch(state)
 		{
 		case NEWLINE:
@@ -706,13 +1089,17 @@ bool LoadFM2(MovieData& movieData, EMUFILE* fp, int size, bool stopAfterHeader)
 		case RECORD:
 			{
 				dorecord:
-				if (stopAfterHeader) return true;
-				int currcount = movieData.records.size();
-				movieData.records.resize(currcount+1);
-				int preparse = fp->ftell();
-				movieData.records[currcount].parse(&movieData, fp);
-				int postparse = fp->ftell();
-				size -= (postparse-preparse);
+				if (stopAfterHeader) goto finish;
+				//a record runs to the end of its line
+				FM2Records::Line line;
+				line.start = pos;
+				const uint8* start = &data[0] + pos;
+				int len = (int)data.size() - pos;
+				const uint8* lf = (const uint8*)memchr(start, '\n', len);
+				const uint8* cr = (const uint8*)memchr(start, '\r', lf ? lf - start : len);
+				line.end = cr ? (int)(cr - &data[0]) : lf ? (int)(lf - &data[0]) : (int)data.size();
+				records.lines.push_back(line);
+				pos = line.end;
 				state = NEWLINE;
 				break;
 			}
@@ -752,6 +1139,18 @@ bool LoadFM2(MovieData& movieData, EMUFILE* fp, int size, bool stopAfterHeader)
 		if(bail) break;
 	}
 
+	finish:
+	//leave the file just after what was used, as a caller may read on from there
+	fp->fseek((int)curr + pos,SEEK_SET);
+	return true;
+}
+
+bool LoadFM2(MovieData& movieData, EMUFILE* fp, int size, bool stopAfterHeader)
+{
+	FM2Records records;
+	if(!LoadFM2Lazy(movieData, fp, size, stopAfterHeader, records))
+		return false;
+	records.decode(movieData, records.count());
 	return true;
 }
 
@@ -792,14 +1191,16 @@ static const char *GetMovieRecordModeStr()
 	}
 }
 
-static EMUFILE *openRecordingMovie(const char* fname)
+static EMUFILE *openRecordingMovie(const char* fname, const char* mode = "wb")
 {
 	if (osRecordingMovie)
 		delete osRecordingMovie;
 
-	osRecordingMovie = FCEUD_UTF8_fstream(fname, "wb");
+	osRecordingMovie = FCEUD_UTF8_fstream(fname, mode);
 	if (!osRecordingMovie || osRecordingMovie->fail()) {
 		FCEU_PrintError("Error opening movie output file: %s", fname);
+		delete osRecordingMovie;
+		osRecordingMovie = 0;
 		return NULL;
 	}
 	strcpy(curMovieFilename, fname);
@@ -816,22 +1217,304 @@ static void closeRecordingMovie()
 	}
 }
 
+//In-memory savestates taken while a movie plays or records, keyed by frame,
+//so that seeking only replays the frames after the nearest one.  As in the
+//TAS Editor's greenzone, states far from the current frame get thinned out,
+//but here only once the memory budget is used up.
+#define SEEKCACHE_INTERVAL 60
+#define SEEKCACHE_FALLOFF 3600		//gaps this many frames away count half
+int movieSeekCacheMB = 64;	//0 turns the cache off
+static struct
+{
+	std::map<int, std::vector<uint8> > states;
+	int64 bytes;
+	bool loading;				//FCEUMOV_LoadStateInMovie's states carry no movie, FCEUMOV_PostLoad mustn't expect one
+	bool turbo;					//FCEUI_MovieSeek turned turbo on
+} seekCache = { std::map<int, std::vector<uint8> >(), 0, false, false };
+
+static void ClearSeekCache()
+{
+	seekCache.states.clear();
+	seekCache.bytes = 0;
+}
+
+//Drops the states after "frame", where the input has changed.
+static void InvalidateSeekCache(int frame)
+{
+	std::map<int, std::vector<uint8> >::iterator it = seekCache.states.upper_bound(frame);
+	while (it != seekCache.states.end())
+	{
+		seekCache.bytes -= it->second.size();
+		seekCache.states.erase(it++);
+	}
+}
+
+//While over budget, drops the state whose loss leaves the smallest gap,
+//gaps counting for less the farther they are from the current frame.  That
+//spaces the states out in proportion to their distance, so their number only
+//grows with the log of the movie's length.  The first state is always kept.
+static void ThinSeekCache()
+{
+	int64 budget = (int64)movieSeekCacheMB << 20;
+	while (seekCache.bytes > budget && seekCache.states.size() > 1)
+	{
+		std::map<int, std::vector<uint8> >::iterator prev = seekCache.states.begin(), it = prev, next;
+		std::map<int, std::vector<uint8> >::iterator best = seekCache.states.end();
+		double bestGap = 0;
+		for (++it; it != seekCache.states.end(); prev = it++)
+		{
+			next = it;
+			++next;
+			int end = (next == seekCache.states.end()) ? (int)currMovieData.records.size() : next->first;
+			double gap = (end - prev->first) / (1.0 + (double)abs(it->first - currFrameCounter) / SEEKCACHE_FALLOFF);
+			if (best == seekCache.states.end() || gap < bestGap)
+			{
+				best = it;
+				bestGap = gap;
+			}
+		}
+		seekCache.bytes -= best->second.size();
+		seekCache.states.erase(best);
+	}
+}
+
+static void StopSeekTurbo()
+{
+	if (seekCache.turbo)
+	{
+		FCEUD_TurboOff();
+		seekCache.turbo = false;
+	}
+}
+
+//Called at every frame boundary, like the autosaves.
+void FCEUMOV_UpdateSeekCache()
+{
+	//in case a loadstate took us past where the seek was going to pause
+	if (seekCache.turbo && pauseframe <= currFrameCounter)
+		StopSeekTurbo();
+
+	if (!movieSeekCacheMB)
+	{
+		if (seekCache.bytes)
+			ClearSeekCache();
+		return;
+	}
+	if (!FCEUMOV_Mode(MOVIEMODE_PLAY|MOVIEMODE_RECORD|MOVIEMODE_FINISHED))
+		return;
+	if (currFrameCounter % SEEKCACHE_INTERVAL || currFrameCounter > (int)currMovieData.records.size())
+		return;
+
+	std::vector<uint8>& state = seekCache.states[currFrameCounter];
+	if (state.size())
+		return;
+	if (!FCEUMOV_SaveStateInMovie(state))
+	{
+		seekCache.states.erase(currFrameCounter);
+		return;
+	}
+	seekCache.bytes += state.size();
+	ThinSeekCache();
+}
+
+bool FCEUMOV_SaveStateInMovie(std::vector<uint8>& state)
+{
+	EMUFILE_MEMORY ms(&state);
+	if (!FCEUSS_SaveMS(&ms, Z_BEST_SPEED, false))
+		return false;
+	ms.trim();
+	return true;
+}
+
+bool FCEUMOV_LoadStateInMovie(std::vector<uint8>& state)
+{
+	EMUFILE_MEMORY ms(&state);
+	seekCache.loading = true;
+	bool loaded = FCEUSS_LoadFP(&ms, SSLOADPARAM_NOBACKUP);
+	seekCache.loading = false;
+	return loaded;
+}
+
+//What the movie file holds, as last written from currMovieData, so that a
+//change only rewrites the file from the first frame it touches.  While every
+//frame takes the same number of bytes, as they do in most gamepad movies,
+//a frame is found from that width; after that from a table of frame ends.
+static struct
+{
+	bool valid;					//false until we've written the whole file
+	std::vector<uint8> header;
+	int frames;
+	int width;					//bytes per frame, 0 before the first, -1 once they differ
+	std::vector<int> ends;		//where each frame ends, once widths differ
+	int pendingFrom;			//first frame still to be written, or INT_MAX
+} movieFile = { false, std::vector<uint8>(), 0, 0, std::vector<int>(), INT_MAX };
+
+static void ForgetMovieFile()
+{
+	movieFile.valid = false;
+	movieFile.header.clear();
+	movieFile.frames = 0;
+	movieFile.width = 0;
+	movieFile.ends.clear();
+	movieFile.pendingFrom = INT_MAX;
+}
+
+static int MovieFileFrameStart(int frame)
+{
+	if (frame == 0)
+		return (int)movieFile.header.size();
+	if (movieFile.width >= 0)
+		return (int)movieFile.header.size() + frame * movieFile.width;
+	return movieFile.ends[frame - 1];
+}
+
+static void SetMovieFileFrameEnd(int frame, int end)
+{
+	int width = end - MovieFileFrameStart(frame);
+	if (movieFile.width == 0)
+		movieFile.width = width;
+	if (movieFile.width == width)
+		return;
+	if (movieFile.width > 0)
+	{
+		//first frame of a different width: list where all of them end
+		movieFile.ends.resize(std::max(movieFile.frames, frame));
+		for (int i = 0; i < (int)movieFile.ends.size(); i++)
+			movieFile.ends[i] = (int)movieFile.header.size() + (i + 1) * movieFile.width;
+		movieFile.width = -1;
+	}
+	if (frame < (int)movieFile.ends.size())
+		movieFile.ends[frame] = end;
+	else
+		movieFile.ends.push_back(end);
+}
+
+//Writes the frames of currMovieData from "from" on.  Frames from "to" on
+//haven't changed, so writing stops there if they are still in place.
+static void WriteMovieFileFrames(int from, int to)
+{
+	EMUFILE* os = osRecordingMovie;
+	int numFrames = currMovieData.records.size();
+	int oldFrames = movieFile.frames;
+	int oldEnd = MovieFileFrameStart(oldFrames);
+
+	if (movieFile.pendingFrom < from)
+	{
+		from = movieFile.pendingFrom;
+		to = INT_MAX;
+	}
+	movieFile.pendingFrom = INT_MAX;
+	if (from > oldFrames)
+		from = oldFrames;
+
+	int pos = MovieFileFrameStart(from);
+	int oldStart = pos;
+	bool inPlace = false;
+	EMUFILE_MEMORY buf;
+
+	os->fseek(pos, SEEK_SET);
+	for (int frame = from; frame < numFrames; frame++)
+	{
+		if (frame >= to && frame < oldFrames && pos == oldStart)
+		{
+			//the rest of the file is still right
+			inPlace = true;
+			break;
+		}
+		int bufStart = buf.size();
+		currMovieData.records.get(frame).dump(&currMovieData, &buf, frame);
+		oldStart = (frame < oldFrames) ? MovieFileFrameStart(frame + 1) : -1;
+		pos += buf.size() - bufStart;
+		SetMovieFileFrameEnd(frame, pos);
+		if (buf.size() >= 0x10000)
+		{
+			os->fwrite(buf.buf(), buf.size());
+			buf.truncate(0);
+		}
+	}
+	if (buf.size())
+		os->fwrite(buf.buf(), buf.size());
+
+	if (!inPlace)
+	{
+		movieFile.frames = numFrames;
+		if (movieFile.width < 0)
+			movieFile.ends.resize(numFrames);
+		if (pos < oldEnd)
+			os->truncate(pos);
+	}
+}
+
+//Rewrites the header if it changed.  Returns false if its size changed, as
+//then everything after it has to move.
+static bool WriteMovieFileHeader()
+{
+	EMUFILE_MEMORY header;
+	currMovieData.dumpHeader(&header, false);
+	if (header.size() != (int)movieFile.header.size())
+		return false;
+	if (header.size() && memcmp(header.buf(), &movieFile.header[0], header.size()))
+	{
+		osRecordingMovie->fseek(0, SEEK_SET);
+		osRecordingMovie->fwrite(header.buf(), header.size());
+		memcpy(&movieFile.header[0], header.buf(), header.size());
+	}
+	return true;
+}
+
+//Writes the whole movie to a freshly opened osRecordingMovie.
+static void WriteWholeMovieFile()
+{
+	ForgetMovieFile();
+	EMUFILE_MEMORY header;
+	currMovieData.dumpHeader(&header, false);
+	movieFile.header.assign(header.buf(), header.buf() + header.size());
+	osRecordingMovie->fwrite(header.buf(), header.size());
+	WriteMovieFileFrames(0, INT_MAX);
+	movieFile.valid = true;
+}
+
 // Callers shall set the approriate movieMode before calling this
-static void RedumpWholeMovieFile(bool justToggledRecording = false)
+//Brings the movie file up to date after the frames of currMovieData changed
+//from "changedFrom" on, or just the header.  Only rewrites the whole file
+//when the header changed size or the file isn't the one we wrote.
+static void UpdateMovieFile(int changedFrom, bool justToggledRecording = false)
 {
 	bool recording = (movieMode == MOVIEMODE_RECORD);
 	assert((NULL != osRecordingMovie) == (recording != justToggledRecording) && "osRecordingMovie should be consistent with movie mode!");
 
-	if (NULL == openRecordingMovie(curMovieFilename))
-		return;
+	bool updated = false;
+	if (movieFile.valid && (osRecordingMovie || openRecordingMovie(curMovieFilename, "r+b")))
+	{
+		//someone else may have written it since
+		if (osRecordingMovie->size() == MovieFileFrameStart(movieFile.frames) && WriteMovieFileHeader())
+		{
+			WriteMovieFileFrames(changedFrom, INT_MAX);
+			updated = true;
+		}
+	}
+	if (!updated)
+	{
+		if (NULL == openRecordingMovie(curMovieFilename))
+			return;
+		WriteWholeMovieFile();
+	}
+	InvalidateSeekCache(changedFrom);
 
-	currMovieData.dump(osRecordingMovie, false/*currMovieData.binaryFlag*/, recording);
 	if (recording)
 		osRecordingMovie->fflush();
 	else
 		closeRecordingMovie();
 }
 
+//First frame where the movie file would change if currMovieData became md.
+static int MovieFileChangedFrom(MovieData& md)
+{
+	int common = std::min(currMovieData.records.size(), md.records.size());
+	int diff = currMovieData.records.firstDifference(md.records, common);
+	return (diff < 0) ? common : diff;
+}
+
 /// Stop movie playback.
 static void StopPlayback()
 {
@@ -862,7 +1545,7 @@ static void StopRecording()
 	assert(movieMode == MOVIEMODE_RECORD);
 
 	movieMode = MOVIEMODE_INACTIVE;
-	RedumpWholeMovieFile(true);
+	UpdateMovieFile(currMovieData.records.size(), true);
 	FCEU_DispMessage("Movie recording stopped.",0);
 }
 
@@ -871,6 +1554,9 @@ static void OnMovieClosed()
 	assert(movieMode == MOVIEMODE_INACTIVE);
 
 	curMovieFilename[0] = 0;			//No longer a current movie filename
+	ForgetMovieFile();					//nor a file we wrote
+	ClearSeekCache();
+	StopSeekTurbo();
 	freshMovie = false;					//No longer a fresh movie loaded
 	if (bindSavestate) AutoSS = false;	//If bind movies to savestates is true, then there is no longer a valid auto-save to load
 
@@ -1033,6 +1719,8 @@ bool FCEUI_LoadMovie(const char *fname, bool _read_only, int _pauseframe)
 	currMovieData = MovieData();
 
 	strcpy(curMovieFilename, fname);
+	ForgetMovieFile();
+	ClearSeekCache();
 	FCEUFILE *fp = FCEU_fopen(fname,0,"rb",0);
 	if (!fp) return false;
 	if(fp->isArchive() && !_read_only) {
@@ -1145,6 +1833,7 @@ void FCEUI_SaveMovie(const char *fname, EMOVIE_FLAG flags, std::wstring author)
 	currFrameCounter = 0;
 	LagCounterReset();
 	FCEUMOV_CreateCleanMovie();
+	ClearSeekCache();
 	if(author != L"") currMovieData.comments.push_back(L"author " + author);
 
 	if(flags & MOVIE_FLAG_FROM_POWERON)
@@ -1169,7 +1858,7 @@ void FCEUI_SaveMovie(const char *fname, EMOVIE_FLAG flags, std::wstring author)
 	FCEUMOV_ClearCommands();
 
 	//we are going to go ahead and dump the header. from now on we will only be appending frames
-	currMovieData.dump(osRecordingMovie, false);
+	WriteWholeMovieFile();
 
 	movieMode = MOVIEMODE_RECORD;
 	movie_readonly = false;
@@ -1191,28 +1880,29 @@ void FCEUMOV_AddInputState()
 		if (((int)currMovieData.records.size() - 1) < (currFrameCounter + 1))
 			currMovieData.insertEmpty(-1, (currFrameCounter + 1) - ((int)currMovieData.records.size() - 1));
 
-		MovieRecord* mr = &currMovieData.records[currFrameCounter];
+		MovieRecord mr = currMovieData.records.get(currFrameCounter);
 		if (isTaseditorRecording())
 		{
 			// record commands and buttons
-			mr->commands |= _currCommand;
-			joyports[0].log(mr);
-			joyports[1].log(mr);
+			mr.commands |= _currCommand;
+			joyports[0].log(&mr);
+			joyports[1].log(&mr);
+			currMovieData.records.set(currFrameCounter, mr);
 			recordInputByTaseditor();
 		}
 		// replay buttons
-		joyports[0].load(mr);
-		joyports[1].load(mr);
+		joyports[0].load(&mr);
+		joyports[1].load(&mr);
 		// replay commands
-		if (mr->command_power())
+		if (mr.command_power())
 			PowerNES();
-		if (mr->command_reset())
+		if (mr.command_reset())
 			ResetNES();
-		if (mr->command_fds_insert())
+		if (mr.command_fds_insert())
 			FCEU_FDSInsert();
-		if (mr->command_fds_select())
+		if (mr.command_fds_select())
 			FCEU_FDSSelect();
-		if (mr->command_vs_insertcoin())
+		if (mr.command_vs_insertcoin())
 			FCEU_VSUniCoin();
 		_currCommand = 0;
 	} else
@@ -1229,22 +1919,22 @@ void FCEUMOV_AddInputState()
 			portFC.driver->Update(portFC.ptr,portFC.attrib);
 		} else
 		{
-			MovieRecord* mr = &currMovieData.records[currFrameCounter];
+			MovieRecord mr = currMovieData.records.get(currFrameCounter);
 
 			//reset and power cycle if necessary
-			if(mr->command_power())
+			if(mr.command_power())
 				PowerNES();
-			if(mr->command_reset())
+			if(mr.command_reset())
 				ResetNES();
-			if(mr->command_fds_insert())
+			if(mr.command_fds_insert())
 				FCEU_FDSInsert();
-			if(mr->command_fds_select())
+			if(mr.command_fds_select())
 				FCEU_FDSSelect();
-			if (mr->command_vs_insertcoin())
+			if (mr.command_vs_insertcoin())
 				FCEU_VSUniCoin();
 
-			joyports[0].load(mr);
-			joyports[1].load(mr);
+			joyports[0].load(&mr);
+			joyports[1].load(&mr);
 		}
 
 		//if we are on the last frame, then pause the emulator if the player requested it
@@ -1257,10 +1947,14 @@ void FCEUMOV_AddInputState()
 		}
 
 		//pause the movie at a specified frame
-		if (FCEUMOV_ShouldPause() && FCEUI_EmulationPaused()==0)
+		if (FCEUMOV_ShouldPause())
 		{
-			FCEUI_ToggleEmulationPause();
-			FCEU_DispMessage("Paused at specified movie frame",0);
+			StopSeekTurbo();
+			if (FCEUI_EmulationPaused()==0)
+			{
+				FCEUI_ToggleEmulationPause();
+				FCEU_DispMessage("Paused at specified movie frame",0);
+			}
 		}
 
 	} else if (movieMode == MOVIEMODE_RECORD)
@@ -1278,11 +1972,10 @@ void FCEUMOV_AddInputState()
 			switch (movieRecordMode)
 			{
 			case MOVIE_RECORD_MODE_OVERWRITE:
-				currMovieData.records[currFrameCounter].Clone(mr);
+				currMovieData.records.set(currFrameCounter, mr);
 				break;
 			case MOVIE_RECORD_MODE_INSERT:
-				//FIXME: this could be very insufficient
-				currMovieData.records.insert(currMovieData.records.begin() + currFrameCounter, mr);
+				currMovieData.records.insert(currFrameCounter, 1, mr);
 				break;
 			//case MOVIE_RECORD_MODE_TRUNCATE:
 			default:
@@ -1294,7 +1987,13 @@ void FCEUMOV_AddInputState()
 		else
 			currMovieData.records.push_back(mr);
 
-		mr.dump(&currMovieData, osRecordingMovie, currFrameCounter);	// to disk
+		// to disk
+		int frame = std::min(currFrameCounter, (int)currMovieData.records.size() - 1);
+		InvalidateSeekCache(frame);
+		if (movieRecordMode == MOVIE_RECORD_MODE_INSERT)
+			movieFile.pendingFrom = std::min(movieFile.pendingFrom, frame);	//rewritten when recording stops
+		else
+			WriteMovieFileFrames(frame, frame + 1);
 	}
 
 	currFrameCounter++;
@@ -1398,13 +2097,7 @@ int CheckTimelines(MovieData& stateMovie, MovieData& currMovie)
 	if (end_frame > currFrameCounter)
 		end_frame = currFrameCounter;
 
-	for (int x = 0; x < end_frame; x++)
-	{
-		if (!stateMovie.records[x].Compare(currMovie.records[x]))
-			return x;
-	}
-	// no mismatch found
-	return -1;
+	return stateMovie.records.firstDifference(currMovie.records, end_frame);
 }
 
 
@@ -1436,9 +2129,11 @@ bool FCEUMOV_ReadState(EMUFILE* is, uint32 size)
 		}
 	}
 
+	//only the header is read now; the records are decoded below as far as they're needed
 	MovieData tempMovieData = MovieData();
+	FM2Records tempRecords;
 	std::ios::pos_type curr = is->ftell();
-	if(!LoadFM2(tempMovieData, is, size, false)) {
+	if(!LoadFM2Lazy(tempMovieData, is, size, false, tempRecords)) {
 		is->fseek((uint32)curr+size,SEEK_SET);
 		extern bool FCEU_state_loading_old_format;
 		if(FCEU_state_loading_old_format) {
@@ -1537,11 +2232,12 @@ bool FCEUMOV_ReadState(EMUFILE* is, uint32 size)
 			if (movieMode == MOVIEMODE_RECORD)
 			{
 				movieMode = MOVIEMODE_PLAY;
-				RedumpWholeMovieFile(true);
+				UpdateMovieFile(currMovieData.records.size(), true);
 				closeRecordingMovie();
 			}
 
 			// currFrameCounter at this point represents the savestate framecount
+			tempRecords.decode(tempMovieData, currFrameCounter);
 			int frame_of_mismatch = CheckTimelines(tempMovieData, currMovieData);
 			if (frame_of_mismatch >= 0)
 			{
@@ -1553,19 +2249,19 @@ bool FCEUMOV_ReadState(EMUFILE* is, uint32 size)
 				} else
 					FCEU_PrintError("Error: Savestate not in the same timeline as movie!\nFrame %d branches from current timeline", frame_of_mismatch);
 				return false;
-			} else if ((int)tempMovieData.records.size() < currFrameCounter)
+			} else if (tempRecords.count() < currFrameCounter)
 			{
 				// this is post-movie savestate and must be checked further
-				if (tempMovieData.records.size() < currMovieData.records.size())
+				if (tempRecords.count() < currMovieData.records.size())
 				{
 					// this savestate doesn't contain enough input to be checked
 					//TODO: turn frame counter to red to get attention
 					if (!backupSavestates)	//If backups are disabled we can just resume normally since we can't restore so stop movie and inform user
 					{
-						FCEU_PrintError("Error: Savestate taken from a frame (%d) after the final frame in the savestated movie (%d) cannot be verified against current movie (%d). This is not permitted.\nUnable to restore backup, movie playback stopped.", currFrameCounter, tempMovieData.records.size() - 1, currMovieData.records.size() - 1);
+						FCEU_PrintError("Error: Savestate taken from a frame (%d) after the final frame in the savestated movie (%d) cannot be verified against current movie (%d). This is not permitted.\nUnable to restore backup, movie playback stopped.", currFrameCounter, tempRecords.count() - 1, currMovieData.records.size() - 1);
 						FCEUI_StopMovie();
 					} else
-						FCEU_PrintError("Savestate taken from a frame (%d) after the final frame in the savestated movie (%d) cannot be verified against current movie (%d). This is not permitted.", currFrameCounter, tempMovieData.records.size() - 1, currMovieData.records.size() - 1);
+						FCEU_PrintError("Savestate taken from a frame (%d) after the final frame in the savestated movie (%d) cannot be verified against current movie (%d). This is not permitted.", currFrameCounter, tempRecords.count() - 1, currMovieData.records.size() - 1);
 					return false;
 				}
 			}
@@ -1581,26 +2277,28 @@ bool FCEUMOV_ReadState(EMUFILE* is, uint32 size)
 			//Read+Write mode
 			closeRecordingMovie();
 
-			if (currFrameCounter > (int)tempMovieData.records.size())
+			if (currFrameCounter > tempRecords.count())
 			{
 				//This is a post movie savestate, handle it differently
 				//Replace movie contents but then switch to movie finished mode
+				tempRecords.decode(tempMovieData, tempRecords.count());
+				int changedFrom = MovieFileChangedFrom(tempMovieData);
 				currMovieData = tempMovieData;
 				movieMode = MOVIEMODE_PLAY;
 				FCEUMOV_IncrementRerecordCount();
-				RedumpWholeMovieFile();
+				UpdateMovieFile(changedFrom);
 				FinishPlayback();
 			} else
 			{
 				//truncate before we copy, just to save some time, unless the user selects a full copy option
-				if (!fullSaveStateLoads)
-					//we can only assume this here since we have checked that the frame counter is not greater than the movie data
-					tempMovieData.truncateAt(currFrameCounter);
+				//we can only assume this here since we have checked that the frame counter is not greater than the movie data
+				tempRecords.decode(tempMovieData, fullSaveStateLoads ? tempRecords.count() : currFrameCounter);
 				
+				int changedFrom = MovieFileChangedFrom(tempMovieData);
 				currMovieData = tempMovieData;
 				movieMode = MOVIEMODE_RECORD;
 				FCEUMOV_IncrementRerecordCount();
-				RedumpWholeMovieFile(true);
+				UpdateMovieFile(changedFrom, true);
 			}
 		}
 	}
@@ -1617,7 +2315,7 @@ void FCEUMOV_PreLoad(void)
 
 bool FCEUMOV_PostLoad(void)
 {
-	if(movieMode == MOVIEMODE_INACTIVE || movieMode == MOVIEMODE_TASEDITOR)
+	if(movieMode == MOVIEMODE_INACTIVE || movieMode == MOVIEMODE_TASEDITOR || seekCache.loading)
 		return true;
 	else
 		return load_successful;
@@ -1743,13 +2441,13 @@ void FCEUI_MovieToggleRecording()
 		movie_readonly = false;
 		FCEUMOV_IncrementRerecordCount();
 		movieMode = MOVIEMODE_RECORD;
-		RedumpWholeMovieFile(true);
+		UpdateMovieFile(currMovieData.records.size(), true);
 	} else if (movieMode == MOVIEMODE_RECORD)
 	{
 		strcpy(message, "Movie is now Read-Only");
 		movie_readonly = true;
 		movieMode = MOVIEMODE_PLAY;
-		RedumpWholeMovieFile(true);
+		UpdateMovieFile(currMovieData.records.size(), true);
 		if (currFrameCounter >= (int)currMovieData.records.size())
 		{
 			extern int closeFinishedMovie;
@@ -1782,10 +2480,9 @@ void FCEUI_MovieInsertFrame()
 	{
 		strcpy(message, "1 frame inserted");
 		strcat(message, GetMovieModeStr());
-		std::vector<MovieRecord>::iterator iter = currMovieData.records.begin();
-		currMovieData.records.insert(iter + currFrameCounter, MovieRecord());
+		currMovieData.records.insert(currFrameCounter, 1);
 		FCEUMOV_IncrementRerecordCount();
-		RedumpWholeMovieFile();
+		UpdateMovieFile(currFrameCounter);
 	} else
 	{
 		strcpy(message, "Nothing to do in this mode");
@@ -1808,10 +2505,9 @@ void FCEUI_MovieDeleteFrame()
 	else if (movieMode == MOVIEMODE_RECORD || movieMode == MOVIEMODE_PLAY)
 	{
 		strcpy(message, "1 frame deleted");
-		std::vector<MovieRecord>::iterator iter = currMovieData.records.begin();
-		currMovieData.records.erase(iter + currFrameCounter);
+		currMovieData.records.erase(currFrameCounter);
 		FCEUMOV_IncrementRerecordCount();
-		RedumpWholeMovieFile();
+		UpdateMovieFile(currFrameCounter);
 
 		if (movieMode != MOVIEMODE_RECORD && currFrameCounter >= (int)currMovieData.records.size())
 		{
@@ -1848,7 +2544,7 @@ void FCEUI_MovieTruncate()
 		strcpy(message, "Movie truncated");
 		currMovieData.truncateAt(currFrameCounter);
 		FCEUMOV_IncrementRerecordCount();
-		RedumpWholeMovieFile();
+		UpdateMovieFile(currFrameCounter);
 
 		if (movieMode != MOVIEMODE_RECORD)
 		{
@@ -1908,7 +2604,7 @@ void FCEUI_MoviePlayFromBeginning(void)
 		if (movieMode == MOVIEMODE_RECORD)
 		{
 			movieMode = MOVIEMODE_PLAY;
-			RedumpWholeMovieFile(true);
+			UpdateMovieFile(currMovieData.records.size(), true);
 		}
 		if (currMovieData.savestate.empty())
 		{
@@ -1938,6 +2634,71 @@ void FCEUI_MoviePlayFromBeginning(void)
 #endif
 }
 
+//Plays the movie read-only up to "frame" and pauses there, starting from the
+//nearest state in the seek cache and replaying the rest at turbo speed.
+bool FCEUI_MovieSeek(int frame)
+{
+	if (!FCEUMOV_Mode(MOVIEMODE_PLAY|MOVIEMODE_RECORD|MOVIEMODE_FINISHED))
+		return false;
+	if (frame < 0 || frame > (int)currMovieData.records.size())
+		return false;
+
+	if (movieMode == MOVIEMODE_RECORD)
+	{
+		movieMode = MOVIEMODE_PLAY;
+		UpdateMovieFile(currMovieData.records.size(), true);
+	}
+	movie_readonly = true;
+	StopSeekTurbo();
+	pauseframe = 0;
+
+	std::map<int, std::vector<uint8> >::iterator it = seekCache.states.upper_bound(frame);
+	bool cached = (it != seekCache.states.begin());
+	if (cached)
+		--it;
+	//unless we're already closer
+	if (currFrameCounter > frame || (cached && it->first > currFrameCounter))
+	{
+		if (cached)
+		{
+			if (!FCEUMOV_LoadStateInMovie(it->second))
+				return false;
+		} else if (currMovieData.savestate.empty())
+		{
+			poweron(true);
+			currFrameCounter = 0;
+		} else
+		{
+			// movie starting from savestate - reload movie file
+			string str = curMovieFilename;
+			FCEUI_StopMovie();
+			if (!FCEUI_LoadMovie(str.c_str(), 1, 0))
+				return false;
+			movie_readonly = true;
+		}
+	}
+
+	cur_input_display = 0; //clear previous input display
+	movieMode = (currFrameCounter < (int)currMovieData.records.size()) ? MOVIEMODE_PLAY : MOVIEMODE_FINISHED;
+	if (currFrameCounter == frame)
+	{
+		if (!FCEUI_EmulationPaused())
+			FCEUI_ToggleEmulationPause();
+	} else
+	{
+		pauseframe = frame;
+		FCEUD_TurboOn();
+		seekCache.turbo = true;
+		if (FCEUI_EmulationPaused())
+			FCEUI_ToggleEmulationPause();
+	}
+	FCEU_DispMessage("Seeking to frame %d.",0,frame);
+#ifdef __WIN_DRIVER__
+	SetMainWindowText();
+#endif
+	return true;
+}
+
 string FCEUI_GetMovieName(void)
 {
 	return curMovieFilename;
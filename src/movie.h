@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 #include <string>
 #include <ostream>
 #include <cstdlib>
@@ -103,12 +104,24 @@ bool FCEUMOV_ReadState(EMUFILE* is, uint32 size);
 void FCEUMOV_PreLoad();
 bool FCEUMOV_PostLoad();
 void FCEUMOV_IncrementRerecordCount();
+void FCEUMOV_UpdateSeekCache();
+//Savestates without the movie in them, for going back to a frame of the
+//movie that is playing.  Loading one doesn't check it against the movie.
+bool FCEUMOV_SaveStateInMovie(std::vector<uint8>& state);
+bool FCEUMOV_LoadStateInMovie(std::vector<uint8>& state);
 
 bool FCEUMOV_FromPoweron();
 
 void FCEUMOV_CreateCleanMovie();
 void FCEUMOV_ClearCommands();
 
+//One zapper's state for a frame.
+struct MovieZapper
+{
+	uint8 x,y,b,bogo;
+	uint64 zaphit;
+};
+
 class MovieData;
 class MovieRecord
 {
@@ -117,10 +130,7 @@ public:
 	MovieRecord();
 	ValueArray<uint8,4> joysticks;
 
-	struct {
-		uint8 x,y,b,bogo;
-		uint64 zaphit;
-	} zappers[2];
+	MovieZapper zappers[2];
 
 	//misc commands like reset, etc.
 	//small now to save space; we might need to support more commands later.
@@ -175,6 +185,61 @@ private:
 	int mask(int bit) { return 1<<bit; }
 };
 
+//The input of every frame of a movie.  Rather than an array of MovieRecord
+//it keeps columns: the four joystick bytes of each frame in one array, and
+//the commands and zapper states, which most frames don't have, in maps keyed
+//by frame.  Copies share their columns until one of them is changed, so the
+//MovieData copies made while loading states cost next to nothing.
+class MovieRecordList
+{
+public:
+	MovieRecordList();
+
+	int size() const { return (int)cols->joysticks.size() / 4; }
+	bool empty() const { return cols->joysticks.empty(); }
+	void clear();
+	void resize(int frames);
+	void reserve(int frames);
+
+	//whole records, copied in and out
+	MovieRecord get(int frame) const;
+	void set(int frame, const MovieRecord& mr);
+	void push_back(const MovieRecord& mr);
+	void insert(int at, int frames, const MovieRecord& mr = MovieRecord());
+	void erase(int at, int frames = 1);
+
+	uint8 joystick(int frame, int joy) const { return cols->joysticks[frame * 4 + joy]; }
+	void setJoystick(int frame, int joy, uint8 val);
+	uint8 commands(int frame) const;
+	void setCommands(int frame, uint8 val);
+
+	bool checkBit(int frame, int joy, int bit) const { return (joystick(frame, joy) & (1 << bit)) != 0; }
+	void setBitValue(int frame, int joy, int bit, bool val);
+	void setBit(int frame, int joy, int bit) { setBitValue(frame, joy, bit, true); }
+	void clearBit(int frame, int joy, int bit) { setBitValue(frame, joy, bit, false); }
+
+	//the first frame before end where the two lists differ, or -1
+	int firstDifference(const MovieRecordList& other, int end) const;
+
+private:
+	struct ZapperPair
+	{
+		MovieZapper port[2];
+		bool operator==(const ZapperPair& other) const;
+	};
+
+	struct Columns
+	{
+		std::vector<uint8> joysticks;
+		std::map<int,uint8> commands;
+		std::map<int,ZapperPair> zappers;
+	};
+
+	std::shared_ptr<Columns> cols;
+
+	Columns& edit();
+};
+
 class MovieData
 {
 public:
@@ -191,7 +256,7 @@ public:
 	std::string romFilename;
 	std::vector<uint8> savestate;
 	std::vector<uint8> saveram;
-	std::vector<MovieRecord> records;
+	MovieRecordList records;
 	std::vector<std::wstring> comments;
 	std::vector<std::string> subtitles;
 	//this is the RERECORD COUNT. please rename variable.
@@ -210,7 +275,7 @@ public:
 	//whether microphone is enabled
 	bool microphone;
 
-	int getNumRecords() { return (int)records.size(); }
+	int getNumRecords() { return records.size(); }
 
 	int RAMInitOption, RAMInitSeed;
 
@@ -245,6 +310,7 @@ public:
 	void truncateAt(int frame);
 	void installValue(std::string& key, std::string& val);
 	int dump(EMUFILE* os, bool binary, bool seekToCurrFramePos = false);
+	void dumpHeader(EMUFILE* os, bool binary);
 
 	void clearRecordRange(int start, int len);
 	void eraseRecords(int at, int frames = 1);
@@ -278,6 +344,7 @@ extern bool movie_readonly;
 extern bool autoMovieBackup;
 extern bool fullSaveStateLoads;
 extern int movieRecordMode;
+extern int movieSeekCacheMB;
 extern int input_display;
 
 //--------------------------------------------------
@@ -286,6 +353,7 @@ void FCEUI_CreateMovieFile(std::string fn);
 void FCEUI_SaveMovie(const char *fname, EMOVIE_FLAG flags, std::wstring author);
 bool FCEUI_LoadMovie(const char *fname, bool read_only, int _stopframe);
 void FCEUI_MoviePlayFromBeginning(void);
+bool FCEUI_MovieSeek(int frame);
 void FCEUI_StopMovie(void);
 bool FCEUI_MovieGetInfo(FCEUFILE* fp, MOVIE_INFO& info, bool skipFrameCount = false);
 //char* FCEUI_MovieGetCurrentName(int addSlotNumber);
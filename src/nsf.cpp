@@ -52,6 +52,7 @@ static const int FIXED_EXWRAM_SIZE = 32768+8192;
 
 static uint8 SongReload;
 static int32 CurrentSong;
+static uint8 LastJoy; //for spotting presses on the song selection buttons
 
 static DECLFW(NSF_write);
 static DECLFR(NSF_read);
@@ -326,6 +327,7 @@ static SFORMAT StateRegs[] = {
 void NSF_init(void)
 {
 	doreset=1;
+	LastJoy=0;
 
 	ResetCartMapping();
 	if(NSFHeader.SoundChip&4)
@@ -581,10 +583,9 @@ void DrawNSF(uint8 *XBuf)
 	DrawTextTrans(XBuf+82*256+4+(((31-strlen(snbuf))<<2)), 256, (uint8*)snbuf, kFgColor);
 
 	{
-		static uint8 last=0;
 		uint8 tmp;
 		tmp=FCEU_GetJoyJoy();
-		if((tmp&JOY_RIGHT) && !(last&JOY_RIGHT))
+		if((tmp&JOY_RIGHT) && !(LastJoy&JOY_RIGHT))
 		{
 			if(CurrentSong<NSFHeader.TotalSongs)
 			{
@@ -592,7 +593,7 @@ void DrawNSF(uint8 *XBuf)
 				SongReload=0xFF;
 			}
 		}
-		else if((tmp&JOY_LEFT) && !(last&JOY_LEFT))
+		else if((tmp&JOY_LEFT) && !(LastJoy&JOY_LEFT))
 		{
 			if(CurrentSong>1)
 			{
@@ -600,25 +601,25 @@ void DrawNSF(uint8 *XBuf)
 				SongReload=0xFF;
 			}
 		}
-		else if((tmp&JOY_UP) && !(last&JOY_UP))
+		else if((tmp&JOY_UP) && !(LastJoy&JOY_UP))
 		{
 			CurrentSong+=10;
 			if(CurrentSong>NSFHeader.TotalSongs) CurrentSong=NSFHeader.TotalSongs;
 			SongReload=0xFF;
 		}
-		else if((tmp&JOY_DOWN) && !(last&JOY_DOWN))
+		else if((tmp&JOY_DOWN) && !(LastJoy&JOY_DOWN))
 		{
 			CurrentSong-=10;
 			if(CurrentSong<1) CurrentSong=1;
 			SongReload=0xFF;
 		}
-		else if((tmp&JOY_START) && !(last&JOY_START))
+		else if((tmp&JOY_START) && !(LastJoy&JOY_START))
 			SongReload=0xFF;
-		else if((tmp&JOY_A) && !(last&JOY_A))
+		else if((tmp&JOY_A) && !(LastJoy&JOY_A))
 		{
 			special=(special+1)%3;
 		}
-		last=tmp;
+		LastJoy=tmp;
 	}
 }
 
@@ -643,6 +644,35 @@ int FCEUI_NSFChange(int amount)
 	return(CurrentSong);
 }
 
+int FCEUI_NSFSetSong(int song)
+{
+	CurrentSong=0;
+	return FCEUI_NSFChange(song);
+}
+
+//Plays a song of the loaded NSF for the given time as fast as possible,
+//with no video or sound output.  Wave and stem recordings running at the
+//time capture the song.  Returns false if no NSF is loaded.
+bool FCEUI_NSFRender(int song, double seconds)
+{
+	uint8 *gfx;
+	int32 *sound;
+	int32 ssize;
+	int32 frames;
+
+	if(!GameInfo || GameInfo->type!=GIT_NSF)
+		return false;
+
+	FCEUI_NSFSetSong(song);
+
+	frames=(int32)(seconds*FCEUI_GetDesiredFPS()/(1<<24));
+
+	while(frames-- > 0)
+		FCEUI_Emulate(&gfx,&sound,&ssize,0);
+
+	return true;
+}
+
 //Returns total songs
 int FCEUI_NSFGetInfo(uint8 *name, uint8 *artist, uint8 *copyright, int maxlen)
 {
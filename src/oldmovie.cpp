@@ -650,10 +650,10 @@ EFCM_CONVERTRESULT convert_fcm(MovieData& md, std::string fname)
 		if(i==0 && initreset)
 			joopcmd = MOVIECMD_RESET;
 		_addjoy();
-		md.records[i].commands = joopcmd;
+		md.records.setCommands(i, joopcmd);
 		for(int j=0;j<4;j++) {
 			joymask[j] |= joop[j];
-			md.records[i].joysticks[j] = joop[j];
+			md.records.setJoystick(i, j, joop[j]);
 		}
 	}
 
@@ -357,6 +357,7 @@ static int deempcnt[8];
 
 void (*GameHBIRQHook)(void), (*GameHBIRQHook2)(void);
 void (*PPU_hook)(uint32 A);
+void (*PPU_A12Hook)(int32 dots);
 
 uint8 vtoggle = 0;
 uint8 XOffset = 0;
@@ -871,6 +872,7 @@ static DECLFW(B2003) {
 
 static DECLFW(B2004) {
 	PPUGenLatch = V;
+	DEBUG( debugDirtyOAM = 1 )
 	if (newppu) {
 		//the attribute upper bits are not connected
 		//so AND them out on write, since reading them
@@ -956,11 +958,13 @@ static DECLFW(B2007) {
 	if (newppu) {
 		PPUGenLatch = V;
 		RefreshAddr = ppur.get_2007access() & 0x3FFF;
+		DEBUG( debugDirtyPPU[RefreshAddr >> 8] = 1 )
 		CALL_PPUWRITE(RefreshAddr, V);
 		ppur.increment2007(ppur.status.sl >= 0 && ppur.status.sl < 241 && PPUON, INC32 != 0);
 		RefreshAddr = ppur.get_2007access();
 	} else {
 		PPUGenLatch = V;
+		DEBUG( debugDirtyPPU[tmp >> 8] = 1 )
 		if (tmp < 0x2000) {
 			if (PPUCHRRAM & (1 << (tmp >> 10)))
 				VPage[tmp >> 10][tmp] = V;
@@ -1074,6 +1078,22 @@ static void CheckSpriteHit(int p) {
 	}
 }
 
+//What a read of $2002 at A would give, as long as reading it changes nothing
+//and nothing can change it before the CPU next stops: no vblank flag to clear
+//and no sprite 0 hit still to come on this line.  Otherwise -1.
+int FCEUPPU_PeekStatus(uint32 A) {
+	uint8 ret;
+
+	if (newppu || ARead[A] != A2002)
+		return -1;
+	if (Pline && sphitx != 0x100 && !(PPU_status & 0x40))
+		return -1;
+	ret = PPU_status | (PPUGenLatch & 0x1F);
+	if ((PPU_status & 0x80) || vtoggle || PPUGenLatch != ret)
+		return -1;
+	return ret;
+}
+
 //spork the world.  Any sprites on this line? Then this will be set to 1.
 //Needed for zapper emulation and *gasp* sprite emulation.
 static int spork = 0;
@@ -1298,6 +1318,40 @@ static void Fixit1(void) {
 	}
 }
 
+//Sprite slots whose pattern fetches at the end of the line read from $1000,
+//slot n in bit n.  Empty slots fetch tile $FF.
+static uint8 spra12;
+
+static uint8 SpriteA12(int ns) {
+	return (Sprite16 || SpAdrHI) ? (uint8)(0xFF << ns) : 0;
+}
+
+//The sprite and background fetches at the end of a line take A12 high for
+//each pattern from $1000, and it drops for every nametable fetch in between.
+//An MMC3 only counts a rise after 10 or so dots low.  at is when the first
+//sprite slot's rise happens, in dots past where the CPU has been run to.
+static int ReportA12Rises(uint8 slots, int at) {
+	int low = (PPU[0] & 0x10) ? 0 : 10;
+	int n, rises = 0;
+
+	for (n = 0; n < 8; n++) {
+		low += 4;
+		if (slots & (1 << n)) {
+			if (low >= 10) {
+				PPU_A12Hook(at + (n << 3));
+				rises++;
+			}
+			low = 0;
+		} else
+			low += 4;
+	}
+	if ((PPU[0] & 0x10) && low + 4 >= 10) {
+		PPU_A12Hook(at + 64);
+		rises++;
+	}
+	return rises;
+}
+
 void MMC5_hb(int);		//Ugh ugh ugh.
 static void DoLine(void) {
 	if (scanline >= 240 && scanline != totalscanlines) {
@@ -1307,7 +1361,7 @@ static void DoLine(void) {
 		return;
 	}
 
-	int x;
+	int x, a12;
 	uint8 *target = XBuf + ((scanline < 240 ? scanline : 240) << 8);
 	u8* dtarget = XDBuf + ((scanline < 240 ? scanline : 240) << 8);
 
@@ -1356,8 +1410,14 @@ static void DoLine(void) {
 
 	sphitx = 0x100;
 
-	if (ScreenON || SpriteON)
+	a12 = 0;
+	if (ScreenON || SpriteON) {
 		FetchSpriteData();
+		//Dot 266 is where the scanline hook has always clocked the counter.
+		if (PPU_A12Hook)
+			a12 = ReportA12Rises(spra12, 10);
+	} else
+		spra12 = SpriteA12(0);
 
 	if (GameHBIRQHook && (ScreenON || SpriteON) && ((PPU[0] & 0x38) != 0x18)) {
 		X6502_Run(6);
@@ -1373,6 +1433,8 @@ static void DoLine(void) {
 		// A semi-hack for Star Trek: 25th Anniversary
 		if (GameHBIRQHook && (ScreenON || SpriteON) && ((PPU[0] & 0x38) != 0x18))
 			GameHBIRQHook();
+		if (PPU_A12Hook && !a12 && (ScreenON || SpriteON))
+			ReportA12Rises(spra12, 10 - (85 - 16));
 	}
 
 	DEBUG(FCEUD_UpdateNTView(scanline, 0));
@@ -1406,7 +1468,7 @@ void FCEUI_DisableSpriteLimitation(int a) {
 
 static uint8 numsprites, SpriteBlurp;
 static void FetchSpriteData(void) {
-	uint8 ns, sb;
+	uint8 ns, sb, a12 = 0;
 	SPR *spr;
 	uint8 H;
 	int n;
@@ -1439,6 +1501,8 @@ static void FetchSpriteData(void) {
 						vadr = ((spr->no & 1) << 12) + ((spr->no & 0xFE) << 4);
 					else
 						vadr = (spr->no << 4) + vofs;
+					if (ns < 8 && (vadr & 0x1000))
+						a12 |= 1 << ns;
 
 					if (spr->atr & V_FLIP) {
 						vadr += 7;
@@ -1493,6 +1557,8 @@ static void FetchSpriteData(void) {
 						vadr = ((spr->no & 1) << 12) + ((spr->no & 0xFE) << 4);
 					else
 						vadr = (spr->no << 4) + vofs;
+					if (ns < 8 && (vadr & 0x1000))
+						a12 |= 1 << ns;
 
 					if (spr->atr & V_FLIP) {
 						vadr += 7;
@@ -1542,6 +1608,7 @@ static void FetchSpriteData(void) {
 	}
 	numsprites = ns;
 	SpriteBlurp = sb;
+	spra12 = a12 | SpriteA12(ns < 8 ? ns : 8);
 }
 
 static void RefreshSprites(void) {
@@ -1794,6 +1861,8 @@ int FCEUPPU_Loop(int skip) {
 			if (ScreenON || SpriteON) {
 				if (GameHBIRQHook && ((PPU[0] & 0x38) != 0x18))
 					GameHBIRQHook();
+				if (PPU_A12Hook)
+					ReportA12Rises(SpriteA12(0), 0);
 				if (PPU_hook)
 					for (x = 0; x < 42; x++) {
 						PPU_hook(0x2000); PPU_hook(0);
@@ -1824,11 +1893,13 @@ int FCEUPPU_Loop(int skip) {
 			y++;
 
 			PPU_status |= 0x20;	// Fixes "Bee 52".  Does it break anything?
-			if (GameHBIRQHook) {
+			if (GameHBIRQHook || PPU_A12Hook) {
 				X6502_Run(256);
 				for (scanline = 0; scanline < 240; scanline++) {
-					if (ScreenON || SpriteON)
+					if (GameHBIRQHook && (ScreenON || SpriteON))
 						GameHBIRQHook();
+					if (PPU_A12Hook && (ScreenON || SpriteON))
+						ReportA12Rises(SpriteA12(0), 0);
 					if (scanline == y && SpriteON) PPU_status |= 0x40;
 					X6502_Run((scanline == 239) ? 85 : (256 + 85));
 				}
@@ -2393,6 +2464,15 @@ int FCEUX_PPU_Loop(int skip) {
 					}
 				}
 
+				//A12 rises are timed from the same point, for the same games
+				if (s == 2 && PPUON && PPU_A12Hook) {
+					uint8 slots = SpriteA12(oamcount < 8 ? oamcount : 8);
+					for (int i = 0; i < oamcount && i < 8; i++)
+						if (Sprite16 ? (oams[scanslot][i][1] & 1) : SpAdrHI)
+							slots |= 1 << i;
+					ReportA12Rises(slots, 0);
+				}
+
 				//blind attempt to replicate old ppu functionality
 				if(s == 2 && PPUON)
 				{
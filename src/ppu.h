@@ -4,10 +4,14 @@ void FCEUPPU_Power(void);
 int FCEUPPU_Loop(int skip);
 
 void FCEUPPU_LineUpdate();
+int FCEUPPU_PeekStatus(uint32 A);
 void FCEUPPU_SetVideoSystem(int w);
 
 extern void (*PPU_hook)(uint32 A);
 extern void (*GameHBIRQHook)(void), (*GameHBIRQHook2)(void);
+//Called for each rise of PPU A12 after it has been low long enough for an
+//MMC3 to count it, dots past the point the CPU has been run to.
+extern void (*PPU_A12Hook)(int32 dots);
 
 int newppu_get_scanline();
 int newppu_get_dot();
@@ -0,0 +1,252 @@
+/* FCE Ultra - NES/Famicom Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/// \file
+/// \brief On-disk cache of ROM image hashes
+
+#include "types.h"
+#include "driver.h"
+#include "file.h"
+#include "romcache.h"
+#include "utils/crc32.h"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef WIN32
+#include <windows.h>
+#include <io.h>
+#include <process.h>
+#include "utils/xstring.h"
+#else
+#include <unistd.h>
+#endif
+
+//One line per file:
+//  <size> <mtime> <head> <crc32> <md5> <path>
+//mtime is in the finest units the platform's file times have, and head is
+//the CRC32 of the header and first PRG bank, which catches a file rewritten
+//to the same size within the time stamp's resolution.  Later lines replace
+//earlier ones for the same path, so new entries can simply be appended.
+//Bump the version when what gets hashed changes.
+static const char *cacheMagic = "FCEUX ROM cache 2";
+
+struct ROMCACHEENTRY {
+	uint64 size;
+	int64 mtime;
+	uint32 head;
+	uint32 crc32;
+	uint8 md5[16];
+};
+
+static std::map<std::string, ROMCACHEENTRY> cache;
+static bool cacheLoaded = false;
+
+static bool GetFileKey(FCEUFILE *fp, ROMCACHEENTRY *e)
+{
+	//Memory streams are archives, gzipped or IPS patched files, which the
+	//path and time stamp don't identify.
+	EMUFILE_FILE *ef = dynamic_cast<EMUFILE_FILE*>(fp->stream);
+	uint8 head[16 + 16384];
+	size_t len;
+	int pos;
+
+	if(!ef || !ef->get_fp() || fp->fullFilename.empty())
+		return false;
+
+#ifdef WIN32
+	BY_HANDLE_FILE_INFORMATION info;
+	HANDLE fh = (HANDLE)_get_osfhandle(_fileno(ef->get_fp()));
+
+	if(fh == INVALID_HANDLE_VALUE || !GetFileInformationByHandle(fh, &info))
+		return false;
+	e->size = ((uint64)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+	e->mtime = (int64)(((uint64)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime);
+#else
+	struct stat st;
+
+	if(fstat(fileno(ef->get_fp()), &st))
+		return false;
+	e->size = st.st_size;
+#ifdef __APPLE__
+	e->mtime = (int64)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+	e->mtime = (int64)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+#endif
+
+	//Not past the end, which would set the stream's fail bit.
+	len = (e->size < sizeof(head)) ? (size_t)e->size : sizeof(head);
+	pos = ef->ftell();
+	ef->fseek(0, SEEK_SET);
+	len = ef->fread(head, len);
+	ef->fseek(pos, SEEK_SET);
+	e->head = CalcCRC32(0, head, len);
+	return true;
+}
+
+static void WriteEntry(FILE *f, const std::string &path, const ROMCACHEENTRY &e)
+{
+	int x;
+
+	fprintf(f, "%llu %lld %08x %08x ", (unsigned long long)e.size, (long long)e.mtime, e.head, e.crc32);
+	for(x = 0; x < 16; x++)
+		fprintf(f, "%02x", e.md5[x]);
+	fprintf(f, " %s\n", path.c_str());
+}
+
+static void SaveCache(void)
+{
+	std::string fn = FCEU_MakeFName(FCEUMKF_ROMCACHE, 0, 0);
+	std::map<std::string, ROMCACHEENTRY>::iterator it;
+	char tmp[2048];
+	FILE *f;
+
+	//Write the whole thing aside under a name of this process's own and move
+	//it over the old one in a single step, so other running copies never see
+	//it half written or missing, nor write into the same temporary file.
+#ifdef WIN32
+	snprintf(tmp, sizeof(tmp), "%s.%d.tmp", fn.c_str(), (int)_getpid());
+#else
+	snprintf(tmp, sizeof(tmp), "%s.%d.tmp", fn.c_str(), (int)getpid());
+#endif
+	if(!(f = FCEUD_UTF8fopen(tmp, "wb")))
+		return;
+	fprintf(f, "%s\n", cacheMagic);
+	for(it = cache.begin(); it != cache.end(); it++)
+		WriteEntry(f, it->first, it->second);
+	if(fclose(f))
+	{
+		remove(tmp);
+		return;
+	}
+
+#ifdef WIN32
+	if(!MoveFileExW(mbstowcs((std::string)tmp).c_str(), mbstowcs(fn).c_str(), MOVEFILE_REPLACE_EXISTING))
+#else
+	if(rename(tmp, fn.c_str()))
+#endif
+		remove(tmp);
+}
+
+static void LoadCache(void)
+{
+	std::string fn = FCEU_MakeFName(FCEUMKF_ROMCACHE, 0, 0);
+	char line[4096];
+	int lines = 0;
+	FILE *f;
+
+	cacheLoaded = true;
+
+	if(!(f = FCEUD_UTF8fopen(fn, "rb")))
+		return;
+
+	if(!fgets(line, sizeof(line), f) || strncmp(line, cacheMagic, strlen(cacheMagic)))
+	{
+		//From another version, start over.
+		fclose(f);
+		SaveCache();
+		return;
+	}
+
+	while(fgets(line, sizeof(line), f))
+	{
+		unsigned long long size;
+		long long mtime;
+		unsigned int head, crc, b;
+		char md5[33];
+		ROMCACHEENTRY e;
+		int n = 0, x;
+		char *path;
+
+		if(sscanf(line, "%llu %lld %x %x %32s %n", &size, &mtime, &head, &crc, md5, &n) < 5 || !n || strlen(md5) != 32)
+			continue;
+
+		path = line + n;
+		path[strcspn(path, "\r\n")] = 0;
+		if(!*path)
+			continue;
+
+		e.size = size;
+		e.mtime = mtime;
+		e.head = head;
+		e.crc32 = crc;
+		for(x = 0; x < 16; x++)
+		{
+			sscanf(md5 + x * 2, "%2x", &b);
+			e.md5[x] = b;
+		}
+		cache[path] = e;
+		lines++;
+	}
+	fclose(f);
+
+	//Drop entries that were replaced by later ones.
+	if(lines > (int)cache.size() * 2 + 64)
+		SaveCache();
+}
+
+bool FCEU_RomCacheLookup(FCEUFILE *fp, uint8 md5[16], uint32 *crc32)
+{
+	std::map<std::string, ROMCACHEENTRY>::iterator it;
+	ROMCACHEENTRY key;
+
+	if(!GetFileKey(fp, &key))
+		return false;
+
+	if(!cacheLoaded)
+		LoadCache();
+
+	it = cache.find(fp->fullFilename);
+	if(it == cache.end() || it->second.size != key.size || it->second.mtime != key.mtime || it->second.head != key.head)
+		return false;
+
+	memcpy(md5, it->second.md5, 16);
+	*crc32 = it->second.crc32;
+	return true;
+}
+
+void FCEU_RomCacheStore(FCEUFILE *fp, const uint8 md5[16], uint32 crc32)
+{
+	std::string fn;
+	ROMCACHEENTRY e;
+	FILE *f;
+
+	if(!GetFileKey(fp, &e))
+		return;
+
+	if(!cacheLoaded)
+		LoadCache();
+
+	memcpy(e.md5, md5, 16);
+	e.crc32 = crc32;
+	cache[fp->fullFilename] = e;
+
+	fn = FCEU_MakeFName(FCEUMKF_ROMCACHE, 0, 0);
+	if(!(f = FCEUD_UTF8fopen(fn, "ab")))
+		return;
+	//A new file needs its header first.
+	fseek(f, 0, SEEK_END);
+	if(!ftell(f))
+		fprintf(f, "%s\n", cacheMagic);
+	WriteEntry(f, fp->fullFilename, e);
+	fclose(f);
+}
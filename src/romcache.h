@@ -0,0 +1,16 @@
+#ifndef _ROMCACHE_H_
+#define _ROMCACHE_H_
+
+#include "types.h"
+#include "file.h"
+
+//Hashes of ROM images, kept on disk in the base directory and keyed by the
+//file's path, size, modification time and a hash of its first bytes, so
+//that loading a ROM again doesn't have to hash all of it.  Only plain,
+//unpatched files are cached.
+
+//Returns true and fills in md5/crc32 if fp is in the cache.
+bool FCEU_RomCacheLookup(FCEUFILE *fp, uint8 md5[16], uint32 *crc32);
+void FCEU_RomCacheStore(FCEUFILE *fp, const uint8 md5[16], uint32 crc32);
+
+#endif
@@ -0,0 +1,513 @@
+/* FCE Ultra - NES/Famicom Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/// \file
+/// \brief ROM library scanner and index
+
+#include "types.h"
+#include "driver.h"
+#include "file.h"
+#include "utils/md5.h"
+#include "utils/crc32.h"
+#ifdef _SYSTEM_MINIZIP
+#ifdef __linux
+#include <minizip/unzip.h>
+#else // Apple Most Likely
+#include <unzip.h>
+#endif
+#else
+#include "utils/unzip.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <map>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+bool iNESIdentify(const char *name, const uint8 *data, uint32 size, ROMLIBENTRY *e);
+bool UNIFIdentify(const uint8 *data, uint32 size, ROMLIBENTRY *e);
+
+//One line per game, tab separated, path last:
+//  size time crc32 md5 format mapper submapper region prg chr battery board path
+//Bump the version when the fields or what gets hashed change.
+static const char *libMagic = "FCEUX ROM library 1";
+
+//Larger files aren't games, don't read them in.
+#define LIB_MAX_ROM_SIZE (16 << 20)
+
+struct LIBFILE {
+	std::string path;
+	uint64 size;
+	int64 time;
+};
+
+static std::vector<ROMLIBENTRY> library;
+static bool libraryLoaded = false;
+
+static bool HasExtension(const std::string &name, const char *ext)
+{
+	size_t len = strlen(ext);
+
+	return name.size() >= len && !strcasecmp(name.c_str() + name.size() - len, ext);
+}
+
+//Same list TryUnzip picks archive members by.
+static bool IsRomName(const std::string &name)
+{
+	return HasExtension(name, ".nes") || HasExtension(name, ".fds") || HasExtension(name, ".nsf")
+		|| HasExtension(name, ".unf") || HasExtension(name, ".nez") || HasExtension(name, ".unif");
+}
+
+static void HashData(const uint8 *data, uint32 size, ROMLIBENTRY *e)
+{
+	struct md5_context md5;
+
+	md5_starts(&md5);
+	md5_update(&md5, (uint8 *)data, size);
+	md5_finish(&md5, e->md5);
+	e->crc32 = CalcCRC32(0, (uint8 *)data, size);
+}
+
+//Hashed as FDSLoad does: whole 65500 byte sides, zero filled if short.
+static bool IdentifyFDS(const uint8 *data, uint32 size, ROMLIBENTRY *e)
+{
+	struct md5_context md5;
+	uint8 zero[4096];
+	uint32 pos = 0, sides, x;
+
+	if (size >= 16 && !memcmp(data, "FDS\x1a", 4)) {
+		sides = data[4];
+		pos = 16;
+	} else if (size >= 15 && !memcmp(data + 1, "*NINTENDO-HVC*", 14)) {
+		sides = ((size < 65500) ? 65500 : size) / 65500;
+	} else
+		return false;
+
+	if (sides > 8) sides = 8;
+	if (sides < 1) sides = 1;
+
+	memset(zero, 0, sizeof(zero));
+	md5_starts(&md5);
+	e->crc32 = 0;
+	for (x = 0; x < sides * 65500; ) {
+		uint32 n = (pos < size) ? size - pos : 0;
+
+		if (n > sides * 65500 - x)
+			n = sides * 65500 - x;
+		if (n) {
+			md5_update(&md5, (uint8 *)data + pos, n);
+			e->crc32 = CalcCRC32(e->crc32, (uint8 *)data + pos, n);
+		} else {
+			n = sides * 65500 - x;
+			if (n > sizeof(zero))
+				n = sizeof(zero);
+			md5_update(&md5, zero, n);
+			e->crc32 = CalcCRC32(e->crc32, zero, n);
+		}
+		pos += n;
+		x += n;
+	}
+	md5_finish(&md5, e->md5);
+
+	e->format = "FDS";
+	e->mapper = -1;
+	e->submapper = 0;
+	e->board = "FDS";
+	e->region = 0;
+	e->prgSize = sides * 65500;
+	e->chrSize = 0;
+	e->battery = false;
+	return true;
+}
+
+static bool IdentifyNSF(const uint8 *data, uint32 size, ROMLIBENTRY *e)
+{
+	static const char *chips[6] = { "VRC6", "VRC7", "FDS", "MMC5", "N163", "Sunsoft 5B" };
+	int x;
+
+	if (size < 0x80 || memcmp(data, "NESM\x1a", 5))
+		return false;
+
+	HashData(data + 0x80, size - 0x80, e);
+
+	e->format = "NSF";
+	e->mapper = -1;
+	e->submapper = 0;
+	e->board = "";
+	for (x = 0; x < 6; x++) {
+		if (data[0x7B] & (1 << x)) {
+			if (!e->board.empty())
+				e->board += " ";
+			e->board += chips[x];
+		}
+	}
+	e->region = (data[0x7A] & 2) ? 2 : (data[0x7A] & 1);
+	e->prgSize = size - 0x80;
+	e->chrSize = 0;
+	e->battery = false;
+	return true;
+}
+
+static bool Identify(const std::string &name, const uint8 *data, uint32 size, ROMLIBENTRY *e)
+{
+	return iNESIdentify(name.c_str(), data, size, e) || UNIFIdentify(data, size, e)
+		|| IdentifyFDS(data, size, e) || IdentifyNSF(data, size, e);
+}
+
+//Members are read from the archive one at a time, straight into memory.
+static void ScanZip(const LIBFILE &f, std::vector<ROMLIBENTRY> &out)
+{
+	unzFile zf;
+	unz_file_info fi;
+	char name[512];
+	std::vector<uint8> data;
+
+	if (!(zf = unzOpen(f.path.c_str())))
+		return;
+
+	for (int ret = unzGoToFirstFile(zf); ret == UNZ_OK; ret = unzGoToNextFile(zf)) {
+		ROMLIBENTRY e;
+
+		if (unzGetCurrentFileInfo(zf, &fi, name, sizeof(name), 0, 0, 0, 0) != UNZ_OK)
+			break;
+		name[sizeof(name) - 1] = 0;
+		if (!IsRomName(name) || fi.uncompressed_size > LIB_MAX_ROM_SIZE)
+			continue;
+
+		data.resize(fi.uncompressed_size);
+		if (unzOpenCurrentFile(zf) != UNZ_OK)
+			continue;
+		int n = data.empty() ? 0 : unzReadCurrentFile(zf, &data[0], (unsigned)data.size());
+		unzCloseCurrentFile(zf);
+		if (n != (int)data.size())
+			continue;
+
+		e.path = f.path + "|" + name;
+		if (Identify(name, data.empty() ? NULL : &data[0], (uint32)data.size(), &e)) {
+			e.fileSize = f.size;
+			e.fileTime = f.time;
+			out.push_back(e);
+		}
+	}
+	unzClose(zf);
+}
+
+static void ScanFile(const LIBFILE &f, std::vector<ROMLIBENTRY> &out)
+{
+	std::vector<uint8> data;
+	ROMLIBENTRY e;
+	FILE *fp;
+
+	if (HasExtension(f.path, ".zip")) {
+		ScanZip(f, out);
+		return;
+	}
+	if (f.size > LIB_MAX_ROM_SIZE || !(fp = FCEUD_UTF8fopen(f.path, "rb")))
+		return;
+
+	data.resize((size_t)f.size);
+	size_t n = data.empty() ? 0 : fread(&data[0], 1, data.size(), fp);
+	fclose(fp);
+	if (n != data.size())
+		return;
+
+	e.path = f.path;
+	if (Identify(f.path, data.empty() ? NULL : &data[0], (uint32)data.size(), &e)) {
+		e.fileSize = f.size;
+		e.fileTime = f.time;
+		out.push_back(e);
+	}
+}
+
+static void ListFiles(const std::string &dir, std::vector<LIBFILE> &files)
+{
+	std::vector<std::string> subdirs;
+
+#ifdef WIN32
+	WIN32_FIND_DATAA fd;
+	HANDLE h = FindFirstFileA((dir + "\\*").c_str(), &fd);
+
+	if (h == INVALID_HANDLE_VALUE)
+		return;
+	do {
+		std::string path = dir + "\\" + fd.cFileName;
+
+		if (!strcmp(fd.cFileName, ".") || !strcmp(fd.cFileName, ".."))
+			continue;
+		if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+			subdirs.push_back(path);
+		} else if (IsRomName(path) || HasExtension(path, ".zip")) {
+			LIBFILE f;
+			ULARGE_INTEGER t;
+
+			t.LowPart = fd.ftLastWriteTime.dwLowDateTime;
+			t.HighPart = fd.ftLastWriteTime.dwHighDateTime;
+			f.path = path;
+			f.size = ((uint64)fd.nFileSizeHigh << 32) | fd.nFileSizeLow;
+			f.time = (int64)t.QuadPart;
+			files.push_back(f);
+		}
+	} while (FindNextFileA(h, &fd));
+	FindClose(h);
+#else
+	DIR *d;
+	struct dirent *de;
+	struct stat st;
+
+	if (!(d = opendir(dir.c_str())))
+		return;
+	while ((de = readdir(d)) != NULL) {
+		std::string path = dir + "/" + de->d_name;
+
+		if (!strcmp(de->d_name, ".") || !strcmp(de->d_name, ".."))
+			continue;
+		if (stat(path.c_str(), &st))
+			continue;
+		if (S_ISDIR(st.st_mode)) {
+			subdirs.push_back(path);
+		} else if (S_ISREG(st.st_mode) && (IsRomName(path) || HasExtension(path, ".zip"))) {
+			LIBFILE f;
+
+			f.path = path;
+			f.size = st.st_size;
+			f.time = st.st_mtime;
+			files.push_back(f);
+		}
+	}
+	closedir(d);
+#endif
+
+	for (size_t i = 0; i < subdirs.size(); i++)
+		ListFiles(subdirs[i], files);
+}
+
+static std::string ContainerOf(const std::string &path)
+{
+	return path.substr(0, path.find('|'));
+}
+
+static bool SaveLibraryIndex(void)
+{
+	std::string fn = FCEU_MakeFName(FCEUMKF_ROMLIB, 0, 0);
+	std::string tmp = fn + ".tmp";
+	FILE *f;
+
+	if (!(f = FCEUD_UTF8fopen(tmp, "wb")))
+		return false;
+
+	fprintf(f, "%s\n", libMagic);
+	for (size_t i = 0; i < library.size(); i++) {
+		const ROMLIBENTRY &e = library[i];
+		int x;
+
+		fprintf(f, "%llu\t%lld\t%08x\t", (unsigned long long)e.fileSize, (long long)e.fileTime, e.crc32);
+		for (x = 0; x < 16; x++)
+			fprintf(f, "%02x", e.md5[x]);
+		fprintf(f, "\t%s\t%d\t%d\t%d\t%u\t%u\t%d\t%s\t%s\n", e.format.c_str(), e.mapper, e.submapper,
+			e.region, e.prgSize, e.chrSize, e.battery ? 1 : 0, e.board.c_str(), e.path.c_str());
+	}
+	if (fclose(f))
+		return false;
+
+	remove(fn.c_str());
+	return !rename(tmp.c_str(), fn.c_str());
+}
+
+static void LoadLibraryIndex(void)
+{
+	std::string fn = FCEU_MakeFName(FCEUMKF_ROMLIB, 0, 0);
+	std::string line;
+	char buf[4096];
+	FILE *f;
+
+	libraryLoaded = true;
+	library.clear();
+
+	if (!(f = FCEUD_UTF8fopen(fn, "rb")))
+		return;
+
+	if (!fgets(buf, sizeof(buf), f) || strncmp(buf, libMagic, strlen(libMagic))) {
+		fclose(f);
+		return;
+	}
+
+	while (fgets(buf, sizeof(buf), f)) {
+		std::vector<std::string> fields;
+		char *p = buf, *tab;
+		ROMLIBENTRY e;
+
+		p[strcspn(p, "\r\n")] = 0;
+		while ((tab = strchr(p, '\t')) != NULL) {
+			fields.push_back(std::string(p, tab - p));
+			p = tab + 1;
+		}
+		fields.push_back(p);
+		if (fields.size() != 13 || fields[3].size() != 32)
+			continue;
+
+		e.fileSize = strtoull(fields[0].c_str(), NULL, 10);
+		e.fileTime = strtoll(fields[1].c_str(), NULL, 10);
+		e.crc32 = strtoul(fields[2].c_str(), NULL, 16);
+		for (int x = 0; x < 16; x++)
+			e.md5[x] = (uint8)strtoul(fields[3].substr(x * 2, 2).c_str(), NULL, 16);
+		e.format = fields[4];
+		e.mapper = atoi(fields[5].c_str());
+		e.submapper = atoi(fields[6].c_str());
+		e.region = atoi(fields[7].c_str());
+		e.prgSize = strtoul(fields[8].c_str(), NULL, 10);
+		e.chrSize = strtoul(fields[9].c_str(), NULL, 10);
+		e.battery = atoi(fields[10].c_str()) != 0;
+		e.board = fields[11];
+		e.path = fields[12];
+		library.push_back(e);
+	}
+	fclose(f);
+}
+
+static bool SortByPath(const ROMLIBENTRY &a, const ROMLIBENTRY &b)
+{
+	return a.path < b.path;
+}
+
+int FCEUI_ScanRomLibrary(const char *dir, int threads, void (*progress)(int done, int total))
+{
+	std::map<std::string, std::vector<const ROMLIBENTRY *> > known;
+	std::vector<LIBFILE> files;
+	std::vector<std::vector<ROMLIBENTRY> > found;
+	std::vector<std::thread> pool;
+	std::atomic<int> next(0), done(0);
+	std::string root = dir;
+
+	while (root.size() > 1 && (root[root.size() - 1] == '/' || root[root.size() - 1] == '\\'))
+		root.erase(root.size() - 1);
+
+	//What was found in each file last time, to skip files that haven't changed.
+	const std::vector<ROMLIBENTRY> &old = FCEUI_GetRomLibrary();
+	for (size_t i = 0; i < old.size(); i++)
+		known[ContainerOf(old[i].path)].push_back(&old[i]);
+
+	ListFiles(root, files);
+	found.resize(files.size());
+
+	if (threads <= 0)
+		threads = std::thread::hardware_concurrency();
+	if (threads <= 0)
+		threads = 1;
+	if (threads > (int)files.size())
+		threads = files.size() ? (int)files.size() : 1;
+
+	auto worker = [&]() {
+		int i;
+
+		while ((i = next++) < (int)files.size()) {
+			const LIBFILE &f = files[i];
+			std::map<std::string, std::vector<const ROMLIBENTRY *> >::const_iterator it = known.find(f.path);
+
+			if (it != known.end() && it->second[0]->fileSize == f.size && it->second[0]->fileTime == f.time) {
+				for (size_t j = 0; j < it->second.size(); j++)
+					found[i].push_back(*it->second[j]);
+			} else {
+				ScanFile(f, found[i]);
+			}
+			done++;
+		}
+	};
+
+	for (int t = 0; t < threads; t++)
+		pool.push_back(std::thread(worker));
+
+	while (done < (int)files.size()) {
+		if (progress)
+			progress(done, (int)files.size());
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+	for (size_t t = 0; t < pool.size(); t++)
+		pool[t].join();
+	if (progress)
+		progress((int)files.size(), (int)files.size());
+
+	//Games elsewhere stay in the index, everything under dir is replaced.
+	std::vector<ROMLIBENTRY> merged;
+	for (size_t i = 0; i < old.size(); i++) {
+		const std::string &path = old[i].path;
+
+		if (path.compare(0, root.size(), root) || (path.size() > root.size() && path[root.size()] != '/' && path[root.size()] != '\\'))
+			merged.push_back(old[i]);
+	}
+	int count = 0;
+	for (size_t i = 0; i < found.size(); i++) {
+		merged.insert(merged.end(), found[i].begin(), found[i].end());
+		count += (int)found[i].size();
+	}
+	std::sort(merged.begin(), merged.end(), SortByPath);
+	library.swap(merged);
+
+	return SaveLibraryIndex() ? count : -1;
+}
+
+const std::vector<ROMLIBENTRY> &FCEUI_GetRomLibrary(void)
+{
+	if (!libraryLoaded)
+		LoadLibraryIndex();
+	return library;
+}
+
+int FCEUI_FindInRomLibrary(const char *text, std::vector<const ROMLIBENTRY *> &matches)
+{
+	const std::vector<ROMLIBENTRY> &lib = FCEUI_GetRomLibrary();
+	std::string needle = text;
+	char hash[33];
+
+	std::transform(needle.begin(), needle.end(), needle.begin(), ::tolower);
+
+	for (size_t i = 0; i < lib.size(); i++) {
+		const ROMLIBENTRY &e = lib[i];
+		std::string path = e.path;
+		bool match;
+
+		std::transform(path.begin(), path.end(), path.begin(), ::tolower);
+		match = path.find(needle) != std::string::npos;
+
+		if (!match && needle.size() == 8) {
+			sprintf(hash, "%08x", e.crc32);
+			match = needle == hash;
+		}
+		if (!match && needle.size() == 32) {
+			for (int x = 0; x < 16; x++)
+				sprintf(hash + x * 2, "%02x", e.md5[x]);
+			match = needle == hash;
+		}
+		if (match)
+			matches.push_back(&e);
+	}
+	return (int)matches.size();
+}
@@ -0,0 +1,234 @@
+/* FCE Ultra - NES/Famicom Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/// \file
+/// \brief Expansion sound chip profiling and isolated recording
+
+#include "types.h"
+#include "fceu.h"
+#include "driver.h"
+#include "sound.h"
+#include "filter.h"
+#include "wave.h"
+#include "sndprof.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+typedef std::chrono::steady_clock profclock;
+
+bool FCEU_ExpSoundProfActive = false;
+
+static bool profEnabled = false;
+static bool captureEnabled = false;
+static WAVEFILE *expWave = NULL;
+
+static EXPSOUNDSTATS stats;
+
+//Mix buffer contents before the chip callback ran.
+static int32 snap[2048+512];
+
+//The chip's own contribution for the current frame.  hiCap is at the CPU
+//rate (HiFill), outCap at the output rate (Fill, NeoFill).  outCap may
+//hold one sample past the end of the frame in low quality mode.
+static int32 hiCap[40000];
+static int32 hiLen = 0;
+static int32 outCap[2048+512];
+static int32 outLen = 0;
+
+static int32 mixed[2048+512];
+
+static profclock::time_point startTime;
+static double frameTime = 0;
+
+static void UpdateActive(void)
+{
+	FCEU_ExpSoundProfActive = profEnabled || captureEnabled || (expWave != NULL);
+}
+
+void FCEU_ExpSoundProfCapture(bool enable)
+{
+	captureEnabled = enable;
+	UpdateActive();
+}
+
+const int32 *FCEU_ExpSoundProfOutput(void)
+{
+	return outCap;
+}
+
+void FCEU_ExpSoundProfBegin(const int32 *buf, int32 count)
+{
+	if(buf)
+		memcpy(snap, buf, count * sizeof(int32));
+	startTime = profclock::now();
+}
+
+void FCEU_ExpSoundProfEnd(const int32 *buf, int32 count)
+{
+	int32 x;
+
+	frameTime += std::chrono::duration<double, std::micro>(profclock::now() - startTime).count();
+
+	if(!buf)
+		return;
+
+	for(x = 0; x < count; x++)
+		outCap[x] += buf[x] - snap[x];
+	if(count > outLen)
+		outLen = count;
+}
+
+void FCEU_ExpSoundProfHi(const int32 *buf, int32 count)
+{
+	int32 x;
+
+	for(x = 0; x < count; x++)
+		hiCap[x] = buf[x] & 65535;
+	hiLen = count;
+}
+
+void FCEU_ExpSoundProfFrame(int32 count)
+{
+	double ghi, gout, v;
+	int32 x, peak = 0, samples;
+
+	if(!GameExpSound.Name)
+	{
+		outLen = hiLen = 0;
+		memset(outCap, 0, sizeof(outCap));
+		frameTime = 0;
+		return;
+	}
+
+	if(stats.name != GameExpSound.Name)
+		FCEUI_ResetExpSoundStats();
+
+	ghi = FilterOutputGain(1);
+	gout = FilterOutputGain(0);
+
+	for(x = 0; x < count; x++)
+	{
+		v = outCap[x] * gout;
+
+		//Box filter the CPU rate samples down to the output rate.
+		if(hiLen)
+		{
+			int32 a = (int64)x * hiLen / count;
+			int32 b = (int64)(x + 1) * hiLen / count;
+			int64 sum = 0;
+			int32 y;
+
+			for(y = a; y < b; y++)
+				sum += hiCap[y];
+			if(b > a)
+				v += (double)sum / (b - a) * ghi;
+		}
+
+		if(v > 32767) v = 32767;
+		if(v < -32768) v = -32768;
+		mixed[x] = (int32)lrint(v);
+
+		if(abs(mixed[x]) > peak)
+			peak = abs(mixed[x]);
+	}
+
+	if(expWave)
+		FCEU_WaveWrite(expWave, mixed, count);
+
+	samples = hiLen ? hiLen : count;
+
+	stats.frames++;
+	stats.frameTime = frameTime;
+	stats.totalTime += frameTime;
+	if(frameTime > stats.maxTime)
+		stats.maxTime = frameTime;
+	stats.frameSamples = samples;
+	stats.totalSamples += samples;
+	stats.framePeak = peak;
+	if(peak > stats.maxPeak)
+		stats.maxPeak = peak;
+
+	//Carry a partially filled low quality sample into the next frame.
+	x = (outLen > count) ? outCap[count] : 0;
+	memset(outCap, 0, outLen * sizeof(int32));
+	outCap[0] = x;
+	outLen = x ? 1 : 0;
+	hiLen = 0;
+	frameTime = 0;
+}
+
+const char *FCEUI_GetExpSoundName(void)
+{
+	return GameExpSound.Name;
+}
+
+void FCEUI_SetExpSoundProfiling(bool enable)
+{
+	if(enable && !profEnabled)
+		FCEUI_ResetExpSoundStats();
+	profEnabled = enable;
+	UpdateActive();
+}
+
+bool FCEUI_ExpSoundProfilingEnabled(void)
+{
+	return profEnabled;
+}
+
+bool FCEUI_GetExpSoundStats(EXPSOUNDSTATS *s)
+{
+	*s = stats;
+	return stats.name != NULL;
+}
+
+void FCEUI_ResetExpSoundStats(void)
+{
+	memset(&stats, 0, sizeof(stats));
+	stats.name = GameExpSound.Name;
+}
+
+bool FCEUI_BeginExpSoundWaveRecord(const char *fn)
+{
+	FCEUI_EndExpSoundWaveRecord();
+
+	if(!FSettings.SndRate)
+		return false;
+
+	if(!(expWave = FCEU_WaveOpen(fn, FSettings.SndRate, 1)))
+		return false;
+
+	UpdateActive();
+	return true;
+}
+
+bool FCEUI_ExpSoundWaveRecordRunning(void)
+{
+	return expWave != NULL;
+}
+
+int FCEUI_EndExpSoundWaveRecord(void)
+{
+	if(!expWave)
+		return 0;
+
+	FCEU_WaveClose(expWave);
+	expWave = NULL;
+	UpdateActive();
+	return 1;
+}
@@ -0,0 +1,31 @@
+#ifndef _SNDPROF_H_
+#define _SNDPROF_H_
+
+#include "types.h"
+
+//Set when expansion sound profiling or recording is on, so the sound
+//code can skip the hooks below entirely otherwise.
+extern bool FCEU_ExpSoundProfActive;
+
+//Bracket a GameExpSound callback.  buf/count is the region of the output
+//rate mix buffer the chip may add to, whatever it adds there is captured.
+//buf may be NULL to only time the callback.
+void FCEU_ExpSoundProfBegin(const int32 *buf, int32 count);
+void FCEU_ExpSoundProfEnd(const int32 *buf, int32 count);
+
+//Capture the CPU rate mix buffer in high quality mode, where the low 16
+//bits of each sample belong to the expansion chip alone.
+void FCEU_ExpSoundProfHi(const int32 *buf, int32 count);
+
+//Called once per emulated frame with the number of output samples produced.
+void FCEU_ExpSoundProfFrame(int32 count);
+
+//Keep capturing for another user (stem recording) regardless of the
+//profiling and recording settings.
+void FCEU_ExpSoundProfCapture(bool enable);
+
+//What the Fill/NeoFill callbacks added at the output rate this frame,
+//before mixer gain.  Valid until FCEU_ExpSoundProfFrame() is called.
+const int32 *FCEU_ExpSoundProfOutput(void);
+
+#endif
@@ -26,6 +26,8 @@
 #include "filter.h"
 #include "state.h"
 #include "wave.h"
+#include "sndprof.h"
+#include "stems.h"
 #include "debug.h"
 
 #include <cstdlib>
@@ -347,10 +349,14 @@ static DECLFW(Write_DMCRegs)
 	}
 }
 
+static void DMCSchedule(void);
+
 static DECLFW(StatusWrite)
 {
 	int x;
 
+    X6502_EventSync(X6502_EV_DMC);
+
     DoSQ1();
     DoSQ2();
     DoTriangle();
@@ -372,6 +378,8 @@ static DECLFW(StatusWrite)
 	SIRQStat&=~0x80;
 	X6502_IRQEnd(FCEU_IQDPCM);
 	EnabledChannels=V&0x1F;
+
+	DMCSchedule();
 }
 
 static DECLFR(StatusRead)
@@ -542,7 +550,21 @@ static INLINE void DMCDMA(void)
  }
 }
 
-void FCEU_SoundCPUHook(int cycles)
+static void FrameSchedule(void)
+{
+ X6502_EventSchedule(X6502_EV_FRAMECOUNT,(fhcnt+47)/48);
+}
+
+static void DMCSchedule(void)
+{
+ //A pending fetch is made before the next instruction.
+ if(DMCSize && !DMCHaveDMA)
+  X6502_EventSchedule(X6502_EV_DMC,0);
+ else
+  X6502_EventSchedule(X6502_EV_DMC,DMCacc);
+}
+
+void FCEU_SoundFrameEvent(int32 cycles)
 {
  fhcnt-=cycles*48;
  if(fhcnt<=0)
@@ -550,7 +572,11 @@ void FCEU_SoundCPUHook(int cycles)
   FrameSoundUpdate();
   fhcnt+=fhinc;
  }
+ FrameSchedule();
+}
 
+void FCEU_SoundDMCEvent(int32 cycles)
+{
  DMCDMA();
  DMCacc-=cycles;
 
@@ -579,6 +605,7 @@ void FCEU_SoundCPUHook(int cycles)
   DMCShift>>=1;
   tester();
  }
+ DMCSchedule();
 }
 
 void RDoPCM(void)
@@ -1009,8 +1036,72 @@ static void RDoNoise(void)
  ChannelBC[3]=SOUNDTS;
 }
 
+/* Stem recording wraps the high quality renderers, to pick each channel's
+   own contribution out of WaveHi as it is rendered.
+*/
+static INLINE void StemRender(int ch, void (*render)(void), int shift, const uint32 *lookup)
+{
+ int32 start=ChannelBC[ch];
+ int32 count=SOUNDTS-start;
+
+ FCEU_StemRenderBegin(&WaveHi[start],count);
+ render();
+ if(count>0)
+  FCEU_StemRenderEnd(ch,&WaveHi[start],start,count,shift,lookup);
+}
+
+static void SDoSQ1(void)
+{
+ StemRender(STEM_SQ1,RDoSQ1,24,wlookup1);
+}
+
+static void SDoSQ2(void)
+{
+ StemRender(STEM_SQ2,RDoSQ2,24,wlookup1);
+}
+
+static void SDoTriangle(void)
+{
+ StemRender(STEM_TRIANGLE,RDoTriangle,16,wlookup2);
+}
+
+static void SDoNoise(void)
+{
+ StemRender(STEM_NOISE,RDoNoise,16,wlookup2);
+}
+
+static void SDoPCM(void)
+{
+ StemRender(STEM_DMC,RDoPCM,16,wlookup2);
+}
+
+/* Picks the high quality renderers, with or without stem capture. */
+void FCEU_SoundStemHooks(void)
+{
+ if(!FSettings.SndRate || !FSettings.soundq)
+  return;
+
+ if(FCEU_StemActive)
+ {
+  DoNoise=SDoNoise;
+  DoTriangle=SDoTriangle;
+  DoPCM=SDoPCM;
+  DoSQ1=SDoSQ1;
+  DoSQ2=SDoSQ2;
+ }
+ else
+ {
+  DoNoise=RDoNoise;
+  DoTriangle=RDoTriangle;
+  DoPCM=RDoPCM;
+  DoSQ1=RDoSQ1;
+  DoSQ2=RDoSQ2;
+ }
+}
+
 DECLFW(Write_IRQFM)
 {
+ X6502_EventSync(X6502_EV_FRAMECOUNT);
  V=(V&0xC0)>>6;
  fcnt=0;
  if(V&0x2)
@@ -1020,6 +1111,7 @@ DECLFW(Write_IRQFM)
  X6502_IRQEnd(FCEU_IQFCOUNT);
  SIRQStat&=~0x40;
  IRQFrameMode=V;
+ FrameSchedule();
 }
 
 void SetNESSoundMap(void)
@@ -1057,7 +1149,21 @@ int FlushEmulateSound(void)
   {
    int32 *tmpo=&WaveHi[soundtsoffs];
 
-   if(GameExpSound.HiFill) GameExpSound.HiFill();
+   if(GameExpSound.HiFill)
+   {
+    if(FCEU_ExpSoundProfActive)
+    {
+     FCEU_ExpSoundProfBegin(NULL,0);
+     GameExpSound.HiFill();
+     FCEU_ExpSoundProfEnd(NULL,0);
+    }
+    else
+     GameExpSound.HiFill();
+   }
+   if(FCEU_ExpSoundProfActive)
+    FCEU_ExpSoundProfHi(tmpo,soundtimestamp);
+   if(FCEU_StemActive)
+    FCEU_StemExpHi(tmpo,soundtsoffs,soundtimestamp);
 
    for(x=soundtimestamp;x;x--)
    {
@@ -1065,8 +1171,14 @@ int FlushEmulateSound(void)
     *tmpo=(b&65535)+wlookup2[(b>>16)&255]+wlookup1[b>>24];
     tmpo++;
    }
+   if(FCEU_StemActive)
+    FCEU_StemFilter(SOUNDTS);
+
    end=NeoFilterSound(WaveHi,WaveFinal,SOUNDTS,&left);
 
+   if(FCEU_StemActive)
+    FCEU_StemFrame(end,SOUNDTS,left);
+
    memmove(WaveHi,WaveHi+SOUNDTS-left,left*sizeof(uint32));
    memset(WaveHi+left,0,sizeof(WaveHi)-left*sizeof(uint32));
 
@@ -1078,7 +1190,16 @@ int FlushEmulateSound(void)
   {
    end=(SOUNDTS<<16)/soundtsinc;
    if(GameExpSound.Fill)
-    GameExpSound.Fill(end&0xF);
+   {
+    if(FCEU_ExpSoundProfActive)
+    {
+     FCEU_ExpSoundProfBegin(Wave,(end>>4)+1);
+     GameExpSound.Fill(end&0xF);
+     FCEU_ExpSoundProfEnd(Wave,(end>>4)+1);
+    }
+    else
+     GameExpSound.Fill(end&0xF);
+   }
 
    SexyFilter(Wave,WaveFinal,end>>4);
 
@@ -1103,6 +1224,9 @@ int FlushEmulateSound(void)
   }
   inbuf=end;
 
+  if(FCEU_ExpSoundProfActive)
+   FCEU_ExpSoundProfFrame(end);
+
   FCEU_WriteWaveData(WaveFinal, end); /* This function will just return
 				    if sound recording is off. */
   return(end);
@@ -1235,11 +1359,7 @@ void SetSoundVariables(void)
    }
    if(FSettings.soundq>=1)
    {
-    DoNoise=RDoNoise;
-    DoTriangle=RDoTriangle;
-    DoPCM=RDoPCM;
-    DoSQ1=RDoSQ1;
-    DoSQ2=RDoSQ2;
+    FCEU_SoundStemHooks();
    }
    else
    {
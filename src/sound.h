@@ -36,6 +36,8 @@ typedef struct {
 
 	   void (*RChange)(void);
 	   void (*Kill)(void);
+
+	   const char *Name;	/* Chip name, for profiling and per-chip recording. */
 } EXPSOUND;
 
 extern EXPSOUND GameExpSound;
@@ -43,6 +45,7 @@ extern EXPSOUND GameExpSound;
 extern int32 nesincsize;
 
 void SetSoundVariables(void);
+void FCEU_SoundStemHooks(void);
 
 int GetSoundBuffer(int32 **W);
 int FlushEmulateSound(void);
@@ -69,7 +72,9 @@ void FCEUSND_Reset(void);
 void FCEUSND_SaveState(void);
 void FCEUSND_LoadState(int version);
 
-void FCEU_SoundCPUHook(int);
+//CPU events (see x6502.h) for the frame counter and the DMC.
+void FCEU_SoundFrameEvent(int32 cycles);
+void FCEU_SoundDMCEvent(int32 cycles);
 void Write_IRQFM (uint32 A, uint8 V); //mbg merge 7/17/06 brought over from latest mmbuild
 
 void LogDPCM(int romaddress, int dpcmsize);
@@ -364,7 +364,7 @@ int CurrentState=0;
 extern int geniestage;
 
 
-bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel)
+bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel, bool saveMovie)
 {
 	// reinit memory_savestate
 	// memory_savestate is global variable which already has its vector of bytes, so no need to allocate memory every time we use save/loadstate
@@ -375,6 +375,7 @@ bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel)
 
 	uint32 totalsize = 0;
 
+	X6502_SaveState();
 	FCEUPPU_SaveState();
 	FCEUSND_SaveState();
 	totalsize=WriteStateChunk(os,1,SFCPU);
@@ -389,7 +390,8 @@ bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel)
 
 		//MBG TAS Editor HACK HACK HACK!
 		//do not save the movie state if we are in Taseditor! That would be a huge waste of time and space!
-		if(!FCEUMOV_Mode(MOVIEMODE_TASEDITOR))
+		//the movie seek cache doesn't want it either, it only ever goes back into the same movie
+		if(saveMovie && !FCEUMOV_Mode(MOVIEMODE_TASEDITOR))
 		{
 			os->fseek(5,SEEK_CUR);
 			int size = FCEUMOV_WriteState(os);
@@ -599,6 +601,7 @@ int FCEUSS_LoadFP_old(EMUFILE* is, ENUM_SSLOADPARAMS params)
 	{
 		X.IRQlow=0;
 	}
+	X6502_LoadState();
 	if(GameStateRestore)
 	{
 		GameStateRestore(stateversion);
@@ -691,6 +694,7 @@ bool FCEUSS_LoadFP(EMUFILE* is, ENUM_SSLOADPARAMS params)
 	//if(read_sfcpuc && stateversion<9500)
 	//	X.IRQlow=0;
 
+	X6502_LoadState();
 	if(GameStateRestore)
 	{
 		GameStateRestore(stateversion);
@@ -852,6 +856,8 @@ void ResetExState(void (*PreSave)(void), void (*PostSave)(void))
 	}
 	// adelikat, 3/14/09:  had to add this to clear out the size parameter.  NROM(mapper 0) games were having savestate crashes if loaded after a non NROM game	because the size variable was carrying over and causing savestates to save too much data
 	SFMDATA[0].s = 0;
+	// and the pointer, for games that add none: it was still the last game's, freed or not
+	SFMDATA[0].v = 0;
 
 	SPreSave = PreSave;
 	SPostSave = PostSave;
@@ -0,0 +1,204 @@
+/* FCE Ultra - NES/Famicom Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/// \file
+/// \brief Per channel stem recording
+
+#include "types.h"
+#include "fceu.h"
+#include "driver.h"
+#include "sound.h"
+#include "filter.h"
+#include "wave.h"
+#include "sndprof.h"
+#include "stems.h"
+#include "utils/memory.h"
+
+#include <cstring>
+#include <string>
+
+#define STEM_HI_SIZE	40000	// Same as WaveHi
+
+bool FCEU_StemActive = false;
+
+static const char *stemNames[STEM_COUNT] = { "sq1", "sq2", "triangle", "noise", "dmc", "exp" };
+
+static WAVEFILE *stemWave[STEM_COUNT];
+static bool stemSplit = false;
+
+//Each channel mixed on its own, at the CPU rate, laid out like WaveHi.
+static int32 *stemHi[STEM_COUNT];
+static int32 *stemSnap = NULL;
+
+static int32 stemOut[STEM_COUNT][2048+512];
+static int32 stemFrame[(2048+512)*STEM_COUNT];
+static int64 stemAcc[STEM_COUNT][2];
+
+void FCEU_StemRenderBegin(const int32 *buf, int32 count)
+{
+	if(count > 0)
+		memcpy(stemSnap, buf, count * sizeof(int32));
+}
+
+void FCEU_StemRenderEnd(int ch, const int32 *buf, int32 start, int32 count, int shift, const uint32 *lookup)
+{
+	int32 *d = stemHi[ch] + start;
+	int32 x;
+
+	for(x = 0; x < count; x++)
+		d[x] = lookup[(uint32)(buf[x] - stemSnap[x]) >> shift];
+}
+
+void FCEU_StemExpHi(const int32 *buf, int32 start, int32 count)
+{
+	int32 *d = stemHi[STEM_EXP] + start;
+	int32 x;
+
+	for(x = 0; x < count; x++)
+		d[x] = buf[x] & 65535;
+}
+
+void FCEU_StemFilter(int32 inlen)
+{
+	int ch;
+
+	for(ch = 0; ch < STEM_COUNT; ch++)
+		NeoFilterStream(stemHi[ch], stemOut[ch], inlen);
+}
+
+void FCEU_StemFrame(int32 count, int32 inlen, int32 left)
+{
+	const int32 *expOut = FCEU_ExpSoundProfOutput();
+	int32 x;
+	int ch;
+
+	//Expansion audio added after the FIR (VRC7).
+	for(x = 0; x < count; x++)
+		stemOut[STEM_EXP][x] += expOut[x];
+
+	for(ch = 0; ch < STEM_COUNT; ch++)
+	{
+		SexyFilterStream(stemOut[ch], stemOut[ch], count, stemAcc[ch]);
+
+		memmove(stemHi[ch], stemHi[ch] + inlen - left, left * sizeof(int32));
+		memset(stemHi[ch] + left, 0, (inlen - left) * sizeof(int32));
+	}
+
+	if(stemSplit)
+	{
+		for(ch = 0; ch < STEM_COUNT; ch++)
+			FCEU_WaveWrite(stemWave[ch], stemOut[ch], count);
+	}
+	else
+	{
+		for(x = 0; x < count; x++)
+			for(ch = 0; ch < STEM_COUNT; ch++)
+				stemFrame[x * STEM_COUNT + ch] = stemOut[ch][x];
+
+		FCEU_WaveWrite(stemWave[0], stemFrame, count);
+	}
+}
+
+bool FCEUI_BeginStemRecord(const char *fn, bool split)
+{
+	int ch;
+
+	FCEUI_EndStemRecord();
+
+	//The low quality renderers mix the channels together as they go.
+	if(!FSettings.SndRate || !FSettings.soundq)
+	{
+		FCEU_PrintError("Stem recording needs high quality sound.");
+		return false;
+	}
+
+	stemSplit = split;
+	memset(stemWave, 0, sizeof(stemWave));
+
+	if(split)
+	{
+		std::string base = fn;
+		size_t dot = base.find_last_of('.');
+
+		if(dot != std::string::npos && base.find_first_of("/\\", dot) == std::string::npos)
+			base.erase(dot);
+
+		for(ch = 0; ch < STEM_COUNT; ch++)
+		{
+			std::string name = base + "-" + stemNames[ch] + ".wav";
+
+			if(!(stemWave[ch] = FCEU_WaveOpen(name.c_str(), FSettings.SndRate, 1)))
+				break;
+		}
+	}
+	else
+	{
+		stemWave[0] = FCEU_WaveOpen(fn, FSettings.SndRate, STEM_COUNT);
+		ch = stemWave[0] ? STEM_COUNT : 0;
+	}
+
+	if(ch < STEM_COUNT)
+	{
+		for(ch = 0; ch < STEM_COUNT; ch++)
+			FCEU_WaveClose(stemWave[ch]);
+		memset(stemWave, 0, sizeof(stemWave));
+		return false;
+	}
+
+	for(ch = 0; ch < STEM_COUNT; ch++)
+		stemHi[ch] = (int32*)FCEU_malloc(STEM_HI_SIZE * sizeof(int32));
+	stemSnap = (int32*)FCEU_malloc(STEM_HI_SIZE * sizeof(int32));
+
+	memset(stemOut, 0, sizeof(stemOut));
+	memset(stemAcc, 0, sizeof(stemAcc));
+
+	FCEU_StemActive = true;
+	FCEU_ExpSoundProfCapture(true);
+	FCEU_SoundStemHooks();
+
+	return true;
+}
+
+bool FCEUI_StemRecordRunning(void)
+{
+	return FCEU_StemActive;
+}
+
+int FCEUI_EndStemRecord(void)
+{
+	int ch;
+
+	if(!FCEU_StemActive)
+		return 0;
+
+	FCEU_StemActive = false;
+	FCEU_ExpSoundProfCapture(false);
+	FCEU_SoundStemHooks();
+
+	for(ch = 0; ch < STEM_COUNT; ch++)
+	{
+		FCEU_WaveClose(stemWave[ch]);
+		stemWave[ch] = NULL;
+
+		FCEU_free(stemHi[ch]);
+		stemHi[ch] = NULL;
+	}
+	FCEU_free(stemSnap);
+	stemSnap = NULL;
+
+	return 1;
+}
@@ -0,0 +1,36 @@
+#ifndef _STEMS_H_
+#define _STEMS_H_
+
+#include "types.h"
+
+enum
+{
+	STEM_SQ1 = 0,
+	STEM_SQ2,
+	STEM_TRIANGLE,
+	STEM_NOISE,
+	STEM_DMC,
+	STEM_EXP,
+	STEM_COUNT
+};
+
+//Set while stems are being recorded.
+extern bool FCEU_StemActive;
+
+//Bracket one APU channel render call.  buf/count is the region of WaveHi
+//starting at start that the channel is about to add to.  shift is where the
+//channel's amplitude sits within each WaveHi sample, and lookup is the
+//mixer table it goes through.
+void FCEU_StemRenderBegin(const int32 *buf, int32 count);
+void FCEU_StemRenderEnd(int ch, const int32 *buf, int32 start, int32 count, int shift, const uint32 *lookup);
+
+//Expansion audio at the CPU rate, taken from the low 16 bits of WaveHi.
+void FCEU_StemExpHi(const int32 *buf, int32 start, int32 count);
+
+//Run each stem through the output filter.  Call before NeoFilterSound()
+//with the same input length, and after it with the number of output
+//samples produced and the leftover count.
+void FCEU_StemFilter(int32 inlen);
+void FCEU_StemFrame(int32 count, int32 inlen, int32 left);
+
+#endif
@@ -30,6 +30,7 @@
 #include "utils/endian.h"
 #include "utils/memory.h"
 #include "utils/md5.h"
+#include "utils/crc32.h"
 #include "state.h"
 #include "file.h"
 #include "input.h"
@@ -638,3 +639,88 @@ init_ok:
 	currCartInfo = &UNIFCart;
 	return LOADER_OK;
 }
+
+//Identifies a UNIF image in memory without loading it, for the ROM library
+//scanner.  The MD5 is the one UNIFLoad computes, the CRC32 covers the same
+//data.
+bool UNIFIdentify(const uint8 *data, uint32 size, ROMLIBENTRY *e) {
+	const uint8 *chunk[32];
+	uint32 chunksize[32];
+	uint32 pos = 0x20;
+	struct md5_context md5;
+	uint8 ff[4096];
+	int x;
+
+	if (size < 0x20 || memcmp(data, "UNIF", 4))
+		return false;
+
+	memset(chunk, 0, sizeof(chunk));
+	e->format = "UNIF";
+	e->mapper = -1;
+	e->submapper = 0;
+	e->board = "";
+	e->region = 0;
+	e->battery = false;
+
+	while (pos + 8 <= size) {
+		const uint8 *id = data + pos;
+		uint32 len = FCEU_de32lsb((uint8 *)data + pos + 4);
+
+		pos += 8;
+		if (len > size - pos)
+			return false;
+
+		if (!memcmp(id, "PRG", 3) || !memcmp(id, "CHR", 3)) {
+			int z = id[3] - '0';
+
+			if (z < 0 || z > 15)
+				return false;
+			if (id[0] == 'C')
+				z += 16;
+			chunk[z] = data + pos;
+			chunksize[z] = len;
+		} else if (!memcmp(id, "MAPR", 4)) {
+			std::string name((const char *)data + pos, strnlen((const char *)data + pos, len));
+
+			if (!name.compare(0, 4, "NES-") || !name.compare(0, 4, "UNL-") || !name.compare(0, 4, "HVC-") || !name.compare(0, 4, "BTL-") || !name.compare(0, 4, "BMC-"))
+				name.erase(0, 4);
+			e->board = name;
+		} else if (!memcmp(id, "TVCI", 4) && len) {
+			if (data[pos] <= 2)
+				e->region = data[pos];
+		} else if (!memcmp(id, "BATR", 4)) {
+			e->battery = true;
+		}
+		pos += len;
+	}
+
+	memset(ff, 0xFF, sizeof(ff));
+	md5_starts(&md5);
+	e->crc32 = 0;
+	e->prgSize = e->chrSize = 0;
+	for (x = 0; x < 32; x++) {
+		uint32 n, total;
+
+		if (!chunk[x])
+			continue;
+		n = chunksize[x];
+		total = FixRomSize(n, (x < 16) ? 2048 : 8192);
+		md5_update(&md5, (uint8 *)chunk[x], n);
+		e->crc32 = CalcCRC32(e->crc32, (uint8 *)chunk[x], n);
+		while (n < total) {
+			uint32 f = total - n;
+
+			if (f > sizeof(ff))
+				f = sizeof(ff);
+			md5_update(&md5, ff, f);
+			e->crc32 = CalcCRC32(e->crc32, ff, f);
+			n += f;
+		}
+		if (x < 16)
+			e->prgSize += chunksize[x];
+		else
+			e->chrSize += chunksize[x];
+	}
+	md5_finish(&md5, e->md5);
+	return true;
+}
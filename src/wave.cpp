@@ -54,24 +54,70 @@ void FCEU_WriteWaveData(int32 *Buffer, int Count)
 	#endif
 }
 
-int FCEUI_EndWaveRecord()
+/* Fill in the RIFF and data chunk sizes, once the total is known. */
+static void FinishWaveHeader(FILE *fp, long datasize)
 {
  long s;
 
+ s=ftell(fp)-8;
+ fseek(fp,4,SEEK_SET);
+ fputc(s&0xFF,fp);
+ fputc((s>>8)&0xFF,fp);
+ fputc((s>>16)&0xFF,fp);
+ fputc((s>>24)&0xFF,fp);
+
+ fseek(fp,0x28,SEEK_SET);
+ s=datasize;
+ fputc(s&0xFF,fp);
+ fputc((s>>8)&0xFF,fp);
+ fputc((s>>16)&0xFF,fp);
+ fputc((s>>24)&0xFF,fp);
+}
+
+/* Sizes are left blank, see FinishWaveHeader(). */
+static void WriteWaveHeader(FILE *fp, int rate, int channels)
+{
+ int r;
+
+ fputs("RIFF",fp);
+ fseek(fp,4,SEEK_CUR);  // Skip size
+ fputs("WAVEfmt ",fp);
+
+ fputc(0x10,fp);
+ fputc(0,fp);
+ fputc(0,fp);
+ fputc(0,fp);
+
+ fputc(1,fp);     // PCM
+ fputc(0,fp);
+
+ fputc(channels,fp);
+ fputc(0,fp);
+
+ r=rate;
+ fputc(r&0xFF,fp);
+ fputc((r>>8)&0xFF,fp);
+ fputc((r>>16)&0xFF,fp);
+ fputc((r>>24)&0xFF,fp);
+ r*=2*channels;
+ fputc(r&0xFF,fp);
+ fputc((r>>8)&0xFF,fp);
+ fputc((r>>16)&0xFF,fp);
+ fputc((r>>24)&0xFF,fp);
+ fputc(2*channels,fp);
+ fputc(0,fp);
+ fputc(16,fp);
+ fputc(0,fp);
+
+ fputs("data",fp);
+ fseek(fp,4,SEEK_CUR);
+}
+
+int FCEUI_EndWaveRecord()
+{
  if(!soundlog) return 0;
- s=ftell(soundlog)-8;
- fseek(soundlog,4,SEEK_SET);
- fputc(s&0xFF,soundlog);
- fputc((s>>8)&0xFF,soundlog);
- fputc((s>>16)&0xFF,soundlog);
- fputc((s>>24)&0xFF,soundlog);
-
- fseek(soundlog,0x28,SEEK_SET);
- s=wsize;
- fputc(s&0xFF,soundlog);
- fputc((s>>8)&0xFF,soundlog);
- fputc((s>>16)&0xFF,soundlog);
- fputc((s>>24)&0xFF,soundlog);
+
+ FinishWaveHeader(soundlog,wsize);
 
  fclose(soundlog);
  soundlog=0;
@@ -81,46 +127,12 @@ int FCEUI_EndWaveRecord()
 
 bool FCEUI_BeginWaveRecord(const char *fn)
 {
- int r;
-
  if(!(soundlog=FCEUD_UTF8fopen(fn,"wb")))
   return false;
  wsize=0;
 
-
  /* Write the header. */
- fputs("RIFF",soundlog);
- fseek(soundlog,4,SEEK_CUR);  // Skip size
- fputs("WAVEfmt ",soundlog);
-
- fputc(0x10,soundlog);
- fputc(0,soundlog);
- fputc(0,soundlog);
- fputc(0,soundlog);
-
- fputc(1,soundlog);     // PCM
- fputc(0,soundlog);
-
- fputc(1,soundlog);     // Monophonic
- fputc(0,soundlog);
-
- r=FSettings.SndRate;
- fputc(r&0xFF,soundlog);
- fputc((r>>8)&0xFF,soundlog);
- fputc((r>>16)&0xFF,soundlog);
- fputc((r>>24)&0xFF,soundlog);
- r<<=1;
- fputc(r&0xFF,soundlog);
- fputc((r>>8)&0xFF,soundlog);
- fputc((r>>16)&0xFF,soundlog);
- fputc((r>>24)&0xFF,soundlog);
- fputc(2,soundlog);
- fputc(0,soundlog);
- fputc(16,soundlog);
- fputc(0,soundlog);
-
- fputs("data",soundlog);
- fseek(soundlog,4,SEEK_CUR);
+ WriteWaveHeader(soundlog,FSettings.SndRate,1);
 
  return true;
 }
@@ -129,3 +141,62 @@ bool FCEUI_WaveRecordRunning(void)
 {
 	return (soundlog != NULL);
 }
+
+/* Generic wave file writer, for auxiliary streams recorded alongside
+   the main sound log (expansion chip output, channel stems, etc).
+*/
+struct WAVEFILE
+{
+ FILE *fp;
+ long size;
+ int channels;
+};
+
+WAVEFILE *FCEU_WaveOpen(const char *fn, int rate, int channels)
+{
+ WAVEFILE *wf;
+ FILE *fp;
+
+ if(!(fp=FCEUD_UTF8fopen(fn,"wb")))
+  return NULL;
+
+ wf=new WAVEFILE;
+ wf->fp=fp;
+ wf->size=0;
+ wf->channels=channels;
+
+ WriteWaveHeader(fp,rate,channels);
+
+ return wf;
+}
+
+/* Count is in sample frames, Buffer holds Count*channels interleaved samples. */
+void FCEU_WaveWrite(WAVEFILE *wf, const int32 *Buffer, int Count)
+{
+ int x;
+
+ if(!wf) return;
+
+ x=Count*wf->channels;
+ while(x--)
+ {
+  int32 v=*Buffer;
+
+  if(v>32767) v=32767;
+  if(v<-32768) v=-32768;
+
+  fputc(((uint16)v)&255,wf->fp);
+  fputc(((uint16)v)>>8,wf->fp);
+  Buffer++;
+ }
+ wf->size+=Count*wf->channels*sizeof(int16);
+}
+
+void FCEU_WaveClose(WAVEFILE *wf)
+{
+ if(!wf) return;
+
+ FinishWaveHeader(wf->fp,wf->size);
+ fclose(wf->fp);
+ delete wf;
+}
@@ -4,3 +4,9 @@ bool FCEUI_BeginWaveRecord(const char *fn);
 bool FCEUI_WaveRecordRunning(void);
 void FCEU_WriteWaveData(int32 *Buffer, int Count);
 int FCEUI_EndWaveRecord(void);
+
+struct WAVEFILE;
+
+WAVEFILE *FCEU_WaveOpen(const char *fn, int rate, int channels);
+void FCEU_WaveWrite(WAVEFILE *wf, const int32 *Buffer, int Count);
+void FCEU_WaveClose(WAVEFILE *wf);
@@ -23,6 +23,8 @@
 #include "fceu.h"
 #include "debug.h"
 #include "sound.h"
+#include "cart.h"
+#include "ppu.h"
 #ifdef _S9XLUA_H
 #include "fceulua.h"
 #endif
@@ -54,6 +56,7 @@ static INLINE uint8 RdMem(unsigned int A)
 static INLINE void WrMem(unsigned int A, uint8 V)
 {
 	BWrite[A](A,V);
+	DEBUG( debugDirtyCPU[A>>8]=1 )
 	#ifdef _S9XLUA_H
 	CallRegisteredLuaMemHook(A, 1, V, LUAMEMHOOK_WRITE);
 	#endif
@@ -69,6 +72,7 @@ static INLINE uint8 RdRAM(unsigned int A)
 static INLINE void WrRAM(unsigned int A, uint8 V)
 {
 	RAM[A]=V;
+	DEBUG( debugDirtyCPU[A>>8]=1 )
 	#ifdef _S9XLUA_H
 	CallRegisteredLuaMemHook(A, 1, V, LUAMEMHOOK_WRITE);
 	#endif
@@ -118,6 +122,8 @@ static uint8 ZNTable[256];
   _PC+=disp;  \
   if((tmp^_PC)&0x100)  \
   ADDCYC(1);  \
+  if(disp<0 && FSettings.IdleSkip)  \
+   IdleLoop();  \
  }  \
  else _PC++;  \
 }
@@ -304,36 +310,36 @@ static uint8 ZNTable[256];
    redundant) on the variable "x".
 */
 
-#define RMW_A(op) {uint8 x=_A; op; _A=x; break; } /* Meh... */
-#define RMW_AB(op) {unsigned int A; uint8 x; GetAB(A); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); break; }
-#define RMW_ABI(reg,op) {unsigned int A; uint8 x; GetABIWR(A,reg); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); break; }
+#define RMW_A(op) {uint8 x=_A; op; _A=x; OPEND; } /* Meh... */
+#define RMW_AB(op) {unsigned int A; uint8 x; GetAB(A); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); OPEND; }
+#define RMW_ABI(reg,op) {unsigned int A; uint8 x; GetABIWR(A,reg); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); OPEND; }
 #define RMW_ABX(op)  RMW_ABI(_X,op)
 #define RMW_ABY(op)  RMW_ABI(_Y,op)
-#define RMW_IX(op)  {unsigned int A; uint8 x; GetIX(A); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); break; }
-#define RMW_IY(op)  {unsigned int A; uint8 x; GetIYWR(A); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); break; }
-#define RMW_ZP(op)  {uint8 A; uint8 x; GetZP(A); x=RdRAM(A); op; WrRAM(A,x); break; }
-#define RMW_ZPX(op) {uint8 A; uint8 x; GetZPI(A,_X); x=RdRAM(A); op; WrRAM(A,x); break;}
-
-#define LD_IM(op)  {uint8 x; x=RdMem(_PC); _PC++; op; break;}
-#define LD_ZP(op)  {uint8 A; uint8 x; GetZP(A); x=RdRAM(A); op; break;}
-#define LD_ZPX(op)  {uint8 A; uint8 x; GetZPI(A,_X); x=RdRAM(A); op; break;}
-#define LD_ZPY(op)  {uint8 A; uint8 x; GetZPI(A,_Y); x=RdRAM(A); op; break;}
-#define LD_AB(op)  {unsigned int A; uint8 x; GetAB(A); x=RdMem(A); op; break; }
-#define LD_ABI(reg,op)  {unsigned int A; uint8 x; GetABIRD(A,reg); x=RdMem(A); op; break;}
+#define RMW_IX(op)  {unsigned int A; uint8 x; GetIX(A); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); OPEND; }
+#define RMW_IY(op)  {unsigned int A; uint8 x; GetIYWR(A); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); OPEND; }
+#define RMW_ZP(op)  {uint8 A; uint8 x; GetZP(A); x=RdRAM(A); op; WrRAM(A,x); OPEND; }
+#define RMW_ZPX(op) {uint8 A; uint8 x; GetZPI(A,_X); x=RdRAM(A); op; WrRAM(A,x); OPEND;}
+
+#define LD_IM(op)  {uint8 x; x=RdMem(_PC); _PC++; op; OPEND;}
+#define LD_ZP(op)  {uint8 A; uint8 x; GetZP(A); x=RdRAM(A); op; OPEND;}
+#define LD_ZPX(op)  {uint8 A; uint8 x; GetZPI(A,_X); x=RdRAM(A); op; OPEND;}
+#define LD_ZPY(op)  {uint8 A; uint8 x; GetZPI(A,_Y); x=RdRAM(A); op; OPEND;}
+#define LD_AB(op)  {unsigned int A; uint8 x; GetAB(A); x=RdMem(A); op; OPEND; }
+#define LD_ABI(reg,op)  {unsigned int A; uint8 x; GetABIRD(A,reg); x=RdMem(A); op; OPEND;}
 #define LD_ABX(op)  LD_ABI(_X,op)
 #define LD_ABY(op)  LD_ABI(_Y,op)
-#define LD_IX(op)  {unsigned int A; uint8 x; GetIX(A); x=RdMem(A); op; break;}
-#define LD_IY(op)  {unsigned int A; uint8 x; GetIYRD(A); x=RdMem(A); op; break;}
-
-#define ST_ZP(r)  {uint8 A; GetZP(A); WrRAM(A,r); break;}
-#define ST_ZPX(r)  {uint8 A; GetZPI(A,_X); WrRAM(A,r); break;}
-#define ST_ZPY(r)  {uint8 A; GetZPI(A,_Y); WrRAM(A,r); break;}
-#define ST_AB(r)  {unsigned int A; GetAB(A); WrMem(A,r); break;}
-#define ST_ABI(reg,r)  {unsigned int A; GetABIWR(A,reg); WrMem(A,r); break; }
+#define LD_IX(op)  {unsigned int A; uint8 x; GetIX(A); x=RdMem(A); op; OPEND;}
+#define LD_IY(op)  {unsigned int A; uint8 x; GetIYRD(A); x=RdMem(A); op; OPEND;}
+
+#define ST_ZP(r)  {uint8 A; GetZP(A); WrRAM(A,r); OPEND;}
+#define ST_ZPX(r)  {uint8 A; GetZPI(A,_X); WrRAM(A,r); OPEND;}
+#define ST_ZPY(r)  {uint8 A; GetZPI(A,_Y); WrRAM(A,r); OPEND;}
+#define ST_AB(r)  {unsigned int A; GetAB(A); WrMem(A,r); OPEND;}
+#define ST_ABI(reg,r)  {unsigned int A; GetABIWR(A,reg); WrMem(A,r); OPEND; }
 #define ST_ABX(r)  ST_ABI(_X,r)
 #define ST_ABY(r)  ST_ABI(_Y,r)
-#define ST_IX(r)  {unsigned int A; GetIX(A); WrMem(A,r); break; }
-#define ST_IY(r)  {unsigned int A; GetIYWR(A); WrMem(A,r); break; }
+#define ST_IX(r)  {unsigned int A; GetIX(A); WrMem(A,r); OPEND; }
+#define ST_IY(r)  {unsigned int A; GetIYWR(A); WrMem(A,r); OPEND; }
 
 static uint8 CycTable[256] =
 {
@@ -370,6 +376,203 @@ void X6502_IRQEnd(int w)
  _IRQlow&=~w;
 }
 
+typedef struct
+{
+ uint32 stamp;                //has been run for every cycle up to here,
+ uint32 due;                  //and has to run again once timestamp gets here.
+ void (*run)(int32 cycles);
+ int pauseoc;                 //cycles spent overclocking are dropped
+} X6502EVENT;
+
+static void MapIRQEvent(int32 cycles)
+{
+ if(MapIRQHook)
+  MapIRQHook(cycles);
+ else
+  X6502_EventSchedule(X6502_EV_MAPIRQ,X6502_EVENT_MAXDELAY);
+}
+
+static X6502EVENT events[X6502_EV_COUNT]=
+{
+ { 0, 0, MapIRQEvent, 0 },
+ { 0, 0, FCEU_SoundFrameEvent, 1 },
+ { 0, 0, FCEU_SoundDMCEvent, 1 },
+};
+
+//Binary min-heap of event numbers by due time, ties going to the lower
+//number.  nextevent is the due time of the one on top.
+static int evheap[X6502_EV_COUNT], evpos[X6502_EV_COUNT];
+static uint32 nextevent;
+
+static INLINE int EventBefore(int a, int b)
+{
+ int32 d=events[a].due-events[b].due;
+ return d<0 || (!d && a<b);
+}
+
+static void EventSwap(int i, int j)
+{
+ int t=evheap[i];
+ evheap[i]=evheap[j];
+ evheap[j]=t;
+ evpos[evheap[i]]=i;
+ evpos[evheap[j]]=j;
+}
+
+//Moves an event whose due time changed back into place.
+static void EventFix(int ev)
+{
+ int i=evpos[ev];
+
+ while(i>0 && EventBefore(ev,evheap[(i-1)>>1]))
+ {
+  EventSwap(i,(i-1)>>1);
+  i=(i-1)>>1;
+ }
+ for(;;)
+ {
+  int c=i*2+1;
+  if(c>=X6502_EV_COUNT)
+   break;
+  if(c+1<X6502_EV_COUNT && EventBefore(evheap[c+1],evheap[c]))
+   c++;
+  if(!EventBefore(evheap[c],ev))
+   break;
+  EventSwap(i,c);
+  i=c;
+ }
+ nextevent=events[evheap[0]].due;
+}
+
+//Everything has run up to t and is due again at t.
+static void EventsReset(uint32 t)
+{
+ int ev;
+
+ for(ev=0;ev<X6502_EV_COUNT;ev++)
+ {
+  events[ev].stamp=events[ev].due=t;
+  evheap[ev]=evpos[ev]=ev;
+ }
+ nextevent=t;
+}
+
+//Runs whatever is due at the start of an instruction, whose own cycles
+//(temp) are already in timestamp.  Called for every instruction while
+//overclocking, since the APU events have to skip those cycles.
+static void RunEvents(int32 temp)
+{
+ uint32 now=timestamp;
+ int ev;
+
+ for(ev=0;ev<X6502_EV_COUNT;ev++)
+ {
+  X6502EVENT *e=&events[ev];
+
+  if(overclocking && e->pauseoc)
+  {
+   //Catch up to the start of the previous instruction, the last one that
+   //still counted, and let the rest go by.
+   uint32 prev=now-temp;
+   int32 cycles=prev-e->stamp;
+
+   if(cycles>0)
+   {
+    e->stamp=e->due=prev;
+    EventFix(ev);
+    e->run(cycles);
+   }
+   e->due+=now-e->stamp;
+   e->stamp=now;
+   EventFix(ev);
+  }
+  else if((int32)(now-e->due)>=0)
+  {
+   int32 cycles=now-e->stamp;
+
+   e->stamp=e->due=now;
+   EventFix(ev);
+   e->run(cycles);
+  }
+ }
+}
+
+void X6502_EventSchedule(int ev, int32 cycles)
+{
+ if(cycles<0)
+  cycles=0;
+ else if(cycles>X6502_EVENT_MAXDELAY)
+  cycles=X6502_EVENT_MAXDELAY;
+ events[ev].due=events[ev].stamp+cycles;
+ EventFix(ev);
+}
+
+void X6502_EventSync(int ev)
+{
+ //Events run at the start of each instruction, so anything added since
+ //(in _tcount) is left for the next run, as it was before scheduling.
+ uint32 now=timestamp-_tcount;
+ int32 cycles=now-events[ev].stamp;
+
+ if(cycles>0)
+ {
+  events[ev].stamp=events[ev].due=now;
+  EventFix(ev);
+  events[ev].run(cycles);
+ }
+}
+
+void X6502_SyncEvents(void)
+{
+ int ev;
+
+ for(ev=0;ev<X6502_EV_COUNT;ev++)
+  X6502_EventSync(ev);
+}
+
+void X6502_MapIRQSchedule(int32 cycles)
+{
+ X6502_EventSchedule(X6502_EV_MAPIRQ,cycles);
+}
+
+void X6502_MapIRQSync(void)
+{
+ X6502_EventSync(X6502_EV_MAPIRQ);
+}
+
+int32 X6502_DotCycles(int32 dots)
+{
+ //X6502_Run() stops once _count runs out, which can be partway into the
+ //last instruction.
+ int32 units=dots*(PAL?15:16)+_count;
+
+ return (units>0?(units+47)/48:0)+_tcount;
+}
+
+void X6502_Rebase(void)
+{
+ int ev;
+
+ for(ev=0;ev<X6502_EV_COUNT;ev++)
+ {
+  events[ev].stamp-=timestamp;
+  events[ev].due-=timestamp;
+ }
+ nextevent-=timestamp;
+}
+
+void X6502_SaveState(void)
+{
+ X6502_SyncEvents();
+}
+
+void X6502_LoadState(void)
+{
+ EventsReset(timestamp-_tcount);
+ //the whole machine was just replaced
+ DEBUG( DebugMarkAllDirty() )
+}
+
 void TriggerNMI(void)
 {
  _IRQlow|=FCEU_IQNMI;
@@ -382,7 +585,16 @@ void TriggerNMI2(void)
 
 void X6502_Reset(void)
 {
+ int ev;
+
  _IRQlow=FCEU_IQRESET;
+
+ //The hardware was just reset, so work out again when it's next due.
+ for(ev=0;ev<X6502_EV_COUNT;ev++)
+ {
+  events[ev].due=events[ev].stamp;
+  EventFix(ev);
+ }
 }
 /**
 * Initializes the 6502 CPU
@@ -417,26 +629,16 @@ void X6502_Power(void)
  _count=_tcount=_IRQlow=_PC=_A=_X=_Y=_P=_PI=_DB=_jammed=0;
  _S=0xFD;
  timestamp=soundtimestamp=0;
+ EventsReset(0);
  X6502_Reset();
  StackAddrBackup = -1;
+ DEBUG( DebugMarkAllDirty() )
 }
 
-void X6502_Run(int32 cycles)
+//Takes a pending reset, NMI or IRQ before the next instruction.  Returns 0
+//if that used up the rest of the cycles.
+static INLINE int Interrupts(void)
 {
-  if(PAL)
-   cycles*=15;    // 15*4=60
-  else
-   cycles*=16;    // 16*4=64
-
-  _count+=cycles;
-extern int test; test++;
-  while(_count>0)
-  {
-   int32 temp;
-   uint8 b1;
-
-   if(_IRQlow)
-   {
     if(_IRQlow&FCEU_IQRESET)
     {
 	 DEBUG( if(debug_loggingCD) LogCDVectors(0xFFFC); )
@@ -484,31 +686,253 @@ extern int test; test++;
     if(_count<=0)
     {
      _PI=_P;
-     return;
+     return 0;
      } //Should increase accuracy without a
               //major speed hit.
-   }
+    return 1;
+}
+
+//Idle loops.  A loop that only reads RAM, ROM or a settled $2002 and comes
+//back round with every register as it was will go round exactly the same
+//way until an event, an interrupt or the end of the slice, so the passes up
+//to there are counted instead of run.  Called on a backward branch or jump,
+//with _PC at the loop's start.
+
+#define IDLE_MAXOPS 8
+#define IDLE_FAILS 64
 
-	//will probably cause a major speed decrease on low-end systems
-   DEBUG( DebugCycle() );
+//Loops that can never be skipped, by address and the bank it was in, so a
+//game alternating between a few busy loops doesn't decode them every time
+//round.  A loop in RAM whose code gets rewritten just waits for its slot to
+//be taken.
+static struct
+{
+ uint32 pc;
+ uint8 *page;
+} idlefail[IDLE_FAILS];
+
+#define IDLEFAIL(pc) idlefail[((pc)^((pc)>>6))&(IDLE_FAILS-1)]
+
+//A read with nothing behind it that could change while the loop goes round,
+//or -1.
+static int IdlePeek(uint32 A)
+{
+ readfunc f=ARead[A];
+
+ if(f==ARAML || f==CartBR || (f==CartBROB && Page[A>>11]))
+  return f(A);
+ return FCEUPPU_PeekStatus(A);
+}
+
+static void IdleLoop(void)
+{
+ uint16 pc=_PC;
+ uint8 a=_A, x=_X, y=_Y, p=_P, pi=_P, db=_DB;
+ int32 cycles=0, extra=0, ops=0, n, left;
+
+ if(_IRQlow || overclocking || (IDLEFAIL(pc).pc==pc && IDLEFAIL(pc).page==Page[pc>>11]))
+  return;
+#ifdef FCEU_THREADED_CPU
+ if(X6502_stepHook)
+  return;
+#endif
+ DEBUG( if(DebugWatchingCPU()) return )
+#ifdef _S9XLUA_H
+ if(FCEU_LuaExecHooked())
+  return;
+#endif
+
+ //Go round once on copies of the registers, reading nothing but IdlePeek.
+ do
+ {
+  int op, v=0, t;
+  uint32 A;
+
+  if(ops==IDLE_MAXOPS || (op=IdlePeek(pc))<0)
+   return;
+  pi=p;
+  db=op;
+  pc++;
+  ops++;
+  cycles+=CycTable[op];
+  extra=0;
+
+  switch(op)
+  {
+   //implied
+   case 0xEA: continue;
+   case 0x18: p&=~C_FLAG; continue;
+   case 0x38: p|=C_FLAG; continue;
+   case 0xB8: p&=~V_FLAG; continue;
+   case 0xAA: x=a; p&=~(Z_FLAG|N_FLAG); p|=ZNTable[x]; continue;
+   case 0xA8: y=a; p&=~(Z_FLAG|N_FLAG); p|=ZNTable[y]; continue;
+   case 0x8A: a=x; p&=~(Z_FLAG|N_FLAG); p|=ZNTable[a]; continue;
+   case 0x98: a=y; p&=~(Z_FLAG|N_FLAG); p|=ZNTable[a]; continue;
+
+   //branches; the offset is only read when taken
+   case 0x10: t=!(p&N_FLAG); goto branch;
+   case 0x30: t=p&N_FLAG; goto branch;
+   case 0x50: t=!(p&V_FLAG); goto branch;
+   case 0x70: t=p&V_FLAG; goto branch;
+   case 0x90: t=!(p&C_FLAG); goto branch;
+   case 0xB0: t=p&C_FLAG; goto branch;
+   case 0xD0: t=!(p&Z_FLAG); goto branch;
+   case 0xF0: t=p&Z_FLAG;
+   branch:
+    if(t)
+    {
+     uint16 tmp;
+
+     if((v=IdlePeek(pc))<0)
+      return;
+     db=v;
+     pc++;
+     tmp=pc;
+     pc+=(int8)v;
+     extra=((tmp^pc)&0x100) ? 2 : 1;
+     cycles+=extra;
+    }
+    else
+     pc++;
+    continue;
+
+   case 0x4C:
+    if((v=IdlePeek(pc))<0 || (t=IdlePeek((uint16)(pc+1)))<0)
+     return;
+    db=t;
+    pc=v|(t<<8);
+    continue;
+  }
+
+  //The rest read an operand: immediate, zero page or absolute.
+  switch(op&0x1F)
+  {
+   case 0x00: case 0x02: case 0x09:
+    if((v=IdlePeek(pc))<0)
+     return;
+    pc++;
+    break;
+   case 0x04: case 0x05: case 0x06:
+    if((A=IdlePeek(pc))>0xFF || (v=IdlePeek(A))<0)
+     return;
+    pc++;
+    break;
+   case 0x0C: case 0x0D: case 0x0E:
+    if((v=IdlePeek(pc))<0 || (t=IdlePeek((uint16)(pc+1)))<0 || (v=IdlePeek(v|(t<<8)))<0)
+     return;
+    pc+=2;
+    break;
+   default:
+    v=-1;
+  }
+  db=v;
 
-   IncrementInstructionsCounters();
+  switch(op)
+  {
+   case 0xA9: case 0xA5: case 0xAD: a=v; p&=~(Z_FLAG|N_FLAG); p|=ZNTable[a]; break;
+   case 0xA2: case 0xA6: case 0xAE: x=v; p&=~(Z_FLAG|N_FLAG); p|=ZNTable[x]; break;
+   case 0xA0: case 0xA4: case 0xAC: y=v; p&=~(Z_FLAG|N_FLAG); p|=ZNTable[y]; break;
+   case 0x29: case 0x25: case 0x2D: a&=v; p&=~(Z_FLAG|N_FLAG); p|=ZNTable[a]; break;
+   case 0x09: case 0x05: case 0x0D: a|=v; p&=~(Z_FLAG|N_FLAG); p|=ZNTable[a]; break;
+   case 0x49: case 0x45: case 0x4D: a^=v; p&=~(Z_FLAG|N_FLAG); p|=ZNTable[a]; break;
+   case 0x24: case 0x2C:
+    p&=~(Z_FLAG|V_FLAG|N_FLAG);
+    p|=ZNTable[v&a]&Z_FLAG;
+    p|=v&(V_FLAG|N_FLAG);
+    break;
+   case 0xC9: case 0xC5: case 0xCD: t=a; goto compare;
+   case 0xE0: case 0xE4: case 0xEC: t=x; goto compare;
+   case 0xC0: case 0xC4: case 0xCC: t=y;
+   compare:
+    A=t-v;
+    p&=~(Z_FLAG|N_FLAG|C_FLAG);
+    p|=ZNTable[A&0xFF];
+    p|=((A>>8)&C_FLAG)^C_FLAG;
+    break;
+   default:
+    //Writes, the stack, indexing and so on: no good, whatever the registers.
+    IDLEFAIL(_PC).pc=_PC;
+    IDLEFAIL(_PC).page=Page[_PC>>11];
+    return;
+  }
+ } while(pc!=_PC);
+
+ if(a!=_A || x!=_X || y!=_Y || p!=_P)
+  return;
+
+ //Whole passes that end before the slice does and before anything is due.
+ n=(_count-1)/(cycles*48);
+ left=(int32)(nextevent-timestamp)-1;
+ if(left<cycles*n)
+  n=left/cycles;
+ if(n<=0)
+  return;
+
+ timestamp+=n*cycles;
+ soundtimestamp+=n*cycles;
+ _count-=n*cycles*48;
+ _tcount=extra;
+ _PI=pi;
+ _DB=db;
+ total_instructions+=n*ops;
+ delta_instructions+=n*ops;
+}
 
-   _PI=_P;
-   b1=RdMem(_PC);
+#ifdef _S9XLUA_H
+#define EXECHOOK() CallRegisteredLuaMemHook(_PC, 1, 0, LUAMEMHOOK_EXEC)
+#else
+#define EXECHOOK()
+#endif
 
-   ADDCYC(CycTable[b1]);
+#ifdef FCEU_THREADED_CPU
+void (*X6502_stepHook)(void)=0;
+#define STEPHOOK() if(X6502_stepHook) X6502_stepHook()
+#else
+#define STEPHOOK()
+#endif
+
+//Starts an instruction: fetches the opcode into b1, counts its cycles and
+//runs whatever events are due.
+#define FETCHOP()  \
+{  \
+ /*will probably cause a major speed decrease on low-end systems*/  \
+ DEBUG( DebugCycle() );  \
+ STEPHOOK();  \
+ IncrementInstructionsCounters();  \
+ _PI=_P;  \
+ b1=RdMem(_PC);  \
+ ADDCYC(CycTable[b1]);  \
+ temp=_tcount;  \
+ _tcount=0;  \
+ if((int32)(timestamp-nextevent)>=0 || overclocking)  \
+  RunEvents(temp);  \
+ EXECHOOK();  \
+ _PC++;  \
+}
 
-   temp=_tcount;
-   _tcount=0;
-   if(MapIRQHook) MapIRQHook(temp);
-   
-   if (!overclocking)
-    FCEU_SoundCPUHook(temp);
-   #ifdef _S9XLUA_H
-   CallRegisteredLuaMemHook(_PC, 1, 0, LUAMEMHOOK_EXEC);
-   #endif
-   _PC++;
+//ops.inc is written in terms of these, so it can be built as a switch here
+//and as threaded code below.
+#define OPCODE(n) case n
+#define OPEND break
+
+void X6502_RunDebug(int32 cycles)
+{
+  if(PAL)
+   cycles*=15;    // 15*4=60
+  else
+   cycles*=16;    // 16*4=64
+
+  _count+=cycles;
+extern int test; test++;
+  while(_count>0)
+  {
+   int32 temp;
+   uint8 b1;
+
+   if(_IRQlow && !Interrupts())
+    return;
+
+   FETCHOP();
    switch(b1)
    {
     #include "ops.inc"
@@ -516,6 +940,100 @@ extern int test; test++;
   }
 }
 
+#ifdef FCEU_THREADED_CPU
+bool X6502_threaded=true;
+
+//RAM reads in the threaded core skip the handler unless something, usually a
+//cheat, has put its own on the byte.
+static INLINE uint8 RdRAMDirect(unsigned int A)
+{
+ if(ARead[A]==ARAML)
+  return(_DB=RAM[A]);
+ return(_DB=ARead[A](A));
+}
+
+static INLINE uint8 RdMemDirect(unsigned int A)
+{
+ if(A<0x800 && ARead[A]==ARAML)
+  return(_DB=RAM[A]);
+ return(_DB=ARead[A](A));
+}
+
+#undef OPCODE
+#undef OPEND
+#define OPCODE(n) op_##n
+
+//Each instruction goes straight on to the next one.  Only interrupts and the
+//end of the slice go back round the loop.
+#define OPEND  \
+{  \
+ if(_count<=0 || _IRQlow)  \
+  goto loop;  \
+ FETCHOP();  \
+ goto *optable[b1];  \
+}
+
+//Loads, compares and BIT are mostly polling something and followed by a
+//branch (LDA / CMP / BNE, BIT $2002 / BPL), so those are tried first.
+#define OPENDTEST  \
+{  \
+ if(_count<=0 || _IRQlow)  \
+  goto loop;  \
+ FETCHOP();  \
+ if(b1==0xD0) goto op_0xD0;  \
+ if(b1==0xF0) goto op_0xF0;  \
+ if(b1==0x10) goto op_0x10;  \
+ if(b1==0x30) goto op_0x30;  \
+ if(b1==0xC9) goto op_0xC9;  \
+ goto *optable[b1];  \
+}
+
+#define RdRAM RdRAMDirect
+#undef LD_IM
+#undef LD_ZP
+#undef LD_AB
+#undef LD_ABI
+#define LD_IM(op)  {uint8 x; x=RdMem(_PC); _PC++; op; OPENDTEST;}
+#define LD_ZP(op)  {uint8 A; uint8 x; GetZP(A); x=RdRAM(A); op; OPENDTEST;}
+#define LD_AB(op)  {unsigned int A; uint8 x; GetAB(A); x=RdMemDirect(A); op; OPENDTEST; }
+#define LD_ABI(reg,op)  {unsigned int A; uint8 x; GetABIRD(A,reg); x=RdMemDirect(A); op; OPEND;}
+
+#define OPROW(h) \
+ &&op_0x##h##0, &&op_0x##h##1, &&op_0x##h##2, &&op_0x##h##3, \
+ &&op_0x##h##4, &&op_0x##h##5, &&op_0x##h##6, &&op_0x##h##7, \
+ &&op_0x##h##8, &&op_0x##h##9, &&op_0x##h##A, &&op_0x##h##B, \
+ &&op_0x##h##C, &&op_0x##h##D, &&op_0x##h##E, &&op_0x##h##F
+
+void X6502_RunThreaded(int32 cycles)
+{
+  static const void *const optable[256]=
+  {
+   OPROW(0), OPROW(1), OPROW(2), OPROW(3), OPROW(4), OPROW(5), OPROW(6), OPROW(7),
+   OPROW(8), OPROW(9), OPROW(A), OPROW(B), OPROW(C), OPROW(D), OPROW(E), OPROW(F)
+  };
+  int32 temp;
+  uint8 b1;
+
+  if(PAL)
+   cycles*=15;    // 15*4=60
+  else
+   cycles*=16;    // 16*4=64
+
+  _count+=cycles;
+
+ loop:
+  if(_count<=0)
+   return;
+  if(_IRQlow && !Interrupts())
+   return;
+
+  FETCHOP();
+  goto *optable[b1];
+
+  #include "ops.inc"
+}
+#endif
+
 //--------------------------
 //---Called from debuggers
 void FCEUI_NMI(void)
@@ -46,7 +46,18 @@ void X6502_Debug(void (*CPUHook)(X6502 *),
 //void X6502_Run(int32 cycles);
 //#endif
 void X6502_RunDebug(int32 cycles);
+#ifdef FCEU_THREADED_CPU
+//The same core built as threaded code (GCC and Clang only).  Clear
+//X6502_threaded to go back to the switch, e.g. to compare the two.
+extern bool X6502_threaded;
+void X6502_RunThreaded(int32 cycles);
+//Called by both cores before every instruction while set, with idle loop
+//skipping off, so FCEUI_BenchmarkCompareCores can compare them step by step.
+extern void (*X6502_stepHook)(void);
+#define X6502_Run(x) (X6502_threaded ? X6502_RunThreaded(x) : X6502_RunDebug(x))
+#else
 #define X6502_Run(x) X6502_RunDebug(x)
+#endif
 //------------
 
 extern uint32 timestamp;
@@ -64,6 +75,34 @@ extern int scanline;
 
 extern void (*MapIRQHook)(int a);
 
+//Hardware that counts CPU cycles runs as events.  Each event is handed all
+//the cycles since it last ran and says how many may pass before it has to
+//run again; the CPU core only compares timestamp against the earliest one.
+//An event that doesn't schedule itself runs before the next instruction.
+//Register handlers that read or change a counter call X6502_EventSync()
+//first and schedule again afterwards.  Events due together run in the order
+//below, and the APU ones lose the cycles spent overclocking.  Delays are
+//capped so 16 bit counters don't overflow.
+enum
+{
+	X6502_EV_MAPIRQ = 0,	//MapIRQHook
+	X6502_EV_FRAMECOUNT,	//APU frame counter
+	X6502_EV_DMC,			//DMC output timer and DMA
+	X6502_EV_COUNT
+};
+#define X6502_EVENT_MAXDELAY 8192
+void X6502_EventSchedule(int ev, int32 cycles);
+void X6502_EventSync(int ev);
+void X6502_SyncEvents(void);
+
+//MapIRQHook runs before every instruction unless the board schedules it.
+#define X6502_MAPIRQ_MAXDELAY X6502_EVENT_MAXDELAY
+void X6502_MapIRQSchedule(int32 cycles);
+void X6502_MapIRQSync(void);
+//Cycles from the last sync to a point the PPU is dots past, for events
+//timed by the PPU.  Points the CPU has already run past come out as now.
+int32 X6502_DotCycles(int32 dots);
+
 #define NTSC_CPU (dendy ? 1773447.467 : 1789772.7272727272727272)
 #define PAL_CPU  1662607.125
 
@@ -90,6 +129,12 @@ void X6502_DMW(uint32 A, uint8 V);
 void X6502_IRQBegin(int w);
 void X6502_IRQEnd(int w);
 
+//Keep events in step across the end of a frame, where timestamp goes back
+//to 0, and across savestates.
+void X6502_Rebase(void);
+void X6502_SaveState(void);
+void X6502_LoadState(void);
+
 int X6502_GetOpcodeCycles( int op );
 
 #define _X6502H